@@ -540,11 +540,27 @@ ASPath ASPathCopy(ASPath path)
     }
 }
 
+ASPath ASPathCreateFromNodes(size_t nodeSize, const void *nodes, size_t count, float cost)
+{
+    ASPath path;
+    CMALLOC(path, sizeof(struct __ASPath) + (count * nodeSize));
+    path->nodeSize = nodeSize;
+    path->count = count;
+    path->cost = cost;
+    memcpy(path->nodeKeys, nodes, count * nodeSize);
+    return path;
+}
+
 size_t ASPathGetCount(ASPath path)
 {
     return path? path->count : 0;
 }
 
+float ASPathGetCost(ASPath path)
+{
+    return path? path->cost : INFINITY;
+}
+
 void *ASPathGetNode(ASPath path, size_t idx)
 {
     return (path && idx < path->count)? (path->nodeKeys + (idx * path->nodeSize)) : NULL;
@@ -60,9 +60,16 @@ void ASPathDestroy(ASPath path);
 // you must call ASPathDestroy() with the resulting path to clean it up or it will cause a leak
 ASPath ASPathCopy(ASPath path);
 
+// creates a path from the given nodes, e.g. to join paths together
+// the nodes are copied into the path, which must be destroyed with ASPathDestroy()
+ASPath ASPathCreateFromNodes(size_t nodeSize, const void *nodes, size_t count, float cost);
+
 // fetches the number of nodes in the path
 size_t ASPathGetCount(ASPath path);
 
+// returns the total cost of the path or INFINITY if the path is NULL
+float ASPathGetCost(ASPath path);
+
 // returns a pointer to the given node in the path
 void *ASPathGetNode(ASPath path, size_t index);
 
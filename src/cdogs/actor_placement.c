@@ -200,7 +200,7 @@ Vec2i PlacePlayer(
 
 	GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 	e.u.ActorAdd = aa;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 
 	if (pumpEvents)
 	{
@@ -74,8 +74,17 @@
 #include "hiscores.h"
 #include "mission.h"
 #include "game.h"
+#include "net_assets.h"
+#include "uid_map.h"
 #include "utils.h"
 
+static ConfigHandle sConfigFootsteps = CONFIG_HANDLE("Sound.Footsteps");
+static ConfigHandle sConfigAIChatter = CONFIG_HANDLE("Interface.AIChatter");
+static ConfigHandle sConfigAmmo = CONFIG_HANDLE("Game.Ammo");
+static ConfigHandle sConfigSwitchMoveStyle = CONFIG_HANDLE("Game.SwitchMoveStyle");
+static ConfigHandle sConfigFireMoveStyle = CONFIG_HANDLE("Game.FireMoveStyle");
+static ConfigHandle sConfigFriendlyFire = CONFIG_HANDLE("Game.FriendlyFire");
+
 #define FOOTSTEP_DISTANCE_PLUS 380
 #define REPEL_STRENGTH 14
 #define SLIDE_LOCK 50
@@ -101,6 +110,8 @@ TranslationTable tablePurple;
 
 CArray gActors;
 static unsigned int sActorUIDs = 0;
+// UID to index in gActors
+static UIDMap sActorUIDMap;
 
 static Animation animIdling =
 {
@@ -389,7 +400,7 @@ void UpdateActorState(TActor * actor, int ticks)
 	// Footstep sounds
 	// Step on 1
 	// TODO: custom animation and footstep frames
-	if (ConfigGetBool(&gConfig, "Sound.Footsteps") &&
+	if (ConfigHandleGetBool(&sConfigFootsteps) &&
 		AnimationGetFrame(&actor->anim) == STATE_WALKING_1 &&
 		actor->anim.newFrame)
 	{
@@ -454,7 +465,8 @@ bool TryMoveActor(TActor *actor, Vec2i pos)
 					// Tell the server that we want to melee something
 					GameEvent e = GameEventNew(GAME_EVENT_ACTOR_MELEE);
 					e.u.Melee.UID = actor->uid;
-					strcpy(e.u.Melee.BulletClass, gun->Gun->Bullet->Name);
+					e.u.Melee.BulletClassId =
+						NetAssetsBulletId(gun->Gun->Bullet);
 					e.u.Melee.TargetKind = target->kind;
 					switch (target->kind)
 					{
@@ -480,7 +492,7 @@ bool TryMoveActor(TActor *actor, Vec2i pos)
 					{
 						e.u.Melee.HitType = (int)HIT_NONE;
 					}
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 				}
 				return false;
 			}
@@ -663,7 +675,7 @@ static void CheckTrigger(const Vec2i tilePos)
 			GameEvent e = GameEventNew(GAME_EVENT_TRIGGER);
 			e.u.TriggerEvent.ID = (*tp)->id;
 			e.u.TriggerEvent.Tile = Vec2i2Net(tilePos);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
@@ -712,7 +724,7 @@ static void CheckRescue(const TActor *a)
 			other->flags &= ~FLAGS_PRISONER;
 			GameEvent e = GameEventNew(GAME_EVENT_RESCUE_CHARACTER);
 			e.u.Rescue.UID = other->uid;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			UpdateMissionObjective(
 				&gMission, other->tileItem.flags, OBJECTIVE_RESCUE);
 		}
@@ -772,7 +784,7 @@ void ActorReplaceGun(const NActorReplaceGun rg)
 {
 	TActor *a = ActorGetByUID(rg.UID);
 	if (!a->isInUse) return;
-	const GunDescription *gun = StrGunDescription(rg.Gun);
+	const GunDescription *gun = NetAssetsGetGun(rg.GunId);
 	CASSERT(gun != NULL, "cannot find gun");
 	// If player already has gun, don't do anything
 	if (ActorHasGun(a, gun))
@@ -812,7 +824,7 @@ void ActorSetAIState(TActor *actor, const AIState s)
 {
 	if (AIContextSetState(actor->aiContext, s) &&
 		AIContextShowChatter(
-		actor->aiContext, ConfigGetEnum(&gConfig, "Interface.AIChatter")))
+		actor->aiContext, ConfigHandleGetEnum(&sConfigAIChatter)))
 	{
 		// Say something for a while
 		strcpy(actor->Chatter, AIStateGetChatterText(actor->aiContext->State));
@@ -825,7 +837,7 @@ void Shoot(TActor *actor)
 	Weapon *gun = ActorGetGun(actor);
 	if (!ActorCanFire(actor))
 	{
-		if (!WeaponIsLocked(gun) && ConfigGetBool(&gConfig, "Game.Ammo"))
+		if (!WeaponIsLocked(gun) && ConfigHandleGetBool(&sConfigAmmo))
 		{
 			CASSERT(ActorGunGetAmmo(actor, gun) == 0, "should be out of ammo");
 			// Play a clicking sound if this gun is out of ammo
@@ -848,14 +860,14 @@ void Shoot(TActor *actor)
 		actor->uid);
 	if (actor->PlayerUID >= 0)
 	{
-		if (ConfigGetBool(&gConfig, "Game.Ammo") && gun->Gun->AmmoId >= 0)
+		if (ConfigHandleGetBool(&sConfigAmmo) && gun->Gun->AmmoId >= 0)
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_USE_AMMO);
 			e.u.UseAmmo.UID = actor->uid;
 			e.u.UseAmmo.PlayerUID = actor->PlayerUID;
 			e.u.UseAmmo.AmmoId = gun->Gun->AmmoId;
 			e.u.UseAmmo.Amount = 1;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		else if (gun->Gun->Cost != 0)
 		{
@@ -863,7 +875,7 @@ void Shoot(TActor *actor)
 			GameEvent e = GameEventNew(GAME_EVENT_SCORE);
 			e.u.Score.PlayerUID = actor->PlayerUID;
 			e.u.Score.Score = -gun->Gun->Cost;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
@@ -874,15 +886,15 @@ static bool ActorTryChangeDirection(
 	const bool willChangeDirecton =
 		!actor->petrified &&
 		CMD_HAS_DIRECTION(cmd) &&
-		(!(cmd & CMD_BUTTON2) || ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle") != SWITCHMOVE_STRAFE) &&
-		(!(prevCmd & CMD_BUTTON1) || ConfigGetEnum(&gConfig, "Game.FireMoveStyle") != FIREMOVE_STRAFE);
+		(!(cmd & CMD_BUTTON2) || ConfigHandleGetEnum(&sConfigSwitchMoveStyle) != SWITCHMOVE_STRAFE) &&
+		(!(prevCmd & CMD_BUTTON1) || ConfigHandleGetEnum(&sConfigFireMoveStyle) != FIREMOVE_STRAFE);
 	const direction_e dir = CmdToDirection(cmd);
 	if (willChangeDirecton && dir != actor->direction)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_DIR);
 		e.u.ActorDir.UID = actor->uid;
 		e.u.ActorDir.Dir = (int32_t)dir;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		// Change direction immediately because this affects shooting
 		actor->direction = dir;
 	}
@@ -901,7 +913,7 @@ int ActorTryShoot(TActor *actor, int cmd)
 		GameEvent e = GameEventNew(GAME_EVENT_GUN_STATE);
 		e.u.GunState.ActorUID = actor->uid;
 		e.u.GunState.State = GUNSTATE_READY;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	return willShoot;
 }
@@ -928,7 +940,7 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_STATE);
 				e.u.ActorState.UID = actor->uid;
 				e.u.ActorState.State = (int32_t)ACTORANIMATION_IDLE;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 		}
 	}
@@ -948,7 +960,7 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_PICKUP_ALL);
 				e.u.ActorPickupAll.UID = actor->uid;
 				e.u.ActorPickupAll.PickupAll = true;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			actor->PickupAll = true;
 		}
@@ -961,7 +973,7 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_PICKUP_ALL);
 			e.u.ActorPickupAll.UID = actor->uid;
 			e.u.ActorPickupAll.PickupAll = false;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		actor->PickupAll = false;
 	}
@@ -969,9 +981,9 @@ void CommandActor(TActor * actor, int cmd, int ticks)
 static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 {
 	const bool canMoveWhenShooting =
-		ConfigGetEnum(&gConfig, "Game.FireMoveStyle") != FIREMOVE_STOP ||
+		ConfigHandleGetEnum(&sConfigFireMoveStyle) != FIREMOVE_STOP ||
 		!hasShot ||
-		(ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle") == SWITCHMOVE_STRAFE &&
+		(ConfigHandleGetEnum(&sConfigSwitchMoveStyle) == SWITCHMOVE_STRAFE &&
 		(cmd & CMD_BUTTON2));
 	const bool willMove =
 		!actor->petrified && CMD_HAS_DIRECTION(cmd) && canMoveWhenShooting;
@@ -1001,7 +1013,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_STATE);
 			e.u.ActorState.UID = actor->uid;
 			e.u.ActorState.State = (int32_t)ACTORANIMATION_WALKING;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 	else
@@ -1011,7 +1023,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_STATE);
 			e.u.ActorState.UID = actor->uid;
 			e.u.ActorState.State = (int32_t)ACTORANIMATION_IDLE;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 
@@ -1022,7 +1034,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 		e.u.ActorMove.UID = actor->uid;
 		e.u.ActorMove.Pos = Vec2i2Net(actor->Pos);
 		e.u.ActorMove.MoveVel = Vec2i2Net(actor->MoveVel);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 
 	return willMove;
@@ -1052,7 +1064,7 @@ void SlideActor(TActor *actor, int cmd)
 	if (cmd & CMD_UP)			vel.y = -SLIDE_Y * 256;
 	else if (cmd & CMD_DOWN)	vel.y = SLIDE_Y * 256;
 	e.u.ActorSlide.Vel = Vec2i2Net(vel);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 	
 	actor->slideLock = SLIDE_LOCK;
 }
@@ -1105,11 +1117,11 @@ void UpdateAllActors(int ticks)
 					e.u.ActorImpulse.UID = actor->uid;
 					e.u.ActorImpulse.Vel = Vec2i2Net(v);
 					e.u.ActorImpulse.Pos = Vec2i2Net(actor->Pos);
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 					e.u.ActorImpulse.UID = collidingActor->uid;
 					e.u.ActorImpulse.Vel = Vec2i2Net(Vec2iScale(v, -1));
 					e.u.ActorImpulse.Pos = Vec2i2Net(collidingActor->Pos);
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 				}
 			}
 		}
@@ -1195,7 +1207,7 @@ static void ActorAddGunPickup(const TActor *actor);
 static void ActorDie(TActor *actor)
 {
 	// Add an ammo pickup of the actor's gun
-	if (ConfigGetBool(&gConfig, "Game.Ammo"))
+	if (ConfigHandleGetBool(&sConfigAmmo))
 	{
 		ActorAddAmmoPickup(actor);
 	}
@@ -1209,17 +1221,16 @@ static void ActorDie(TActor *actor)
 	// Add a blood pool
 	GameEvent e = GameEventNew(GAME_EVENT_MAP_OBJECT_ADD);
 	e.u.MapObjectAdd.UID = ObjsGetNextUID();
-	strcpy(
-		e.u.MapObjectAdd.MapObjectClass,
-		RandomBloodMapObject(&gMapObjects)->Name);
+	e.u.MapObjectAdd.MapObjectId =
+		NetAssetsMapObjectId(RandomBloodMapObject(&gMapObjects));
 	e.u.MapObjectAdd.Pos = Vec2i2Net(Vec2iFull2Real(actor->Pos));
 	e.u.MapObjectAdd.TileItemFlags = TILEITEM_IS_WRECK;
 	e.u.MapObjectAdd.Health = 0;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 
 	e = GameEventNew(GAME_EVENT_ACTOR_DIE);
 	e.u.ActorDie.UID = actor->uid;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 static bool IsUnarmedBot(const TActor *actor);
 static void ActorAddAmmoPickup(const TActor *actor)
@@ -1260,7 +1271,7 @@ static void ActorAddAmmoPickup(const TActor *actor)
 				RAND_INT(-TILE_WIDTH, TILE_WIDTH) / 2,
 				RAND_INT(-TILE_HEIGHT, TILE_HEIGHT) / 2);
 			e.u.AddPickup.Pos = Vec2i2Net(Vec2iAdd(Vec2iFull2Real(actor->Pos), offset));
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 
@@ -1284,7 +1295,7 @@ static void ActorAddGunPickup(const TActor *actor)
 		e.u.AddPickup.SpawnerUID = -1;
 		e.u.AddPickup.TileItemFlags = 0;
 		e.u.AddPickup.Pos = Vec2i2Net(Vec2iFull2Real(actor->Pos));
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 static bool IsUnarmedBot(const TActor *actor)
@@ -1300,6 +1311,7 @@ void ActorsInit(void)
 	CArrayInit(&gActors, sizeof(TActor));
 	CArrayReserve(&gActors, 64);
 	sActorUIDs = 0;
+	UIDMapInit(&sActorUIDMap);
 }
 void ActorsTerminate(void)
 {
@@ -1310,6 +1322,7 @@ void ActorsTerminate(void)
 		ActorDestroy(a);
 	}
 	CArrayTerminate(&gActors);
+	UIDMapTerminate(&sActorUIDMap);
 }
 int ActorsGetNextUID(void)
 {
@@ -1346,8 +1359,11 @@ TActor *ActorAdd(NActorAdd aa)
 		CArrayPushBack(&gActors, &a);
 	}
 	TActor *actor = CArrayGet(&gActors, id);
+	// The slot may be reused; replace its old UID
+	UIDMapRemove(&sActorUIDMap, actor->uid, id);
 	memset(actor, 0, sizeof *actor);
 	actor->uid = aa.UID;
+	UIDMapSet(&sActorUIDMap, actor->uid, id);
 	LOG(LM_ACTOR, LL_DEBUG,
 		"add actor uid(%d) playerUID(%d)", actor->uid, aa.PlayerUID);
 	CArrayInit(&actor->guns, sizeof(Weapon));
@@ -1510,15 +1526,8 @@ void BuildTranslationTables(const TPalette palette)
 
 TActor *ActorGetByUID(const int uid)
 {
-	for (int i = 0; i < (int)gActors.size; i++)
-	{
-		TActor *a = CArrayGet(&gActors, i);
-		if (a->uid == uid)
-		{
-			return a;
-		}
-	}
-	return NULL;
+	const int i = UIDMapGet(&sActorUIDMap, uid);
+	return i >= 0 ? CArrayGet(&gActors, i) : NULL;
 }
 
 const Character *ActorGetCharacter(const TActor *a)
@@ -1548,7 +1557,7 @@ bool ActorCanFire(const TActor *a)
 	const bool hasAmmo = ActorGunGetAmmo(a, w) != 0;
 	return
 		!WeaponIsLocked(w) &&
-		(!ConfigGetBool(&gConfig, "Game.Ammo") || hasAmmo);
+		(!ConfigHandleGetBool(&sConfigAmmo) || hasAmmo);
 }
 bool ActorCanSwitchGun(const TActor *a)
 {
@@ -1665,7 +1674,7 @@ bool ActorIsInvulnerable(
 			actor->PlayerUID >= 0 || (actor->flags & FLAGS_GOOD_GUY);
 		// Friendly fire (NPCs)
 		if (!IsPVP(mode) &&
-			!ConfigGetBool(&gConfig, "Game.FriendlyFire") &&
+			!ConfigHandleGetBool(&sConfigFriendlyFire) &&
 			isGood && isTargetGood)
 		{
 			return 1;
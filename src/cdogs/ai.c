@@ -66,6 +66,9 @@
 #include "sys_specifics.h"
 #include "utils.h"
 
+static ConfigHandle sConfigDifficulty = CONFIG_HANDLE("Game.Difficulty");
+static ConfigHandle sConfigEnemyDensity = CONFIG_HANDLE("Game.EnemyDensity");
+
 static int gBaddieCount = 0;
 static int gAreGoodGuysPresent = 0;
 
@@ -299,7 +302,7 @@ void CommandBadGuys(int ticks)
 	int delayModifier;
 	int rollLimit;
 
-	switch (ConfigGetEnum(&gConfig, "Game.Difficulty"))
+	switch (ConfigHandleGetEnum(&sConfigDifficulty))
 	{
 	case DIFFICULTY_VERYEASY:
 		delayModifier = 4;
@@ -388,8 +391,9 @@ void CommandBadGuys(int ticks)
 					}
 					else
 					{
-						cmd = AIGoto(
-							actor, AIGetClosestPlayerPos(actor->Pos), true);
+						const TActor *player =
+							AIGetClosestPlayer(actor->Pos);
+						cmd = player != NULL ? AIGotoActor(actor, player) : 0;
 						ActorSetAIState(actor, AI_STATE_FOLLOW);
 					}
 				}
@@ -488,7 +492,7 @@ void CommandBadGuys(int ticks)
 	}
 	if (gMission.missionData->Enemies.size > 0 &&
 		gMission.missionData->EnemyDensity > 0 &&
-		count < MAX(1, (gMission.missionData->EnemyDensity * ConfigGetInt(&gConfig, "Game.EnemyDensity")) / 100))
+		count < MAX(1, (gMission.missionData->EnemyDensity * ConfigHandleGetInt(&sConfigEnemyDensity)) / 100))
 	{
 		NActorAdd aa = NActorAdd_init_default;
 		aa.UID = ActorsGetNextUID();
@@ -501,7 +505,7 @@ void CommandBadGuys(int ticks)
 		aa.FullPos = PlaceAwayFromPlayers(&gMap);
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 		e.u.ActorAdd = aa;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		gBaddieCount++;
 	}
 }
@@ -530,7 +534,7 @@ void InitializeBadGuys(void)
 				aa.FullPos = PlaceAwayFromPlayers(&gMap);
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 				e.u.ActorAdd = aa;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 
 				// Process the events that actually place the actors
 				HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -559,7 +563,7 @@ void InitializeBadGuys(void)
 				}
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 				e.u.ActorAdd = aa;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 
 				// Process the events that actually place the actors
 				HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -579,7 +583,7 @@ void CreateEnemies(void)
 	}
 
 	for (int i = 0;
-		i < MAX(1, (gMission.missionData->EnemyDensity * ConfigGetInt(&gConfig, "Game.EnemyDensity")) / 100);
+		i < MAX(1, (gMission.missionData->EnemyDensity * ConfigHandleGetInt(&sConfigEnemyDensity)) / 100);
 		i++)
 	{
 		NActorAdd aa = NActorAdd_init_default;
@@ -593,7 +597,7 @@ void CreateEnemies(void)
 		aa.Health = CharacterGetStartingHealth(c, true);
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 		e.u.ActorAdd = aa;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		gBaddieCount++;
 
 		// Process the events that actually place the actors
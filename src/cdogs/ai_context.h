@@ -87,6 +87,9 @@ typedef struct
 	CachedPath Path;
 	int PathIndex;
 	bool IsFollowing;
+	// Next tile when following a flow field
+	Vec2i FlowStep;
+	bool IsFlowing;
 } AIGotoContext;
 typedef struct
 {
@@ -32,6 +32,8 @@
 #include "gamedata.h"
 #include "pickup.h"
 
+static ConfigHandle sConfigAmmo = CONFIG_HANDLE("Game.Ammo");
+
 // How many ticks to stay in one confusion state
 #define CONFUSION_STATE_TICKS_MIN 25
 #define CONFUSION_STATE_TICKS_RANGE 25
@@ -164,7 +166,7 @@ static int AICoopGetCmdNormal(TActor *actor)
 
 	// Check the weapon for ammo
 	int lowAmmoGun = -1;
-	if (ConfigGetBool(&gConfig, "Game.Ammo"))
+	if (ConfigHandleGetBool(&sConfigAmmo))
 	{
 		// Check all our weapons
 		// Prefer guns using ammo
@@ -741,7 +743,7 @@ static bool OnClosestPickupGun(
 	ClosestObjective *co, const Pickup *p,
 	const TActor *actor, const TActor *closestPlayer)
 {
-	if (!ConfigGetBool(&gConfig, "Game.Ammo"))
+	if (!ConfigHandleGetBool(&sConfigAmmo))
 	{
 		return false;
 	}
@@ -884,7 +886,7 @@ void AICoopSelectWeapons(
 		p->weaponCount++;
 	}
 
-	if (ConfigGetBool(&gConfig, "Game.Ammo"))
+	if (ConfigHandleGetBool(&sConfigAmmo))
 	{
 		// Select pistol as an infinite-ammo backup
 		const GunDescription *pistol = StrGunDescription("Pistol");
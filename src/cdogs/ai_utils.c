@@ -52,6 +52,7 @@
 
 #include "algorithms.h"
 #include "collision.h"
+#include "flow_field.h"
 #include "gamedata.h"
 #include "map.h"
 #include "objs.h"
@@ -450,7 +451,7 @@ bool AIHasPath(const Vec2i from, const Vec2i to, const bool ignoreObjects)
 		ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects);
 	CachedPath path = PathCacheCreate(
 		&gPathCache, fromTile, toTile, ignoreObjects, true);
-	const size_t pathCount = ASPathGetCount(path.Path);
+	const size_t pathCount = CachedPathGetCount(&path);
 	CachedPathDestroy(&path);
 	return pathCount >= 1;
 }
@@ -472,7 +473,7 @@ int AIGotoDirect(const Vec2i a, const Vec2i p)
 static int AStarFollow(
 	AIGotoContext *c, Vec2i currentTile, TTileItem *i, Vec2i a)
 {
-	Vec2i *pathTile = ASPathGetNode(c->Path.Path, c->PathIndex);
+	Vec2i *pathTile = CachedPathGetNode(&c->Path, c->PathIndex);
 	c->IsFollowing = 1;
 	// Check if we need to follow the next step in the path
 	// Note: need to make sure the actor is fully within the current tile
@@ -481,7 +482,7 @@ static int AStarFollow(
 		IsTileItemInsideTile(i, currentTile))
 	{
 		c->PathIndex++;
-		pathTile = ASPathGetNode(c->Path.Path, c->PathIndex);
+		pathTile = CachedPathGetNode(&c->Path, c->PathIndex);
 	}
 	// Go directly to the center of the next tile
 	return AIGotoDirect(a, Vec2iCenterOfTile(*pathTile));
@@ -494,19 +495,19 @@ static int AStarCloseToPath(
 	Vec2i *pathTile;
 	Vec2i *pathEnd;
 	if (!c ||
-		c->PathIndex >= (int)ASPathGetCount(c->Path.Path) - 1) // at end of path
+		c->PathIndex >= (int)CachedPathGetCount(&c->Path) - 1) // at end of path
 	{
 		return 0;
 	}
 	// Check if we're too far from the current start of the path
-	pathTile = ASPathGetNode(c->Path.Path, c->PathIndex);
+	pathTile = CachedPathGetNode(&c->Path, c->PathIndex);
 	if (CHEBYSHEV_DISTANCE(
 		currentTile.x, currentTile.y, pathTile->x, pathTile->y) > 2)
 	{
 		return 0;
 	}
 	// Check if we're too far from the end of the path
-	pathEnd = ASPathGetNode(c->Path.Path, ASPathGetCount(c->Path.Path) - 1);
+	pathEnd = CachedPathGetNode(&c->Path, CachedPathGetCount(&c->Path) - 1);
 	if (CHEBYSHEV_DISTANCE(
 		goalTile.x, goalTile.y, pathEnd->x, pathEnd->y) > 0)
 	{
@@ -561,7 +562,7 @@ int AIGoto(TActor *actor, Vec2i p, bool ignoreObjects)
 
 		// In case we can't calculate A* for some reason,
 		// try simple navigation again
-		if (ASPathGetCount(c->Path.Path) <= 1)
+		if (CachedPathGetCount(&c->Path) <= 1)
 		{
 			debug(
 				D_MAX,
@@ -575,6 +576,46 @@ int AIGoto(TActor *actor, Vec2i p, bool ignoreObjects)
 	}
 }
 
+// Follow the flow field to the target, shared with other AI going there
+static int FlowFollow(TActor *actor, const TActor *target)
+{
+	const Vec2i a = Vec2iFull2Real(actor->Pos);
+	const Vec2i currentTile = Vec2iToTile(a);
+	AIGotoContext *c = &actor->aiContext->Goto;
+	// Keep going to the next tile until we are fully inside it,
+	// otherwise we may get stuck at corners
+	if (c->IsFlowing &&
+		CHEBYSHEV_DISTANCE(
+			currentTile.x, currentTile.y, c->FlowStep.x, c->FlowStep.y) <= 1 &&
+		!(Vec2iEqual(currentTile, c->FlowStep) &&
+		IsTileItemInsideTile(&actor->tileItem, currentTile)))
+	{
+		return AIGotoDirect(a, Vec2iCenterOfTile(c->FlowStep));
+	}
+	const Vec2i p = Vec2iFull2Real(target->Pos);
+	const Vec2i goal =
+		MapSearchTileAround(&gMap, Vec2iToTile(p), IsTileWalkable);
+	const FlowField *f = FlowFieldsGet(&gFlowFields, target->uid, goal);
+	c->IsFlowing = FlowFieldNext(f, &gMap, currentTile, &c->FlowStep);
+	if (!c->IsFlowing)
+	{
+		return AIGotoDirect(a, p);
+	}
+	return AIGotoDirect(a, Vec2iCenterOfTile(c->FlowStep));
+}
+int AIGotoActor(TActor *actor, const TActor *target)
+{
+	const Vec2i a = Vec2iFull2Real(actor->Pos);
+	const Vec2i p = Vec2iFull2Real(target->Pos);
+	if (Vec2iEqual(Vec2iToTile(a), Vec2iToTile(p)) ||
+		AIHasClearPath(a, p, true))
+	{
+		actor->aiContext->Goto.IsFlowing = false;
+		return AIGotoDirect(a, p);
+	}
+	return FlowFollow(actor, target);
+}
+
 // Hunt moves an Actor towards a target, using the most efficient direction.
 // That is, given the following octant:
 //            x  A      xxxx
@@ -614,9 +655,11 @@ int AIHunt(TActor *actor, Vec2i targetPos)
 int AIHuntClosest(TActor *actor)
 {
 	Vec2i targetPos = actor->Pos;
+	const TActor *player = NULL;
 	if (!(actor->PlayerUID >= 0 || (actor->flags & FLAGS_GOOD_GUY)))
 	{
 		targetPos = AIGetClosestPlayerPos(actor->Pos);
+		player = AIGetClosestPlayer(actor->Pos);
 	}
 
 	if (actor->flags & FLAGS_VISIBLE)
@@ -626,8 +669,20 @@ int AIHuntClosest(TActor *actor)
 		if (a)
 		{
 			targetPos = a->Pos;
+			player = a->PlayerUID >= 0 ? a : NULL;
 		}
 	}
+
+	// If there are walls in the way of the player, go around them using
+	// the flow field to the player
+	// Cowards don't mind, they just run away
+	if (player != NULL && !(actor->flags & FLAGS_RUNS_AWAY) &&
+		!AIHasClearPath(
+			Vec2iFull2Real(actor->Pos), Vec2iFull2Real(player->Pos), true))
+	{
+		return FlowFollow(actor, player);
+	}
+	actor->aiContext->Goto.IsFlowing = false;
 	return AIHunt(actor, targetPos);
 }
 
@@ -72,6 +72,8 @@ bool AIIsFacing(const TActor *a, const Vec2i targetFull, const direction_e d);
 //                - if false, will pathfind around them
 int AIGoto(TActor *actor, Vec2i target, bool ignoreObjects);
 int AIGotoDirect(const Vec2i a, const Vec2i p);
+// Go to another actor, using the flow field to them shared with other AI
+int AIGotoActor(TActor *actor, const TActor *target);
 int AIHunt(TActor *actor, Vec2i targetPos);
 int AIHuntClosest(TActor *actor);
 int AIRetreatFrom(TActor *actor, const Vec2i from);
@@ -79,5 +81,10 @@ int AIRetreatFrom(TActor *actor, const Vec2i from);
 int AITrack(TActor *actor, const Vec2i targetPos);
 
 // Pathfinding helper functions
+// Costs of steps between tiles, in tenths of pixels, as used by A*
+// Tiles are non-square, and diagonals are slightly less preferred
+#define PATH_COST_X (TILE_WIDTH * 10)
+#define PATH_COST_Y (TILE_HEIGHT * 10)
+#define PATH_COST_DIAGONAL (TILE_WIDTH * 11)
 bool IsTileWalkable(Map *map, const Vec2i pos);
 bool IsTileWalkableAroundObjects(Map *map, const Vec2i pos);
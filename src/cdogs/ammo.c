@@ -37,7 +37,6 @@
 AmmoClasses gAmmo;
 
 
-// TODO: use map structure?
 Ammo *StrAmmo(const char *s)
 {
 	return AmmoGetById(&gAmmo, StrAmmoId(s));
@@ -48,21 +47,15 @@ int StrAmmoId(const char *s)
 	{
 		return 0;
 	}
-	for (int i = 0; i < (int)gAmmo.CustomAmmo.size; i++)
+	int i = NameMapGet(&gAmmo.CustomAmmoByName, s);
+	if (i >= 0)
 	{
-		Ammo *a = CArrayGet(&gAmmo.CustomAmmo, i);
-		if (strcmp(s, a->Name) == 0)
-		{
-			return i + (int)gAmmo.Ammo.size;
-		}
+		return i + (int)gAmmo.Ammo.size;
 	}
-	for (int i = 0; i < (int)gAmmo.Ammo.size; i++)
+	i = NameMapGet(&gAmmo.AmmoByName, s);
+	if (i >= 0)
 	{
-		Ammo *a = CArrayGet(&gAmmo.Ammo, i);
-		if (strcmp(s, a->Name) == 0)
-		{
-			return i;
-		}
+		return i;
 	}
 	CASSERT(false, "cannot parse ammo name");
 	return 0;
@@ -75,6 +68,9 @@ void AmmoInitialize(AmmoClasses *ammo, const char *path)
 	memset(ammo, 0, sizeof *ammo);
 	CArrayInit(&ammo->Ammo, sizeof(Ammo));
 	CArrayInit(&ammo->CustomAmmo, sizeof(Ammo));
+	NAME_MAP_INIT(&ammo->AmmoByName, &ammo->Ammo, Ammo, Name, true);
+	NAME_MAP_INIT(
+		&ammo->CustomAmmoByName, &ammo->CustomAmmo, Ammo, Name, true);
 
 	json_t *root = NULL;
 	enum json_error e;
@@ -145,6 +141,8 @@ void AmmoTerminate(AmmoClasses *ammo)
 	CArrayTerminate(&ammo->Ammo);
 	AmmoClassesClear(&ammo->CustomAmmo);
 	CArrayTerminate(&ammo->CustomAmmo);
+	NameMapTerminate(&ammo->AmmoByName);
+	NameMapTerminate(&ammo->CustomAmmoByName);
 }
 
 Ammo *AmmoGetById(AmmoClasses *ammo, const int id)
@@ -30,6 +30,7 @@
 #include <json/json.h>
 
 #include "c_array.h"
+#include "name_map.h"
 #include "pic.h"
 
 typedef struct
@@ -44,6 +45,8 @@ typedef struct
 {
 	CArray Ammo;	// of Ammo
 	CArray CustomAmmo;	// of Ammo
+	NameMap AmmoByName;
+	NameMap CustomAmmoByName;
 } AmmoClasses;
 extern AmmoClasses gAmmo;
 
@@ -0,0 +1,503 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "astar_grid.h"
+
+#include <limits.h>
+#include <stdlib.h>
+
+#include "ai_utils.h"
+
+
+void AStarGridInit(AStarGrid *g, Map *m)
+{
+	memset(g, 0, sizeof *g);
+	g->map = m;
+	CArrayInit(&g->nodes, sizeof(AStarGridNode));
+	CArrayInit(&g->open, sizeof(int));
+}
+void AStarGridTerminate(AStarGrid *g)
+{
+	CArrayTerminate(&g->nodes);
+	CArrayTerminate(&g->open);
+}
+
+static AStarGridNode *GetNode(AStarGrid *g, const int idx)
+{
+	return &((AStarGridNode *)g->nodes.data)[idx];
+}
+static int TileIndex(const AStarGrid *g, const Vec2i v)
+{
+	return v.y * g->map->Size.x + v.x;
+}
+static Vec2i IndexTile(const AStarGrid *g, const int idx)
+{
+	return Vec2iNew(idx % g->map->Size.x, idx / g->map->Size.x);
+}
+
+// Walkability is checked at most once per tile per search
+static bool IsOk(AStarGrid *g, const Vec2i v)
+{
+	if (!MapIsTileIn(g->map, v))
+	{
+		return false;
+	}
+	AStarGridNode *n = GetNode(g, TileIndex(g, v));
+	if (n->walkableGeneration != g->generation)
+	{
+		n->walkableGeneration = g->generation;
+		n->isWalkable = g->isTileOk(g->map, v);
+	}
+	return n->isWalkable;
+}
+// if we're moving diagonally,
+// need to check the axis-aligned neighbours are also clear
+static bool IsStepOk(AStarGrid *g, const Vec2i from, const Vec2i to)
+{
+	return IsOk(g, to) &&
+		IsOk(g, Vec2iNew(from.x, to.y)) && IsOk(g, Vec2iNew(to.x, from.y));
+}
+
+// Cost of one step in a direction
+// Note that there are different horizontal and vertical costs,
+// due to the tiles being non-square
+static int StepCost(const Vec2i d)
+{
+	if (d.x != 0 && d.y != 0)
+	{
+		return PATH_COST_DIAGONAL;
+	}
+	return d.x != 0 ? PATH_COST_X : PATH_COST_Y;
+}
+// Cheapest cost with no obstacles, so it never overestimates
+static int Heuristic(const Vec2i a, const Vec2i b)
+{
+	const int dx = abs(a.x - b.x);
+	const int dy = abs(a.y - b.y);
+	if (dx > dy)
+	{
+		return dy * PATH_COST_DIAGONAL + (dx - dy) * PATH_COST_X;
+	}
+	return dx * PATH_COST_DIAGONAL + (dy - dx) * PATH_COST_Y;
+}
+
+// Reset the node if it was last used by a previous search
+static AStarGridNode *Touch(AStarGrid *g, const int idx)
+{
+	AStarGridNode *n = GetNode(g, idx);
+	if (n->generation != g->generation)
+	{
+		n->generation = g->generation;
+		n->isClosed = false;
+		n->heapIndex = -1;
+		n->g = INT_MAX;
+	}
+	return n;
+}
+
+
+// Open list: binary heap of tile indices, by lowest f then highest g,
+// with each node's heap index kept for decrease-key
+
+static int *HeapGet(AStarGrid *g, const int i)
+{
+	return &((int *)g->open.data)[i];
+}
+static bool HeapLess(AStarGrid *g, const int a, const int b)
+{
+	const AStarGridNode *na = GetNode(g, a);
+	const AStarGridNode *nb = GetNode(g, b);
+	return na->f < nb->f || (na->f == nb->f && na->g > nb->g);
+}
+static void HeapSet(AStarGrid *g, const int i, const int idx)
+{
+	*HeapGet(g, i) = idx;
+	GetNode(g, idx)->heapIndex = i;
+}
+static void HeapUp(AStarGrid *g, int i)
+{
+	const int idx = *HeapGet(g, i);
+	while (i > 0)
+	{
+		const int parent = (i - 1) / 2;
+		if (!HeapLess(g, idx, *HeapGet(g, parent)))
+		{
+			break;
+		}
+		HeapSet(g, i, *HeapGet(g, parent));
+		i = parent;
+	}
+	HeapSet(g, i, idx);
+}
+static void HeapDown(AStarGrid *g, int i)
+{
+	const int size = (int)g->open.size;
+	const int idx = *HeapGet(g, i);
+	for (;;)
+	{
+		int child = i * 2 + 1;
+		if (child >= size)
+		{
+			break;
+		}
+		if (child + 1 < size &&
+			HeapLess(g, *HeapGet(g, child + 1), *HeapGet(g, child)))
+		{
+			child++;
+		}
+		if (!HeapLess(g, *HeapGet(g, child), idx))
+		{
+			break;
+		}
+		HeapSet(g, i, *HeapGet(g, child));
+		i = child;
+	}
+	HeapSet(g, i, idx);
+}
+static void HeapPush(AStarGrid *g, const int idx)
+{
+	CArrayPushBack(&g->open, &idx);
+	HeapUp(g, (int)g->open.size - 1);
+}
+static int HeapPop(AStarGrid *g)
+{
+	const int top = *HeapGet(g, 0);
+	GetNode(g, top)->heapIndex = -1;
+	const int last = *HeapGet(g, (int)g->open.size - 1);
+	g->open.size--;
+	if (g->open.size > 0)
+	{
+		*HeapGet(g, 0) = last;
+		HeapDown(g, 0);
+	}
+	return top;
+}
+
+
+static void Relax(
+	AStarGrid *g, const int parent, const int idx, const int cost,
+	const Vec2i goal)
+{
+	AStarGridNode *n = Touch(g, idx);
+	// The heuristic is consistent, so closed nodes are final
+	if (n->isClosed || cost >= n->g)
+	{
+		return;
+	}
+	n->g = cost;
+	n->f = cost + Heuristic(IndexTile(g, idx), goal);
+	n->parent = parent;
+	if (n->heapIndex == -1)
+	{
+		HeapPush(g, idx);
+	}
+	else
+	{
+		HeapUp(g, n->heapIndex);
+	}
+}
+
+static void AddNeighbors(AStarGrid *g, const int idx, const Vec2i goal)
+{
+	const Vec2i v = IndexTile(g, idx);
+	const int cost = GetNode(g, idx)->g;
+	for (int dy = -1; dy <= 1; dy++)
+	{
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			const Vec2i d = Vec2iNew(dx, dy);
+			const Vec2i next = Vec2iAdd(v, d);
+			if ((dx == 0 && dy == 0) || !IsStepOk(g, v, next))
+			{
+				continue;
+			}
+			Relax(g, idx, TileIndex(g, next), cost + StepCost(d), goal);
+		}
+	}
+}
+
+
+// Jump point search, for grids where diagonal steps can't cut corners
+// Jump from a tile in a direction, until reaching a tile that has neighbours
+// that can't be reached more cheaply some other way
+// Returns the tile index of the jump point, or -1 if there is none
+static int Jump(AStarGrid *g, Vec2i v, const Vec2i d, const Vec2i goal)
+{
+	for (;;)
+	{
+		if (!IsOk(g, v))
+		{
+			return -1;
+		}
+		if (Vec2iEqual(v, goal))
+		{
+			return TileIndex(g, v);
+		}
+		if (d.x != 0 && d.y != 0)
+		{
+			if (Jump(g, Vec2iNew(v.x + d.x, v.y), Vec2iNew(d.x, 0), goal) != -1 ||
+				Jump(g, Vec2iNew(v.x, v.y + d.y), Vec2iNew(0, d.y), goal) != -1)
+			{
+				return TileIndex(g, v);
+			}
+		}
+		else if (d.x != 0)
+		{
+			if ((IsOk(g, Vec2iNew(v.x, v.y - 1)) &&
+				!IsOk(g, Vec2iNew(v.x - d.x, v.y - 1))) ||
+				(IsOk(g, Vec2iNew(v.x, v.y + 1)) &&
+				!IsOk(g, Vec2iNew(v.x - d.x, v.y + 1))))
+			{
+				return TileIndex(g, v);
+			}
+		}
+		else
+		{
+			if ((IsOk(g, Vec2iNew(v.x - 1, v.y)) &&
+				!IsOk(g, Vec2iNew(v.x - 1, v.y - d.y))) ||
+				(IsOk(g, Vec2iNew(v.x + 1, v.y)) &&
+				!IsOk(g, Vec2iNew(v.x + 1, v.y - d.y))))
+			{
+				return TileIndex(g, v);
+			}
+		}
+		if (!IsOk(g, Vec2iNew(v.x + d.x, v.y)) ||
+			!IsOk(g, Vec2iNew(v.x, v.y + d.y)))
+		{
+			return -1;
+		}
+		v = Vec2iAdd(v, d);
+	}
+}
+static void AddJump(
+	AStarGrid *g, const int idx, const Vec2i d, const Vec2i goal)
+{
+	const Vec2i v = IndexTile(g, idx);
+	const int jump = Jump(g, Vec2iAdd(v, d), d, goal);
+	if (jump == -1)
+	{
+		return;
+	}
+	const Vec2i to = IndexTile(g, jump);
+	const int steps = MAX(abs(to.x - v.x), abs(to.y - v.y));
+	Relax(g, idx, jump, GetNode(g, idx)->g + steps * StepCost(d), goal);
+}
+static int Sign(const int x)
+{
+	return (x > 0) - (x < 0);
+}
+static void AddJumpNeighbors(AStarGrid *g, const int idx, const Vec2i goal)
+{
+	const AStarGridNode *n = GetNode(g, idx);
+	// Pruning assumes the parent is walkable, which the start may not be
+	if (n->parent == -1 || !IsOk(g, IndexTile(g, n->parent)))
+	{
+		for (int dy = -1; dy <= 1; dy++)
+		{
+			for (int dx = -1; dx <= 1; dx++)
+			{
+				const Vec2i v = IndexTile(g, idx);
+				const Vec2i d = Vec2iNew(dx, dy);
+				if ((dx != 0 || dy != 0) && IsStepOk(g, v, Vec2iAdd(v, d)))
+				{
+					AddJump(g, idx, d, goal);
+				}
+			}
+		}
+		return;
+	}
+	// Prune neighbours that can be reached more cheaply from the parent
+	const Vec2i v = IndexTile(g, idx);
+	const Vec2i p = IndexTile(g, n->parent);
+	const Vec2i d = Vec2iNew(Sign(v.x - p.x), Sign(v.y - p.y));
+	if (d.x != 0 && d.y != 0)
+	{
+		const bool xOk = IsOk(g, Vec2iNew(v.x + d.x, v.y));
+		const bool yOk = IsOk(g, Vec2iNew(v.x, v.y + d.y));
+		if (yOk)
+		{
+			AddJump(g, idx, Vec2iNew(0, d.y), goal);
+		}
+		if (xOk)
+		{
+			AddJump(g, idx, Vec2iNew(d.x, 0), goal);
+		}
+		if (xOk && yOk)
+		{
+			AddJump(g, idx, d, goal);
+		}
+	}
+	else if (d.x != 0)
+	{
+		const bool ahead = IsOk(g, Vec2iNew(v.x + d.x, v.y));
+		const bool up = IsOk(g, Vec2iNew(v.x, v.y - 1));
+		const bool down = IsOk(g, Vec2iNew(v.x, v.y + 1));
+		if (ahead)
+		{
+			AddJump(g, idx, d, goal);
+			if (up)
+			{
+				AddJump(g, idx, Vec2iNew(d.x, -1), goal);
+			}
+			if (down)
+			{
+				AddJump(g, idx, Vec2iNew(d.x, 1), goal);
+			}
+		}
+		if (up)
+		{
+			AddJump(g, idx, Vec2iNew(0, -1), goal);
+		}
+		if (down)
+		{
+			AddJump(g, idx, Vec2iNew(0, 1), goal);
+		}
+	}
+	else
+	{
+		const bool ahead = IsOk(g, Vec2iNew(v.x, v.y + d.y));
+		const bool left = IsOk(g, Vec2iNew(v.x - 1, v.y));
+		const bool right = IsOk(g, Vec2iNew(v.x + 1, v.y));
+		if (ahead)
+		{
+			AddJump(g, idx, d, goal);
+			if (left)
+			{
+				AddJump(g, idx, Vec2iNew(-1, d.y), goal);
+			}
+			if (right)
+			{
+				AddJump(g, idx, Vec2iNew(1, d.y), goal);
+			}
+		}
+		if (left)
+		{
+			AddJump(g, idx, Vec2iNew(-1, 0), goal);
+		}
+		if (right)
+		{
+			AddJump(g, idx, Vec2iNew(1, 0), goal);
+		}
+	}
+}
+
+
+// Walk back from the goal, filling in the tiles between jump points
+static ASPath CreatePath(AStarGrid *g, const int goal)
+{
+	CArray nodes;
+	CArrayInit(&nodes, sizeof(Vec2i));
+	for (int idx = goal; idx != -1; idx = GetNode(g, idx)->parent)
+	{
+		const int parent = GetNode(g, idx)->parent;
+		Vec2i v = IndexTile(g, idx);
+		CArrayPushBack(&nodes, &v);
+		if (parent == -1)
+		{
+			break;
+		}
+		const Vec2i p = IndexTile(g, parent);
+		const Vec2i d = Vec2iNew(Sign(p.x - v.x), Sign(p.y - v.y));
+		for (v = Vec2iAdd(v, d); !Vec2iEqual(v, p); v = Vec2iAdd(v, d))
+		{
+			CArrayPushBack(&nodes, &v);
+		}
+	}
+	// Reverse so the path starts from the start
+	Vec2i *vs = nodes.data;
+	for (size_t i = 0; i < nodes.size / 2; i++)
+	{
+		const Vec2i tmp = vs[i];
+		vs[i] = vs[nodes.size - 1 - i];
+		vs[nodes.size - 1 - i] = tmp;
+	}
+	ASPath path = ASPathCreateFromNodes(
+		sizeof(Vec2i), nodes.data, nodes.size,
+		(float)GetNode(g, goal)->g / 10);
+	CArrayTerminate(&nodes);
+	return path;
+}
+
+ASPath AStarGridFindPath(
+	AStarGrid *g, const Vec2i from, const Vec2i to,
+	TileSelectFunc isTileOk, const bool jps)
+{
+	g->Expanded = 0;
+	if (!MapIsTileIn(g->map, from) || !MapIsTileIn(g->map, to))
+	{
+		return NULL;
+	}
+	const int size = g->map->Size.x * g->map->Size.y;
+	if ((int)g->nodes.size != size)
+	{
+		AStarGridNode n;
+		memset(&n, 0, sizeof n);
+		CArrayClear(&g->nodes);
+		CArrayResize(&g->nodes, size, &n);
+		g->generation = 0;
+	}
+	// Start a new search; once the generation wraps around, old nodes
+	// could look current, so clear them all
+	g->generation++;
+	if (g->generation == 0)
+	{
+		CA_FOREACH(AStarGridNode, n, g->nodes)
+			n->generation = 0;
+			n->walkableGeneration = 0;
+		CA_FOREACH_END()
+		g->generation = 1;
+	}
+	g->isTileOk = isTileOk;
+	CArrayClear(&g->open);
+
+	const int start = TileIndex(g, from);
+	const int goal = TileIndex(g, to);
+	AStarGridNode *n = Touch(g, start);
+	n->g = 0;
+	n->f = Heuristic(from, to);
+	n->parent = -1;
+	HeapPush(g, start);
+	while (g->open.size > 0)
+	{
+		const int idx = HeapPop(g);
+		if (idx == goal)
+		{
+			return CreatePath(g, goal);
+		}
+		GetNode(g, idx)->isClosed = true;
+		g->Expanded++;
+		if (jps)
+		{
+			AddJumpNeighbors(g, idx, to);
+		}
+		else
+		{
+			AddNeighbors(g, idx, to);
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,73 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL_stdinc.h>
+
+#include "AStar.h"
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+typedef struct
+{
+	int g;	// cost from the start
+	int f;	// estimated total cost, through this node
+	int parent;	// tile index, -1 for the start
+	int heapIndex;	// in the open list, -1 if not in it
+	Uint8 generation;	// search that last reached this node
+	bool isClosed;
+	Uint8 walkableGeneration;	// search that last checked walkability
+	bool isWalkable;
+} AStarGridNode;
+
+// A* specialised for the tile grid
+// Nodes are indexed by tile, and kept between searches; a generation
+// counter marks which are from the current search, so they never need
+// to be cleared
+// Note: lifetime managed by PathCache
+typedef struct
+{
+	Map *map;
+	TileSelectFunc isTileOk;
+	CArray nodes;	// of AStarGridNode, per tile
+	CArray open;	// of int, binary heap of tile indices
+	Uint8 generation;
+	int Expanded;	// nodes expanded by the last search
+} AStarGrid;
+
+void AStarGridInit(AStarGrid *g, Map *m);
+void AStarGridTerminate(AStarGrid *g);
+
+// Find the cheapest path between two tiles, with 8-way movement where
+// diagonal steps need both axis tiles to be clear
+// Optionally use jump point search, which expands fewer nodes on open maps
+// Returns NULL if there is no path
+ASPath AStarGridFindPath(
+	AStarGrid *g, const Vec2i from, const Vec2i to,
+	TileSelectFunc isTileOk, const bool jps);
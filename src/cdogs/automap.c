@@ -179,9 +179,9 @@ static void DisplaySummary(void)
 	}
 }
 
-color_t DoorColor(int x, int y)
+static color_t GetDoorColor(Map *map, const Vec2i pos)
 {
-	int l = MapGetDoorKeycardFlag(&gMap, Vec2iNew(x, y));
+	int l = MapGetDoorKeycardFlag(map, pos);
 
 	switch (l) {
 	case FLAGS_KEYCARD_YELLOW:
@@ -196,6 +196,10 @@ color_t DoorColor(int x, int y)
 		return colorDoor;
 	}
 }
+color_t DoorColor(int x, int y)
+{
+	return GetDoorColor(&gMap, Vec2iNew(x, y));
+}
 
 void DrawDot(TTileItem *t, color_t color, Vec2i pos, int scale)
 {
@@ -204,57 +208,128 @@ void DrawDot(TTileItem *t, color_t color, Vec2i pos, int scale)
 	Draw_Rect(pos.x, pos.y, scale, scale, color);
 }
 
+void AutomapCacheInit(Map *map)
+{
+	CArrayInit(&map->Automap.Pixels, sizeof(Uint32));
+	CArrayInit(&map->Automap.VisitedPixels, sizeof(Uint32));
+	const Uint32 zero = 0;
+	CArrayResize(&map->Automap.Pixels, map->Size.x * map->Size.y, &zero);
+	CArrayResize(
+		&map->Automap.VisitedPixels, map->Size.x * map->Size.y, &zero);
+	Vec2i v;
+	for (v.y = 0; v.y < map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < map->Size.x; v.x++)
+		{
+			AutomapOnTileChanged(map, v);
+		}
+	}
+}
+void AutomapCacheTerminate(AutomapCache *c)
+{
+	CArrayTerminate(&c->Pixels);
+	CArrayTerminate(&c->VisitedPixels);
+}
+
+void AutomapOnTileChanged(Map *map, const Vec2i tile)
+{
+	const Tile *t = MapGetTile(map, tile);
+	if (t == NULL || map->Automap.Pixels.size == 0)
+	{
+		return;
+	}
+	Uint32 pixel = 0;
+	if (!(t->flags & MAPTILE_IS_NOTHING))
+	{
+		color_t color = colorRoom;
+		if (t->flags & MAPTILE_IS_WALL)
+		{
+			color = colorWall;
+		}
+		else if (t->flags & MAPTILE_NO_WALK)
+		{
+			color = GetDoorColor(map, tile);
+		}
+		else if (t->flags & MAPTILE_IS_NORMAL_FLOOR)
+		{
+			color = colorFloor;
+		}
+		if (!ColorEquals(color, colorBlack))
+		{
+			pixel = COLOR2PIXEL(color);
+		}
+	}
+	const int idx = tile.y * map->Size.x + tile.x;
+	*(Uint32 *)CArrayGet(&map->Automap.Pixels, idx) = pixel;
+	*(Uint32 *)CArrayGet(&map->Automap.VisitedPixels, idx) =
+		t->isVisited ? pixel : 0;
+}
+
+// Same as ColorAlphaBlend, but on pixels with 8-bit channels
+static Uint32 PixelAlphaBlend(
+	const Uint32 dst, const Uint32 src, const Uint8 alpha)
+{
+	Uint32 out = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		const Uint32 c =
+			(((dst >> shift) & 0xFF) * (255 - alpha) +
+			((src >> shift) & 0xFF) * alpha) / 255;
+		out |= (shift == gGraphicsDevice.Ashift ? 0xFF : c) << shift;
+	}
+	return out;
+}
+static void DrawMapPixel(
+	Uint32 *dst, const Uint32 pixel, const bool isMasked)
+{
+	*dst = isMasked ? PixelAlphaBlend(*dst, pixel, 128) : pixel;
+}
+
 static void DrawMap(
 	Map *map,
 	Vec2i center, Vec2i centerOn, Vec2i size,
 	int scale, int flags)
 {
-	int x, y;
-	Vec2i mapPos = Vec2iAdd(center, Vec2iScale(centerOn, -scale));
-	for (y = 0; y < gMap.Size.y; y++)
+	GraphicsDevice *g = &gGraphicsDevice;
+	const BlitClipping *clip = &g->clipping;
+	const Vec2i mapPos = Vec2iAdd(center, Vec2iScale(centerOn, -scale));
+	const Uint32 *pixels = (flags & AUTOMAP_FLAGS_SHOWALL) ?
+		map->Automap.Pixels.data : map->Automap.VisitedPixels.data;
+	const bool isMasked = !!(flags & AUTOMAP_FLAGS_MASK);
+	// Only visit the tiles that overlap the clipping region
+	const int x0 = MAX(0, (clip->left - mapPos.x) / scale);
+	const int x1 = MIN(map->Size.x - 1, (clip->right - mapPos.x) / scale);
+	const int y0 = MAX(0, (clip->top - mapPos.y) / scale);
+	const int y1 = MIN(map->Size.y - 1, (clip->bottom - mapPos.y) / scale);
+	for (int y = y0; y <= y1; y++)
 	{
-		int i;
-		for (i = 0; i < scale; i++)
+		for (int i = 0; i < scale; i++)
 		{
-			for (x = 0; x < gMap.Size.x; x++)
+			const int py = mapPos.y + y * scale + i;
+			if (py < clip->top || py > clip->bottom)
 			{
-				Tile *tile = MapGetTile(map, Vec2iNew(x, y));
-				if (!(tile->flags & MAPTILE_IS_NOTHING) &&
-					(tile->isVisited || (flags & AUTOMAP_FLAGS_SHOWALL)))
+				continue;
+			}
+			Uint32 *row = g->buf + py * g->cachedConfig.Res.x;
+			for (int x = x0; x <= x1; x++)
+			{
+				const Uint32 pixel = pixels[y * map->Size.x + x];
+				if (pixel == 0)
 				{
-					int j;
-					for (j = 0; j < scale; j++)
+					continue;
+				}
+				for (int j = 0; j < scale; j++)
+				{
+					const int px = mapPos.x + x * scale + j;
+					if (px >= clip->left && px <= clip->right)
 					{
-						Vec2i drawPos = Vec2iNew(
-							mapPos.x + x*scale + j,
-							mapPos.y + y*scale + i);
-						color_t color = colorRoom;
-						if (tile->flags & MAPTILE_IS_WALL)
-						{
-							color = colorWall;
-						}
-						else if (tile->flags & MAPTILE_NO_WALK)
-						{
-							color = DoorColor(x, y);
-						}
-						else if (tile->flags & MAPTILE_IS_NORMAL_FLOOR)
-						{
-							color = colorFloor;
-						}
-						if (!ColorEquals(color, colorBlack))
-						{
-							if (flags & AUTOMAP_FLAGS_MASK)
-							{
-								color.a = MASK_ALPHA;
-							}
-							Draw_Point(drawPos.x, drawPos.y, color);
-						}
+						DrawMapPixel(&row[px], pixel, isMasked);
 					}
 				}
 			}
 		}
 	}
-	if (flags & AUTOMAP_FLAGS_MASK)
+	if (isMasked)
 	{
 		color_t color = { 255, 255, 255, 128 };
 		Draw_Rect(
@@ -35,6 +35,11 @@
 #define AUTOMAP_FLAGS_SHOWALL 0x01
 #define AUTOMAP_FLAGS_MASK 0x02
 
+void AutomapCacheInit(Map *map);
+void AutomapCacheTerminate(AutomapCache *c);
+// Update the automap colour of a tile whose flags changed or was visited
+void AutomapOnTileChanged(Map *map, const Vec2i tile);
+
 void AutomapDraw(int flags, bool showExit);
 void AutomapDrawRegion(
 	Map *map,
@@ -56,12 +56,16 @@
 
 #include <SDL.h>
 
+#include "blit_kernels.h"
+#include "blit_scale.h"
 #include "config.h"
 #include "grafx.h"
-#include "hqx/hqx.h"
 #include "palette.h"
 #include "utils.h" /* for debug() */
 
+static ConfigHandle sConfigBrightness = CONFIG_HANDLE("Graphics.Brightness");
+static ConfigHandle sConfigScaleMode = CONFIG_HANDLE("Graphics.ScaleMode");
+
 
 void BlitOld(int x, int y, PicPaletted *pic, const void *table, int mode)
 {
@@ -261,14 +265,22 @@ void Blit(GraphicsDevice *device, const Pic *pic, Vec2i pos)
 	}
 }
 
-static Uint32 PixelMult(Uint32 p, Uint32 m)
-{
-	return
-		((p & 0xFF) * (m & 0xFF) / 0xFF) |
-		((((p & 0xFF00) >> 8) * ((m & 0xFF00) >> 8) / 0xFF) << 8) |
-		((((p & 0xFF0000) >> 16) * ((m & 0xFF0000) >> 16) / 0xFF) << 16) |
-		((((p & 0xFF000000) >> 24) * ((m & 0xFF000000) >> 24) / 0xFF) << 24);
-}
+// Call a row kernel on each row of the pic, clipped to the device
+#define BLIT_CLIPPED_ROWS(_g, _pic, _pos, _kernel, ...)\
+	{\
+		const int _x0 = MAX((_pos).x, (_g)->clipping.left);\
+		const int _x1 = MIN((_pos).x + (_pic)->size.x - 1, (_g)->clipping.right);\
+		const int _y0 = MAX((_pos).y, (_g)->clipping.top);\
+		const int _y1 = MIN((_pos).y + (_pic)->size.y - 1, (_g)->clipping.bottom);\
+		for (int _y = _y0; _x0 <= _x1 && _y <= _y1; _y++)\
+		{\
+			_kernel(\
+				(_g)->buf + _y * (_g)->cachedConfig.Res.x + _x0,\
+				(_pic)->Data + (_y - (_pos).y) * (_pic)->size.x +\
+				_x0 - (_pos).x,\
+				_x1 - _x0 + 1, __VA_ARGS__);\
+		}\
+	}
 void BlitMasked(
 	GraphicsDevice *device,
 	const Pic *pic,
@@ -276,402 +288,165 @@ void BlitMasked(
 	color_t mask,
 	int isTransparent)
 {
-	Uint32 *current = pic->Data;
-	const Uint32 maskPixel = COLOR2PIXEL(mask);
-	int i;
 	pos = Vec2iAdd(pos, pic->offset);
-	for (i = 0; i < pic->size.y; i++)
-	{
-		int yoff = i + pos.y;
-		if (yoff > device->clipping.bottom)
-		{
-			break;
-		}
-		if (yoff < device->clipping.top)
-		{
-			current += pic->size.x;
-			continue;
-		}
-		yoff *= device->cachedConfig.Res.x;
-		for (int j = 0; j < pic->size.x; j++)
-		{
-			Uint32 *target;
-			int xoff = j + pos.x;
-			if (xoff < device->clipping.left)
-			{
-				current++;
-				continue;
-			}
-			if (xoff > device->clipping.right)
-			{
-				current += pic->size.x - j;
-				break;
-			}
-			if (isTransparent && *current == 0)
-			{
-				current++;
-				continue;
-			}
-			target = device->buf + yoff + xoff;
-			*target = PixelMult(*current, maskPixel);
-			current++;
-		}
-	}
+	BLIT_CLIPPED_ROWS(
+		device, pic, pos, BlitRowMult, COLOR2PIXEL(mask), !!isTransparent);
 }
 void BlitBlend(
 	GraphicsDevice *g, const Pic *pic, Vec2i pos, const color_t blend)
 {
-	Uint32 *current = pic->Data;
 	pos = Vec2iAdd(pos, pic->offset);
-	for (int i = 0; i < pic->size.y; i++)
-	{
-		int yoff = i + pos.y;
-		if (yoff > g->clipping.bottom)
-		{
-			break;
-		}
-		if (yoff < g->clipping.top)
-		{
-			current += pic->size.x;
-			continue;
-		}
-		yoff *= g->cachedConfig.Res.x;
-		for (int j = 0; j < pic->size.x; j++)
-		{
-			int xoff = j + pos.x;
-			if (xoff < g->clipping.left)
-			{
-				current++;
-				continue;
-			}
-			if (xoff > g->clipping.right)
-			{
-				current += pic->size.x - j;
-				break;
-			}
-			if (*current == 0)
-			{
-				current++;
-				continue;
-			}
-			Uint32 *target = g->buf + yoff + xoff;
-			const color_t currentColor = PIXEL2COLOR(*current);
-			color_t blendedColor = ColorMult(
-				currentColor, blend);
-			blendedColor.a = blend.a;
-			const color_t targetColor = PIXEL2COLOR(*target);
-			blendedColor = ColorAlphaBlend(targetColor, blendedColor);
-			*target = COLOR2PIXEL(blendedColor);
-			current++;
-		}
-	}
+	BLIT_CLIPPED_ROWS(
+		g, pic, pos, BlitRowBlend,
+		COLOR2PIXEL(blend), blend.a, g->Amask);
 }
 
-#define PixelIndex(x, y, w)		(y * w + x)
-
-static inline
-void Scale8(Uint32 *d, const Uint32 *s, const int w, const int h, const int sf)
+// Lookup table for the brightness of each 8-bit colour component
+// Multiply each component with the gamma factor, saturating at 255
+static Uint8 sBrightnessTable[256];
+static int sBrightnessTableValue = 0;
+static bool sBrightnessTableInit = false;
+static const Uint8 *GetBrightnessTable(const int brightness)
 {
-	int sx;
-	int sy;
-	int f = sf;
-
-	int dx, dy, dw;
-
-	if (f > 4)
+	if (!sBrightnessTableInit || sBrightnessTableValue != brightness)
 	{
-		f = 4;	/* max 4x for the moment */
-	}
-
-	dw = w * f;
-
-	for (sy = 0; sy < h; sy++) {
-		dy = f * sy;
-		for (sx = 0; sx < w; sx++)
+		double f = pow(1.07177346254, brightness);	// 10th root of 2; i.e. n^10 = 2
+		int m = (int)(0xFF * f);
+		for (int i = 0; i < 256; i++)
 		{
-			Uint32 p = s[PixelIndex(sx, sy, w)];
-			dx = f * sx;
-
-			switch (f) {
-				case 4:
-					/* right side */
-					d[PixelIndex((dx + 3),	(dy + 1),	dw)] = p;
-					d[PixelIndex((dx + 3),	(dy + 2),	dw)] = p;
-					d[PixelIndex((dx + 3),	dy,		dw)] = p;
-
-					/* bottom row */
-					d[PixelIndex(dx,	(dy + 3),	dw)] = p;
-					d[PixelIndex((dx + 1),	(dy + 3),	dw)] = p;
-					d[PixelIndex((dx + 2),	(dy + 3),	dw)] = p;
-
-					/* bottom right */
-					d[PixelIndex((dx + 3),	(dy + 3),	dw)] = p;
-
-				case 3:
-					/* right side */
-					d[PixelIndex((dx + 2),	(dy + 1),	dw)] = p;
-					d[PixelIndex((dx + 2),	dy,		dw)] = p;
-
-					/* bottom row */
-					d[PixelIndex(dx,	(dy + 2),	dw)] = p;
-					d[PixelIndex((dx + 1),	(dy + 2),	dw)] = p;
-
-					/* bottom right */
-					d[PixelIndex((dx + 2),	(dy + 2),	dw)] = p;
-
-				case 2:
-					d[PixelIndex((dx + 1),	dy,		dw)] = p;
-					d[PixelIndex((dx + 1),	(dy + 1),	dw)] = p;
-					d[PixelIndex(dx,	(dy + 1),	dw)] = p;
-
-				default:
-					d[PixelIndex(dx,	dy,		dw)] = p;
-			}
+			sBrightnessTable[i] = (Uint8)MIN(i * m / 0xFF, 0xFF);
 		}
+		sBrightnessTableValue = brightness;
+		sBrightnessTableInit = true;
 	}
+	return sBrightnessTable;
 }
 
-static Uint32 PixAvg(Uint32 p1, Uint32 p2)
-{
-	union
-	{
-		Uint8 rgba[4];
-		Uint32 out;
-	} u1, u2;
-	int i;
-	u1.out = p1;
-	u2.out = p2;
-	for (i = 0; i < 4; i++)
-	{
-		u1.rgba[i] = (Uint8)CLAMP(((int)u1.rgba[i] + u2.rgba[i]) / 2, 0, 255);
-	}
-	return u1.out;
-}
-static Uint32 Pix3rds(Uint32 p1, Uint32 p2)
-{
-	union
-	{
-		Uint8 rgba[4];
-		Uint32 out;
-	} u1, u2;
-	int i;
-	u1.out = p1;
-	u2.out = p2;
-	for (i = 0; i < 4; i++)
-	{
-		u1.rgba[i] = (Uint8)CLAMP(((int)u1.rgba[i] + u2.rgba[i]*2) / 3, 0, 255);
-	}
-	return u1.out;
-}
-static void Bilinear(
-	Uint32 *dest, const Uint32 *src,
-	const int w, const int h,
-	const int scaleFactor)
+// Convert a pixel from the back buffer's format to the display's format,
+// applying brightness at the same time
+#define CONVERT_PIXEL(_p, _sf, _df, _t)\
+	((Uint32)((_t)[((_p) >> (_sf)->Rshift) & 0xFF] >> (_df)->Rloss) << (_df)->Rshift |\
+	(Uint32)((_t)[((_p) >> (_sf)->Gshift) & 0xFF] >> (_df)->Gloss) << (_df)->Gshift |\
+	(Uint32)((_t)[((_p) >> (_sf)->Bshift) & 0xFF] >> (_df)->Bloss) << (_df)->Bshift)
+
+// Write rows [yBegin, yEnd) of the back buffer straight into the display
+// surface, converting the format and applying brightness in one pass
+// Each pixel is repeated scale times horizontally, then the whole row is
+// copied to make up the scaled height.
+// The display surface must be locked and either 16 or 32 bits per pixel
+static void BlitToDisplayRows(
+	SDL_Surface *dst, const Uint32 *src, const SDL_PixelFormat *srcFormat,
+	const Vec2i srcSize, const int scale, const Uint8 *brightness,
+	const int yBegin, const int yEnd)
 {
-	int sx, sy;
-	int dw = scaleFactor * w;
-	for (sy = 0; sy < h; sy++)
+	const SDL_PixelFormat *df = dst->format;
+	const int w = MIN(srcSize.x, dst->w / scale);
+	const int yMax = MIN(yEnd, dst->h / scale);
+	const size_t rowBytes = (size_t)w * scale * df->BytesPerPixel;
+	for (int y = yBegin; y < yMax; y++)
 	{
-		int dy = scaleFactor * sy;
-		for (sx = 0; sx < w; sx++)
+		const Uint32 *s = src + y * srcSize.x;
+		Uint8 *row = (Uint8 *)dst->pixels + y * scale * dst->pitch;
+		if (df->BytesPerPixel == 2)
 		{
-			Uint32 p = src[PixelIndex(sx, sy, w)];
-			int dx = scaleFactor * sx;
-			switch (scaleFactor)
+			Uint16 *d = (Uint16 *)row;
+			for (int x = 0; x < w; x++)
 			{
-			#define BLIT(x, y, pix) dest[PixelIndex((x), (y), dw)] = pix;
-			case 4:
+				const Uint16 p =
+					(Uint16)CONVERT_PIXEL(s[x], srcFormat, df, brightness);
+				for (int i = 0; i < scale; i++)
 				{
-					// 0 1 2 3|g
-					// 4 5 6 7|h
-					// 8 9 a b|i
-					// c d e f|j
-					// k-l-m-n+o
-					Uint32 pg = src[PixelIndex(MIN(sx+1, w-1), sy, w)];
-					Uint32 p2 = PixAvg(p, pg);
-					Uint32 p1 = PixAvg(p, p2);
-					Uint32 p3 = PixAvg(p2, pg);
-					Uint32 pk = src[PixelIndex(sx, MIN(sy+1, h-1), w)];
-					Uint32 p8 = PixAvg(p, pk);
-					Uint32 p4 = PixAvg(p, p8);
-					Uint32 pc = PixAvg(p8, pk);
-					Uint32 po = src[PixelIndex(MIN(sx+1, w-1), MIN(sy+1, h-1), w)];
-					Uint32 pi = PixAvg(pg, po);
-					Uint32 pa = PixAvg(p8, pi);
-					Uint32 p9 = PixAvg(p8, pa);
-					Uint32 pb = PixAvg(pa, pi);
-					Uint32 p6 = PixAvg(p2, pa);
-					Uint32 p5 = PixAvg(p4, p6);
-					Uint32 pm = PixAvg(pk, po);
-					Uint32 pe = PixAvg(pa, pm);
-					Uint32 ph = PixAvg(pg, pi);
-					Uint32 p7 = PixAvg(p6, ph);
-					Uint32 pj = PixAvg(pi, po);
-					Uint32 pd = PixAvg(pc, pe);
-					Uint32 pf = PixAvg(pe, pj);
-					BLIT(dx, dy, p);
-					BLIT(dx+1, dy, p1);
-					BLIT(dx+2, dy, p2);
-					BLIT(dx+3, dy, p3);
-					BLIT(dx, dy+1, p4);
-					BLIT(dx+1, dy+1, p5);
-					BLIT(dx+2, dy+1, p6);
-					BLIT(dx+3, dy+1, p7);
-					BLIT(dx, dy+2, p8);
-					BLIT(dx+1, dy+2, p9);
-					BLIT(dx+2, dy+2, pa);
-					BLIT(dx+3, dy+2, pb);
-					BLIT(dx, dy+3, pc);
-					BLIT(dx+1, dy+3, pd);
-					BLIT(dx+2, dy+3, pe);
-					BLIT(dx+3, dy+3, pf);
+					*d++ = p;
 				}
-				break;
-			case 3:
-				{
-					// 0 1 2|9
-					// 3 4 5|a
-					// 6 7 8|b
-					// c-d-e+f
-					Uint32 p9 = src[PixelIndex(MIN(sx+1, w-1), sy, w)];
-					Uint32 p1 = Pix3rds(p9, p);
-					Uint32 p2 = Pix3rds(p, p9);
-					Uint32 pc = src[PixelIndex(sx, MIN(sy+1, h-1), w)];
-					Uint32 p3 = Pix3rds(pc, p);
-					Uint32 p6 = Pix3rds(p, pc);
-					Uint32 pf = src[PixelIndex(MIN(sx+1, w-1), MIN(sy+1, h-1), w)];
-					Uint32 pa = Pix3rds(pf, p9);
-					Uint32 pb = Pix3rds(p9, pf);
-					Uint32 p4 = Pix3rds(pa, p3);
-					Uint32 p5 = Pix3rds(p3, pa);
-					Uint32 p7 = Pix3rds(pb, p6);
-					Uint32 p8 = Pix3rds(p6, pb);
-					BLIT(dx, dy, p);
-					BLIT(dx+1, dy, p1);
-					BLIT(dx+2, dy, p2);
-					BLIT(dx, dy+1, p3);
-					BLIT(dx+1, dy+1, p4);
-					BLIT(dx+2, dy+1, p5);
-					BLIT(dx, dy+2, p6);
-					BLIT(dx+1, dy+2, p7);
-					BLIT(dx+2, dy+2, p8);
-				}
-				break;
-			case 2:
+			}
+		}
+		else
+		{
+			Uint32 *d = (Uint32 *)row;
+			for (int x = 0; x < w; x++)
+			{
+				const Uint32 p = CONVERT_PIXEL(s[x], srcFormat, df, brightness);
+				for (int i = 0; i < scale; i++)
 				{
-					// 0 1|4
-					// 2 3|5
-					// 6-7+8
-					Uint32 p4 = src[PixelIndex(MIN(sx+1, w-1), sy, w)];
-					Uint32 p1 = PixAvg(p, p4);
-					Uint32 p6 = src[PixelIndex(sx, MIN(sy+1, h-1), w)];
-					Uint32 p2 = PixAvg(p, p6);
-					Uint32 p8 = src[PixelIndex(MIN(sx+1, w-1), MIN(sy+1, h-1), w)];
-					Uint32 p5 = PixAvg(p4, p8);
-					Uint32 p3 = PixAvg(p2, p5);
-					BLIT(dx, dy, p);
-					BLIT(dx+1, dy, p1);
-					BLIT(dx, dy+1, p2);
-					BLIT(dx+1, dy+1, p3);
+					*d++ = p;
 				}
-				break;
-			default:
-				BLIT(dx, dy, p);
-				break;
-			#undef BLIT
 			}
 		}
+		for (int i = 1; i < scale; i++)
+		{
+			memcpy(row + i * dst->pitch, row, rowBytes);
+		}
 	}
 }
 
-static void ApplyBrightness(Uint32 *screen, Vec2i screenSize, int brightness)
+typedef struct
+{
+	SDL_Surface *dst;
+	Uint32 *src;
+	const SDL_PixelFormat *srcFormat;
+	Vec2i srcSize;
+	int scale;
+	ScaleMode mode;
+	Uint32 *scaleBuf;
+	const Uint8 *brightness;
+} FlipJob;
+// Scale and convert a horizontal band of the frame
+static void FlipRows(void *data, const int begin, const int end)
 {
-	if (brightness == 0)
+	const FlipJob *job = data;
+	if (job->scale > 1 && job->mode != SCALE_MODE_NN)
 	{
-		return;
+		// Filtered scaling into the scale buffer, then convert that
+		BlitScaleRows(
+			job->scaleBuf, job->src, job->srcSize, job->scale, job->mode,
+			begin, end);
+		BlitToDisplayRows(
+			job->dst, job->scaleBuf, job->srcFormat,
+			Vec2iScale(job->srcSize, job->scale), 1, job->brightness,
+			begin * job->scale, end * job->scale);
 	}
-	double f = pow(1.07177346254, brightness);	// 10th root of 2; i.e. n^10 = 2
-	int m = (int)(0xFF * f);
-	int y;
-	for (y = 0; y < screenSize.y; y++)
+	else
 	{
-		int x;
-		for (x = 0; x < screenSize.x; x++)
-		{
-			// Semi-optimised pixel multiplcation routine
-			// Multiply each 8-bit component with the gamma mask
-			// Detect overflows by checking if there are bits above 255
-			// If so, turning into boolean (!!) and negation will create
-			// a -1 (i.e. FFFFFFFF) mask which fills all the bits with 1
-			// i.e. saturated multiply
-			int idx = x + y * screenSize.x;
-			Uint32 p = screen[idx];
-			Uint32 pp;
-			screen[idx] = 0;
-			pp = ((p & 0xFF) * m / 0xFF);
-			screen[idx] |= (pp | -!!(pp >> 8)) & 0xFF;
-			pp = (((p >> 8) & 0xFF) * m / 0xFF);
-			screen[idx] |= ((pp | -!!(pp >> 8)) & 0xFF) << 8;
-			pp = (((p >> 16) & 0xFF) * m / 0xFF);
-			screen[idx] |= ((pp | -!!(pp >> 8)) & 0xFF) << 16;
-			pp = (((p >> 24) & 0xFF) * m / 0xFF);
-			screen[idx] |= ((pp | -!!(pp >> 8)) & 0xFF) << 24;
-		}
+		BlitToDisplayRows(
+			job->dst, job->src, job->srcFormat, job->srcSize, job->scale,
+			job->brightness, begin, end);
 	}
 }
 
 void BlitFlip(GraphicsDevice *g)
 {
-	Uint32 *pScreen = (Uint32 *)g->screen->pixels;
-	const Vec2i size = g->cachedConfig.Res;
-	const int memSize = size.x * size.y;
-	const int scalef = g->cachedConfig.ScaleFactor;
-
-	ApplyBrightness(
-		g->buf, size, ConfigGetInt(&gConfig, "Graphics.Brightness"));
+	FlipJob job;
+	job.dst = g->ScreenSurface;
+	job.src = g->buf;
+	job.srcFormat = g->screen->format;
+	job.srcSize = g->cachedConfig.Res;
+	job.scale = g->ScaleBuf != NULL ? g->cachedConfig.ScaleFactor : 1;
+	job.mode = (ScaleMode)ConfigHandleGetEnum(&sConfigScaleMode);
+	job.scaleBuf = g->ScaleBuf;
+	job.brightness =
+		GetBrightnessTable(ConfigHandleGetInt(&sConfigBrightness));
+
+	// For unusual display formats, write to the back buffer's format, which
+	// has the same 32-bit layout, then let SDL convert
+	const bool convertBySDL =
+		job.dst->format->BytesPerPixel != 2 &&
+		job.dst->format->BytesPerPixel != 4;
+	if (convertBySDL)
+	{
+		job.dst = g->screen;
+	}
 
-	if (SDL_LockSurface(g->screen) == -1)
+	if (SDL_LockSurface(job.dst) == -1)
 	{
 		printf("Couldn't lock surface; not drawing\n");
 		return;
 	}
+	ThreadPoolRun(&g->FlipThreads, FlipRows, &job, job.srcSize.y);
+	SDL_UnlockSurface(job.dst);
 
-	//if (scalef == 1)
-	{
-		memcpy(pScreen, g->buf, sizeof *pScreen * memSize);
-		SDL_Surface *tmp = SDL_DisplayFormat(g->screen);
-		SDL_BlitSurface(tmp, NULL, g->ScreenSurface, NULL);
-		SDL_FreeSurface(tmp);
-		//memcpy(pScreen, g->buf, sizeof *pScreen * memSize);
-	}
-	/*else if (ConfigGetEnum(&gConfig, "Graphics.ScaleMode") == SCALE_MODE_BILINEAR)
-	{
-		Bilinear(pScreen, g->buf, size.x, size.y, scalef);
-	}
-	else if (ConfigGetEnum(&gConfig, "Graphics.ScaleMode") == SCALE_MODE_HQX)
+	if (convertBySDL)
 	{
-		switch (scalef)
-		{
-		case 2:
-			hq2x_32(g->buf, pScreen, size.x, size.y);
-			break;
-		case 3:
-			hq3x_32(g->buf, pScreen, size.x, size.y);
-			break;
-		case 4:
-			hq4x_32(g->buf, pScreen, size.x, size.y);
-			break;
-		default:
-			assert(0);
-			break;
-		}
+		SDL_BlitSurface(g->screen, NULL, g->ScreenSurface, NULL);
 	}
-	else
-	{
-		Scale8(pScreen, g->buf, size.x, size.y, scalef);
-	}*/
-
-	SDL_UnlockSurface(g->screen);
-	//SDL_Flip(g->screen);
 	SDL_Flip(g->ScreenSurface);
 }
@@ -0,0 +1,176 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "blit_kernels.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+// Exact x / 255 for 0 <= x <= 255 * 255
+#define DIV255(_x) (((_x) + 1 + ((_x) >> 8)) >> 8)
+
+static Uint32 PixelMult(const Uint32 p, const Uint32 m)
+{
+	Uint32 out = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		const Uint32 c = ((p >> shift) & 0xFF) * ((m >> shift) & 0xFF);
+		out |= DIV255(c) << shift;
+	}
+	return out;
+}
+void BlitRowMultScalar(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 mask, const bool isTransparent)
+{
+	for (int i = 0; i < n; i++)
+	{
+		if (isTransparent && src[i] == 0) continue;
+		dst[i] = PixelMult(src[i], mask);
+	}
+}
+
+void BlitRowBlendScalar(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 blend, const Uint8 alpha, const Uint32 aMask)
+{
+	const Uint32 a = alpha;
+	const Uint32 invA = 255 - alpha;
+	for (int i = 0; i < n; i++)
+	{
+		if (src[i] == 0) continue;
+		const Uint32 b = PixelMult(src[i], blend);
+		// Blend two channels at a time; each 16-bit half stays in range
+		const Uint32 rb =
+			(dst[i] & 0x00FF00FF) * invA + (b & 0x00FF00FF) * a;
+		const Uint32 ag =
+			((dst[i] >> 8) & 0x00FF00FF) * invA + ((b >> 8) & 0x00FF00FF) * a;
+		const Uint32 rbOut =
+			((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+		const Uint32 agOut =
+			((ag + 0x00010001 + ((ag >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+		dst[i] = rbOut | (agOut << 8) | aMask;
+	}
+}
+
+#ifdef __SSE2__
+
+static __m128i Div255Epu16(const __m128i x)
+{
+	return _mm_srli_epi16(
+		_mm_add_epi16(
+			_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)),
+		8);
+}
+// Multiply 4 pixels channel-wise with the unpacked mask
+static __m128i MultEpu8(const __m128i p, const __m128i m16)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = Div255Epu16(
+		_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), m16));
+	const __m128i hi = Div255Epu16(
+		_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), m16));
+	return _mm_packus_epi16(lo, hi);
+}
+
+void BlitRowMult(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 mask, const bool isTransparent)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i m16 =
+		_mm_unpacklo_epi8(_mm_set1_epi32((int)mask), zero);
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i out = MultEpu8(s, m16);
+		if (isTransparent)
+		{
+			// Keep the destination where the source is zero
+			const __m128i isZero = _mm_cmpeq_epi32(s, zero);
+			const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+			out = _mm_or_si128(
+				_mm_and_si128(isZero, d), _mm_andnot_si128(isZero, out));
+		}
+		_mm_storeu_si128((__m128i *)(dst + i), out);
+	}
+	BlitRowMultScalar(dst + i, src + i, n - i, mask, isTransparent);
+}
+
+void BlitRowBlend(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 blend, const Uint8 alpha, const Uint32 aMask)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i m16 =
+		_mm_unpacklo_epi8(_mm_set1_epi32((int)blend), zero);
+	const __m128i a16 = _mm_set1_epi16(alpha);
+	const __m128i invA16 = _mm_set1_epi16(255 - alpha);
+	const __m128i aMask4 = _mm_set1_epi32((int)aMask);
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		const __m128i b = MultEpu8(s, m16);
+		const __m128i lo = Div255Epu16(_mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invA16),
+			_mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), a16)));
+		const __m128i hi = Div255Epu16(_mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invA16),
+			_mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), a16)));
+		const __m128i out =
+			_mm_or_si128(_mm_packus_epi16(lo, hi), aMask4);
+		// Keep the destination where the source is zero
+		const __m128i isZero = _mm_cmpeq_epi32(s, zero);
+		_mm_storeu_si128(
+			(__m128i *)(dst + i),
+			_mm_or_si128(
+				_mm_and_si128(isZero, d), _mm_andnot_si128(isZero, out)));
+	}
+	BlitRowBlendScalar(dst + i, src + i, n - i, blend, alpha, aMask);
+}
+
+#else
+
+void BlitRowMult(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 mask, const bool isTransparent)
+{
+	BlitRowMultScalar(dst, src, n, mask, isTransparent);
+}
+void BlitRowBlend(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 blend, const Uint8 alpha, const Uint32 aMask)
+{
+	BlitRowBlendScalar(dst, src, n, blend, alpha, aMask);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_stdinc.h>
+
+// Kernels for blitting a row of 32-bit pixels with 8-bit channels
+// SIMD versions are used where available (selected at build time); they
+// give exactly the same results as the scalar versions.
+
+// Multiply each channel of the source pixels with the mask, i.e. tint
+// If transparent, zero source pixels are skipped
+void BlitRowMult(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 mask, const bool isTransparent);
+// Tint non-zero source pixels with the blend pixel, then alpha blend them
+// onto the destination with the blend alpha; the result is opaque
+void BlitRowBlend(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 blend, const Uint8 alpha, const Uint32 aMask);
+
+// Scalar versions, for reference
+void BlitRowMultScalar(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 mask, const bool isTransparent);
+void BlitRowBlendScalar(
+	Uint32 *dst, const Uint32 *src, const int n,
+	const Uint32 blend, const Uint8 alpha, const Uint32 aMask);
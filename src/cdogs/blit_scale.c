@@ -0,0 +1,238 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "blit_scale.h"
+
+#include <string.h>
+
+#include "hqx/hqx.h"
+#include "utils.h"
+
+
+#define PixelIndex(x, y, w)		(y * w + x)
+
+static void ScaleNearestRows(
+	Uint32 *dst, const Uint32 *src, const Vec2i size, const int scale,
+	const int yBegin, const int yEnd)
+{
+	const int dw = size.x * scale;
+	for (int sy = yBegin; sy < yEnd; sy++)
+	{
+		const Uint32 *s = src + sy * size.x;
+		Uint32 *d = dst + sy * scale * dw;
+		for (int sx = 0; sx < size.x; sx++)
+		{
+			for (int i = 0; i < scale; i++)
+			{
+				*d++ = s[sx];
+			}
+		}
+		// Duplicate the whole row rather than writing pixels column-wise
+		for (int i = 1; i < scale; i++)
+		{
+			memcpy(d - dw + i * dw, d - dw, dw * sizeof *d);
+		}
+	}
+}
+
+// Per-channel averages, computed on all four channels at once
+static Uint32 PixAvg(const Uint32 p1, const Uint32 p2)
+{
+	return (p1 & p2) + (((p1 ^ p2) & 0xFEFEFEFE) >> 1);
+}
+static Uint32 Pix3rds(Uint32 p1, Uint32 p2)
+{
+	union
+	{
+		Uint8 rgba[4];
+		Uint32 out;
+	} u1, u2;
+	int i;
+	u1.out = p1;
+	u2.out = p2;
+	for (i = 0; i < 4; i++)
+	{
+		u1.rgba[i] = (Uint8)CLAMP(((int)u1.rgba[i] + u2.rgba[i]*2) / 3, 0, 255);
+	}
+	return u1.out;
+}
+static void BilinearRows(
+	Uint32 *dest, const Uint32 *src,
+	const int w, const int h,
+	const int scaleFactor, const int yBegin, const int yEnd)
+{
+	int sx, sy;
+	int dw = scaleFactor * w;
+	for (sy = yBegin; sy < yEnd; sy++)
+	{
+		int dy = scaleFactor * sy;
+		for (sx = 0; sx < w; sx++)
+		{
+			Uint32 p = src[PixelIndex(sx, sy, w)];
+			int dx = scaleFactor * sx;
+			switch (scaleFactor)
+			{
+			#define BLIT(x, y, pix) dest[PixelIndex((x), (y), dw)] = pix;
+			case 4:
+				{
+					// 0 1 2 3|g
+					// 4 5 6 7|h
+					// 8 9 a b|i
+					// c d e f|j
+					// k-l-m-n+o
+					Uint32 pg = src[PixelIndex(MIN(sx+1, w-1), sy, w)];
+					Uint32 p2 = PixAvg(p, pg);
+					Uint32 p1 = PixAvg(p, p2);
+					Uint32 p3 = PixAvg(p2, pg);
+					Uint32 pk = src[PixelIndex(sx, MIN(sy+1, h-1), w)];
+					Uint32 p8 = PixAvg(p, pk);
+					Uint32 p4 = PixAvg(p, p8);
+					Uint32 pc = PixAvg(p8, pk);
+					Uint32 po = src[PixelIndex(MIN(sx+1, w-1), MIN(sy+1, h-1), w)];
+					Uint32 pi = PixAvg(pg, po);
+					Uint32 pa = PixAvg(p8, pi);
+					Uint32 p9 = PixAvg(p8, pa);
+					Uint32 pb = PixAvg(pa, pi);
+					Uint32 p6 = PixAvg(p2, pa);
+					Uint32 p5 = PixAvg(p4, p6);
+					Uint32 pm = PixAvg(pk, po);
+					Uint32 pe = PixAvg(pa, pm);
+					Uint32 ph = PixAvg(pg, pi);
+					Uint32 p7 = PixAvg(p6, ph);
+					Uint32 pj = PixAvg(pi, po);
+					Uint32 pd = PixAvg(pc, pe);
+					Uint32 pf = PixAvg(pe, pj);
+					BLIT(dx, dy, p);
+					BLIT(dx+1, dy, p1);
+					BLIT(dx+2, dy, p2);
+					BLIT(dx+3, dy, p3);
+					BLIT(dx, dy+1, p4);
+					BLIT(dx+1, dy+1, p5);
+					BLIT(dx+2, dy+1, p6);
+					BLIT(dx+3, dy+1, p7);
+					BLIT(dx, dy+2, p8);
+					BLIT(dx+1, dy+2, p9);
+					BLIT(dx+2, dy+2, pa);
+					BLIT(dx+3, dy+2, pb);
+					BLIT(dx, dy+3, pc);
+					BLIT(dx+1, dy+3, pd);
+					BLIT(dx+2, dy+3, pe);
+					BLIT(dx+3, dy+3, pf);
+				}
+				break;
+			case 3:
+				{
+					// 0 1 2|9
+					// 3 4 5|a
+					// 6 7 8|b
+					// c-d-e+f
+					Uint32 p9 = src[PixelIndex(MIN(sx+1, w-1), sy, w)];
+					Uint32 p1 = Pix3rds(p9, p);
+					Uint32 p2 = Pix3rds(p, p9);
+					Uint32 pc = src[PixelIndex(sx, MIN(sy+1, h-1), w)];
+					Uint32 p3 = Pix3rds(pc, p);
+					Uint32 p6 = Pix3rds(p, pc);
+					Uint32 pf = src[PixelIndex(MIN(sx+1, w-1), MIN(sy+1, h-1), w)];
+					Uint32 pa = Pix3rds(pf, p9);
+					Uint32 pb = Pix3rds(p9, pf);
+					Uint32 p4 = Pix3rds(pa, p3);
+					Uint32 p5 = Pix3rds(p3, pa);
+					Uint32 p7 = Pix3rds(pb, p6);
+					Uint32 p8 = Pix3rds(p6, pb);
+					BLIT(dx, dy, p);
+					BLIT(dx+1, dy, p1);
+					BLIT(dx+2, dy, p2);
+					BLIT(dx, dy+1, p3);
+					BLIT(dx+1, dy+1, p4);
+					BLIT(dx+2, dy+1, p5);
+					BLIT(dx, dy+2, p6);
+					BLIT(dx+1, dy+2, p7);
+					BLIT(dx+2, dy+2, p8);
+				}
+				break;
+			case 2:
+				{
+					// 0 1|4
+					// 2 3|5
+					// 6-7+8
+					Uint32 p4 = src[PixelIndex(MIN(sx+1, w-1), sy, w)];
+					Uint32 p1 = PixAvg(p, p4);
+					Uint32 p6 = src[PixelIndex(sx, MIN(sy+1, h-1), w)];
+					Uint32 p2 = PixAvg(p, p6);
+					Uint32 p8 = src[PixelIndex(MIN(sx+1, w-1), MIN(sy+1, h-1), w)];
+					Uint32 p5 = PixAvg(p4, p8);
+					Uint32 p3 = PixAvg(p2, p5);
+					BLIT(dx, dy, p);
+					BLIT(dx+1, dy, p1);
+					BLIT(dx, dy+1, p2);
+					BLIT(dx+1, dy+1, p3);
+				}
+				break;
+			default:
+				BLIT(dx, dy, p);
+				break;
+			#undef BLIT
+			}
+		}
+	}
+}
+
+void BlitScaleRows(
+	Uint32 *dst, Uint32 *src, const Vec2i size, const int scale,
+	const ScaleMode mode, const int yBegin, const int yEnd)
+{
+	if (mode == SCALE_MODE_HQX && scale >= 2 && scale <= 4)
+	{
+		const uint32_t rowBytes = size.x * sizeof *src;
+		switch (scale)
+		{
+		case 2:
+			hq2x_32_rb_rows(
+				src, rowBytes, dst, rowBytes * 2, size.x, size.y,
+				yBegin, yEnd);
+			break;
+		case 3:
+			hq3x_32_rb_rows(
+				src, rowBytes, dst, rowBytes * 3, size.x, size.y,
+				yBegin, yEnd);
+			break;
+		default:
+			hq4x_32_rb_rows(
+				src, rowBytes, dst, rowBytes * 4, size.x, size.y,
+				yBegin, yEnd);
+			break;
+		}
+	}
+	else if (mode == SCALE_MODE_BILINEAR && scale >= 2 && scale <= 4)
+	{
+		BilinearRows(dst, src, size.x, size.y, scale, yBegin, yEnd);
+	}
+	else
+	{
+		ScaleNearestRows(dst, src, size, scale, yBegin, yEnd);
+	}
+}
@@ -55,43 +55,63 @@
 #include "drawtools.h"
 #include "game_events.h"
 #include "json_utils.h"
+#include "net_assets.h"
 #include "net_util.h"
 #include "objs.h"
 #include "screen_shake.h"
 
+static ConfigHandle sConfigOriginalPics = CONFIG_HANDLE("Graphics.OriginalPics");
+
 BulletClasses gBulletClasses;
 
 #define SOUND_LOCK_MOBILE_OBJECT 12
 #define SPECIAL_LOCK 12
 
 
-// TODO: use map structure?
 BulletClass *StrBulletClass(const char *s)
 {
 	if (s == NULL || strlen(s) == 0)
 	{
 		return NULL;
 	}
-	for (int i = 0; i < (int)gBulletClasses.CustomClasses.size; i++)
+	int i = NameMapGet(&gBulletClasses.CustomClassesByName, s);
+	if (i >= 0)
 	{
-		BulletClass *b = CArrayGet(&gBulletClasses.CustomClasses, i);
-		if (strcmp(s, b->Name) == 0)
-		{
-			return b;
-		}
+		return CArrayGet(&gBulletClasses.CustomClasses, i);
 	}
-	for (int i = 0; i < (int)gBulletClasses.Classes.size; i++)
+	i = NameMapGet(&gBulletClasses.ClassesByName, s);
+	if (i >= 0)
 	{
-		BulletClass *b = CArrayGet(&gBulletClasses.Classes, i);
-		if (strcmp(s, b->Name) == 0)
-		{
-			return b;
-		}
+		return CArrayGet(&gBulletClasses.Classes, i);
 	}
 	CASSERT(false, "cannot parse bullet name");
 	return NULL;
 }
 
+BulletClass *IdBulletClass(const int i)
+{
+	CASSERT(
+		i >= 0 &&
+		i < (int)gBulletClasses.Classes.size +
+		(int)gBulletClasses.CustomClasses.size,
+		"Bullet index out of bounds");
+	if (i < (int)gBulletClasses.Classes.size)
+	{
+		return CArrayGet(&gBulletClasses.Classes, i);
+	}
+	return CArrayGet(
+		&gBulletClasses.CustomClasses, i - gBulletClasses.Classes.size);
+}
+int BulletClassId(const BulletClass *b)
+{
+	const int i = CArrayIndexOf(&gBulletClasses.Classes, b);
+	if (i >= 0) return i;
+	const int ci = CArrayIndexOf(&gBulletClasses.CustomClasses, b);
+	CASSERT(ci >= 0, "cannot find bullet");
+	if (ci < 0) return -1;
+	return (int)gBulletClasses.Classes.size + ci;
+}
+
 // Draw functions
 
 static CPicDrawContext GetBulletDrawContext(const int id)
@@ -303,7 +323,7 @@ bool UpdateBullet(TMobileObject *obj, const int ticks)
 			b.u.BulletBounce.BounceVel = Vec2i2Net(bounceVel);
 			obj->vel = bounceVel;
 		}
-		GameEventsEnqueue(&gGameEvents, b);
+		GameEventsEnqueue(&gGameEvents, &b);
 		if (!alive)
 		{
 			return false;
@@ -457,6 +477,11 @@ void BulletInitialize(BulletClasses *bullets)
 	memset(bullets, 0, sizeof *bullets);
 	CArrayInit(&bullets->Classes, sizeof(BulletClass));
 	CArrayInit(&bullets->CustomClasses, sizeof(BulletClass));
+	NAME_MAP_INIT(
+		&bullets->ClassesByName, &bullets->Classes, BulletClass, Name, true);
+	NAME_MAP_INIT(
+		&bullets->CustomClassesByName, &bullets->CustomClasses, BulletClass,
+		Name, true);
 }
 static void BulletClassFree(BulletClass *b);
 void BulletLoadJSON(
@@ -575,7 +600,7 @@ static void LoadBullet(
 			b->CPic.u1.Tint.v = atof(tint->text);
 		}
 		if ((json_find_first_label(pic, "OldPic") &&
-			ConfigGetBool(&gConfig, "Graphics.OriginalPics")) ||
+			ConfigHandleGetBool(&sConfigOriginalPics)) ||
 			!picLoaded)
 		{
 			int oldPic = PIC_UZIBULLET;
@@ -700,6 +725,8 @@ void BulletTerminate(BulletClasses *bullets)
 	CArrayTerminate(&bullets->Classes);
 	BulletClassesClear(&bullets->CustomClasses);
 	CArrayTerminate(&bullets->CustomClasses);
+	NameMapTerminate(&bullets->ClassesByName);
+	NameMapTerminate(&bullets->CustomClassesByName);
 }
 void BulletClassesClear(CArray *classes)
 {
@@ -725,29 +752,9 @@ void BulletAdd(const NAddBullet add)
 {
 	const Vec2i pos = Net2Vec2i(add.MuzzlePos);
 
-	// Find an empty slot in mobobj list
-	TMobileObject *obj = NULL;
-	int i;
-	for (i = 0; i < (int)gMobObjs.size; i++)
-	{
-		TMobileObject *m = CArrayGet(&gMobObjs, i);
-		if (!m->isInUse)
-		{
-			obj = m;
-			break;
-		}
-	}
-	if (obj == NULL)
-	{
-		TMobileObject m;
-		memset(&m, 0, sizeof m);
-		CArrayPushBack(&gMobObjs, &m);
-		i = (int)gMobObjs.size - 1;
-		obj = CArrayGet(&gMobObjs, i);
-	}
-	memset(obj, 0, sizeof *obj);
-	obj->UID = add.UID;
-	obj->bulletClass = StrBulletClass(add.BulletClass);
+	const int i = MobObjAdd(add.UID);
+	TMobileObject *obj = CArrayGet(&gMobObjs, i);
+	obj->bulletClass = NetAssetsGetBullet(add.BulletClassId);
 	obj->x = pos.x;
 	obj->y = pos.y;
 	obj->z = add.MuzzleHeight;
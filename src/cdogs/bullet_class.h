@@ -52,6 +52,7 @@
 
 #include "proto/msg.pb.h"
 
+#include "name_map.h"
 #include "particle.h"
 #include "sounds.h"
 #include "tile.h"
@@ -104,11 +105,16 @@ typedef struct
 	CArray Classes;	// of BulletClass
 	BulletClass Default;
 	CArray CustomClasses;	// of BulletClass
+	NameMap ClassesByName;
+	NameMap CustomClassesByName;
 	json_t *root;
 } BulletClasses;
 extern BulletClasses gBulletClasses;
 
 BulletClass *StrBulletClass(const char *s);
+// Custom bullets' IDs follow the built-in ones
+BulletClass *IdBulletClass(const int i);
+int BulletClassId(const BulletClass *b);
 
 void BulletInitialize(BulletClasses *bullets);
 void BulletLoadJSON(
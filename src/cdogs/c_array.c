@@ -118,6 +118,16 @@ void *CArrayGet(const CArray *a, int idx)
 	return &((char *)a->data)[idx * a->elemSize];
 }
 
+int CArrayIndexOf(const CArray *a, const void *elem)
+{
+	const char *data = a->data;
+	const char *e = elem;
+	if (data == NULL || e < data || e >= data + a->size * a->elemSize)
+	{
+		return -1;
+	}
+	return (int)((size_t)(e - data) / a->elemSize);
+}
 void CArrayClear(CArray *a)
 {
 	a->size = 0;
@@ -45,6 +45,8 @@ void CArrayInsert(CArray *a, int index, void *elem);
 void CArrayDelete(CArray *a, int index);
 void CArrayResize(CArray *a, const size_t size, const void *value);
 void *CArrayGet(const CArray *a, int index);	// gets address
+// Index of an element from CArrayGet, or -1 if not in the array
+int CArrayIndexOf(const CArray *a, const void *elem);
 void CArrayClear(CArray *a);
 void CArrayRemoveIf(CArray *a, bool(*removeIf)(const void *));
 void CArrayFillZero(CArray *a);
@@ -34,6 +34,8 @@
 #include "los.h"
 #include "player.h"
 
+static ConfigHandle sConfigSplitscreen = CONFIG_HANDLE("Interface.Splitscreen");
+
 
 #define PAN_SPEED 4
 
@@ -441,7 +443,7 @@ static void DoBuffer(
 
 bool CameraIsSingleScreen(void)
 {
-	if (ConfigGetEnum(&gConfig, "Interface.Splitscreen") == SPLITSCREEN_ALWAYS)
+	if (ConfigHandleGetEnum(&sConfigSplitscreen) == SPLITSCREEN_ALWAYS)
 	{
 		return false;
 	}
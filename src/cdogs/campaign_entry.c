@@ -63,20 +63,22 @@ bool CampaignEntryTryLoad(
 	{
 		return false;
 	}
+	CampaignEntryInitScanned(entry, path, mode, buf, numMissions);
+	CFREE(buf);
+	return true;
+}
+void CampaignEntryInitScanned(
+	CampaignEntry *entry, const char *path, GameMode mode,
+	const char *title, const int numMissions)
+{
 	// cap length of title
-	size_t maxLen = 70;
-	if (strlen(buf) > maxLen)
-	{
-		buf[maxLen] = '\0';
-	}
-	char title[256];
-	sprintf(title, "%s (%d)", buf, numMissions);
-	CampaignEntryInit(entry, title, mode);
+	const int maxLen = 70;
+	char info[256];
+	sprintf(info, "%.*s (%d)", maxLen, title, numMissions);
+	CampaignEntryInit(entry, info, mode);
 	CSTRDUP(entry->Filename, PathGetBasename(path));
 	CSTRDUP(entry->Path, path);
 	entry->NumMissions = numMissions;
-	CFREE(buf);
-	return true;
 }
 void CampaignEntryTerminate(CampaignEntry *entry)
 {
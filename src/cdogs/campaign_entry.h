@@ -43,4 +43,8 @@ void CampaignEntryInit(CampaignEntry *entry, const char *title, GameMode mode);
 void CampaignEntryCopy(CampaignEntry *dst, CampaignEntry *src);
 bool CampaignEntryTryLoad(
 	CampaignEntry *entry, const char *path, GameMode mode);
+// Initialise from the title and number of missions of a scanned campaign
+void CampaignEntryInitScanned(
+	CampaignEntry *entry, const char *path, GameMode mode,
+	const char *title, const int numMissions);
 void CampaignEntryTerminate(CampaignEntry *entry);
@@ -0,0 +1,267 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "campaign_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include "json_utils.h"
+#include "log.h"
+#include "map_new.h"
+#include "sys_config.h"
+#include "utils.h"
+
+#define CAMPAIGN_INDEX_VERSION 1
+
+
+// Size and modification time of the file that is scanned; for archives,
+// that's the campaign.json inside it
+static bool GetStamp(const char *path, long long *size, long long *mtime)
+{
+	char buf[CDOGS_PATH_MAX];
+	if (strcmp(StrGetFileExt(path), "cdogscpn") == 0 ||
+		strcmp(StrGetFileExt(path), "CDOGSCPN") == 0)
+	{
+		sprintf(buf, "%s/campaign.json", path);
+	}
+	else
+	{
+		strcpy(buf, path);
+	}
+	struct stat st;
+	if (stat(buf, &st) != 0)
+	{
+		return false;
+	}
+	*size = (long long)st.st_size;
+	*mtime = (long long)st.st_mtime;
+	return true;
+}
+
+// Sizes and times don't fit in the int pairs of json_utils
+static void AddLongLongPair(json_t *parent, const char *name, long long n)
+{
+	char buf[32];
+	sprintf(buf, "%lld", n);
+	json_insert_pair_into_object(parent, name, json_new_number(buf));
+}
+static void LoadLongLong(long long *value, json_t *node, const char *name)
+{
+	if (!TryLoadValue(&node, name))
+	{
+		return;
+	}
+	*value = atoll(node->text);
+}
+
+void CampaignIndexLoad(CampaignIndex *ci, const char *filename)
+{
+	memset(ci, 0, sizeof *ci);
+	CArrayInit(&ci->Entries, sizeof(CampaignIndexEntry));
+	NAME_MAP_INIT(&ci->byPath, &ci->Entries, CampaignIndexEntry, Path, true);
+
+	json_t *root = NULL;
+	FILE *f = fopen(filename, "r");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_DEBUG, "no campaign index(%s)", filename);
+		goto bail;
+	}
+	if (json_stream_parse(f, &root) != JSON_OK)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot parse campaign index(%s)", filename);
+		goto bail;
+	}
+	// Scans depend on the map version, since newer maps are rejected
+	int version = 0;
+	int mapVersion = 0;
+	LoadInt(&version, root, "Version");
+	LoadInt(&mapVersion, root, "MapVersion");
+	if (version != CAMPAIGN_INDEX_VERSION || mapVersion != MAP_VERSION ||
+		json_find_first_label(root, "Campaigns") == NULL)
+	{
+		LOG(LM_MAIN, LL_INFO, "campaign index(%s) is out of date", filename);
+		goto bail;
+	}
+	for (json_t *node = json_find_first_label(root, "Campaigns")->child->child;
+		node != NULL;
+		node = node->next)
+	{
+		CampaignIndexEntry e;
+		memset(&e, 0, sizeof e);
+		LoadStr(&e.Path, node, "Path");
+		if (e.Path == NULL)
+		{
+			continue;
+		}
+		LoadLongLong(&e.Size, node, "Size");
+		LoadLongLong(&e.Mtime, node, "Mtime");
+		LoadBool(&e.IsCampaign, node, "IsCampaign");
+		if (e.IsCampaign)
+		{
+			LoadStr(&e.Title, node, "Title");
+			LoadInt(&e.NumMissions, node, "Missions");
+			if (e.Title == NULL)
+			{
+				CFREE(e.Path);
+				continue;
+			}
+		}
+		CArrayPushBack(&ci->Entries, &e);
+	}
+
+bail:
+	json_free_value(&root);
+	if (f != NULL)
+	{
+		fclose(f);
+	}
+}
+
+void CampaignIndexSave(CampaignIndex *ci, const char *filename)
+{
+	bool isChanged = ci->isChanged;
+	CA_FOREACH(const CampaignIndexEntry, e, ci->Entries)
+		isChanged = isChanged || !e->isUsed;
+	CA_FOREACH_END()
+	if (!isChanged)
+	{
+		return;
+	}
+
+	json_t *root = json_new_object();
+	AddIntPair(root, "Version", CAMPAIGN_INDEX_VERSION);
+	AddIntPair(root, "MapVersion", MAP_VERSION);
+	json_t *campaignsNode = json_new_array();
+	CA_FOREACH(const CampaignIndexEntry, e, ci->Entries)
+		if (!e->isUsed)
+		{
+			continue;
+		}
+		json_t *node = json_new_object();
+		AddStringPair(node, "Path", e->Path);
+		AddLongLongPair(node, "Size", e->Size);
+		AddLongLongPair(node, "Mtime", e->Mtime);
+		AddBoolPair(node, "IsCampaign", e->IsCampaign);
+		if (e->IsCampaign)
+		{
+			AddStringPair(node, "Title", e->Title);
+			AddIntPair(node, "Missions", e->NumMissions);
+		}
+		json_insert_child(campaignsNode, node);
+	CA_FOREACH_END()
+	json_insert_pair_into_object(root, "Campaigns", campaignsNode);
+
+	char *text = NULL;
+	json_tree_to_string(root, &text);
+	char *formatText = json_format_string(text);
+	FILE *f = fopen(filename, "w");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot save campaign index(%s)", filename);
+	}
+	else
+	{
+		fputs(formatText, f);
+		fclose(f);
+		ci->isChanged = false;
+	}
+
+	CFREE(formatText);
+	CFREE(text);
+	json_free_value(&root);
+}
+
+void CampaignIndexTerminate(CampaignIndex *ci)
+{
+	CA_FOREACH(CampaignIndexEntry, e, ci->Entries)
+		CFREE(e->Path);
+		CFREE(e->Title);
+	CA_FOREACH_END()
+	CArrayTerminate(&ci->Entries);
+	NameMapTerminate(&ci->byPath);
+}
+
+bool CampaignIndexScan(
+	CampaignIndex *ci, const char *path, char **title, int *numMissions)
+{
+	long long size = 0;
+	long long mtime = 0;
+	const bool hasStamp = GetStamp(path, &size, &mtime);
+	const int idx = NameMapGet(&ci->byPath, path);
+	CampaignIndexEntry *e = idx >= 0 ? CArrayGet(&ci->Entries, idx) : NULL;
+	if (e != NULL && hasStamp && e->Size == size && e->Mtime == mtime)
+	{
+		e->isUsed = true;
+		if (e->IsCampaign)
+		{
+			CSTRDUP(*title, e->Title);
+			*numMissions = e->NumMissions;
+		}
+		return e->IsCampaign;
+	}
+
+	// New or changed; scan it and update the index
+	char *t = NULL;
+	int n = 0;
+	const bool isCampaign = MapNewScan(path, &t, &n) == 0;
+	if (hasStamp)
+	{
+		if (e == NULL)
+		{
+			CampaignIndexEntry eNew;
+			memset(&eNew, 0, sizeof eNew);
+			CSTRDUP(eNew.Path, path);
+			CArrayPushBack(&ci->Entries, &eNew);
+			e = CArrayGet(&ci->Entries, (int)ci->Entries.size - 1);
+		}
+		CFREE(e->Title);
+		e->Title = NULL;
+		e->Size = size;
+		e->Mtime = mtime;
+		e->IsCampaign = isCampaign;
+		if (isCampaign)
+		{
+			CSTRDUP(e->Title, t);
+		}
+		e->NumMissions = isCampaign ? n : 0;
+		e->isUsed = true;
+		ci->isChanged = true;
+	}
+	if (isCampaign)
+	{
+		*title = t;
+		*numMissions = n;
+	}
+	else
+	{
+		CFREE(t);
+	}
+	return isCampaign;
+}
@@ -0,0 +1,67 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "c_array.h"
+#include "name_map.h"
+
+#define CAMPAIGN_INDEX_FILE "campaigns.json"
+
+// Persistent index of the scanned titles and mission counts of campaigns,
+// so that listing the campaigns doesn't need to read every campaign file.
+// Entries are keyed by path, and only used while the file's size and
+// modification time are unchanged. Files that aren't campaigns are indexed
+// too, so that they aren't scanned again either.
+typedef struct
+{
+	char *Path;
+	long long Size;
+	long long Mtime;
+	bool IsCampaign;
+	char *Title;
+	int NumMissions;
+	bool isUsed;
+} CampaignIndexEntry;
+typedef struct
+{
+	CArray Entries;	// of CampaignIndexEntry
+	NameMap byPath;
+	bool isChanged;
+} CampaignIndex;
+
+void CampaignIndexLoad(CampaignIndex *ci, const char *filename);
+// Save the index if it has changed, dropping entries that weren't used
+void CampaignIndexSave(CampaignIndex *ci, const char *filename);
+void CampaignIndexTerminate(CampaignIndex *ci);
+
+// Scan a campaign like MapNewScan, using the index if it is unchanged
+// Returns whether the file is a campaign; allocates title
+bool CampaignIndexScan(
+	CampaignIndex *ci, const char *path, char **title, int *numMissions);
@@ -32,6 +32,7 @@
 
 #include <tinydir/tinydir.h>
 
+#include <cdogs/campaign_index.h>
 #include <cdogs/files.h>
 #include <cdogs/log.h>
 #include <cdogs/map_new.h>
@@ -74,7 +75,7 @@ static void CampaignListInit(campaign_list_t *list);
 static void CampaignListTerminate(campaign_list_t *list);
 static void LoadCampaignsFromFolder(
 	campaign_list_t *list, const char *name, const char *path,
-	const GameMode mode);
+	const GameMode mode, CampaignIndex *index);
 static void LoadQuickPlayEntry(CampaignEntry *entry);
 
 void LoadAllCampaigns(custom_campaigns_t *campaigns)
@@ -83,6 +84,8 @@ void LoadAllCampaigns(custom_campaigns_t *campaigns)
 
 	CampaignListInit(&campaigns->campaignList);
 	CampaignListInit(&campaigns->dogfightList);
+	CampaignIndex index;
+	CampaignIndexLoad(&index, GetConfigFilePath(CAMPAIGN_INDEX_FILE));
 
 	LOG(LM_MAIN, LL_INFO, "Load campaigns");
 	GetDataFilePath(buf, CDOGS_CAMPAIGN_DIR);
@@ -90,7 +93,8 @@ void LoadAllCampaigns(custom_campaigns_t *campaigns)
 		&campaigns->campaignList,
 		"",
 		buf,
-		GAME_MODE_NORMAL);
+		GAME_MODE_NORMAL,
+		&index);
 
 	LOG(LM_MAIN, LL_INFO, "Load dogfights");
 	GetDataFilePath(buf, CDOGS_DOGFIGHT_DIR);
@@ -98,7 +102,11 @@ void LoadAllCampaigns(custom_campaigns_t *campaigns)
 		&campaigns->dogfightList,
 		"",
 		buf,
-		GAME_MODE_DOGFIGHT);
+		GAME_MODE_DOGFIGHT,
+		&index);
+
+	CampaignIndexSave(&index, GetConfigFilePath(CAMPAIGN_INDEX_FILE));
+	CampaignIndexTerminate(&index);
 
 	debug(D_NORMAL, "Load quick play\n");
 	LoadQuickPlayEntry(&campaigns->quickPlayEntry);
@@ -145,7 +153,7 @@ static void LoadQuickPlayEntry(CampaignEntry *entry)
 
 static void LoadCampaignsFromFolder(
 	campaign_list_t *list, const char *name, const char *path,
-	const GameMode mode)
+	const GameMode mode, CampaignIndex *index)
 {
 	tinydir_dir dir;
 	int i;
@@ -173,15 +181,21 @@ static void LoadCampaignsFromFolder(
 		{
 			campaign_list_t subFolder;
 			CampaignListInit(&subFolder);
-			LoadCampaignsFromFolder(&subFolder, file.name, file.path, mode);
+			LoadCampaignsFromFolder(
+				&subFolder, file.name, file.path, mode, index);
 			CArrayPushBack(&list->subFolders, &subFolder);
 		}
 		else if ((file.is_reg || isArchive) && file.name[0] != '~')
 		{
-			CampaignEntry entry;
-			if (CampaignEntryTryLoad(&entry, file.path, mode))
+			char *title;
+			int numMissions;
+			if (CampaignIndexScan(index, file.path, &title, &numMissions))
 			{
+				CampaignEntry entry;
+				CampaignEntryInitScanned(
+					&entry, file.path, mode, title, numMissions);
 				CArrayPushBack(&list->list, &entry);
+				CFREE(title);
 			}
 		}
 	}
@@ -223,8 +223,11 @@ bool CollisionIsOnSameTeam(
 		!isPVP;
 }
 
-void CollideTileItems(
-	const TTileItem *item, const Vec2i pos,
+// Visit all TTileItem that overlap an area, in the 3x3 tiles around it
+// The broad phase uses the map's collision proxies so that most items are
+// rejected by their bounds without being looked up
+static void OverlapTileItems(
+	const TTileItem *item, const Vec2i pos, const Vec2i size,
 	const int mask, const CollisionTeam team, const bool isPVP,
 	CollideItemFunc func, void *data)
 {
@@ -240,16 +243,20 @@ void CollideTileItems(
 			{
 				continue;
 			}
-			CArray *tileThings = &MapGetTile(&gMap, dtv)->things;
-			for (int i = 0; i < (int)tileThings->size; i++)
+			const CArray *cell = CArrayGet(
+				&gMap.CollisionCells, dtv.y * gMap.Size.x + dtv.x);
+			// Note: callbacks can add or remove items, so re-check the size
+			for (int i = 0; i < (int)cell->size; i++)
 			{
-				TTileItem *ti = ThingIdGetTileItem(CArrayGet(tileThings, i));
+				const CollisionProxy *cp =
+					(const CollisionProxy *)cell->data + i;
+				if (!AreasCollide(pos, cp->Pos, size, cp->Size)) continue;
+				TTileItem *ti = ThingIdGetTileItem(&cp->Id);
 				// Don't collide if items are on the same team
 				if (CollisionIsOnSameTeam(ti, team, isPVP)) continue;
 				// No same-item collision
 				if (item == ti) continue;
 				if (mask != 0 && !(ti->flags & mask)) continue;
-				if (!ItemsCollide(item, ti, pos)) continue;
 				// Collision callback and check continue
 				if (!func(ti, data))
 				{
@@ -259,17 +266,46 @@ void CollideTileItems(
 		}
 	}
 }
-static bool CollideGetFirstItemCallback(TTileItem *ti, void *data);
+
+typedef struct
+{
+	const TTileItem *Item;
+	Vec2i Pos;
+	CollideItemFunc Func;
+	void *Data;
+} CollideTileItemsData;
+static bool CollideTileItemsCallback(TTileItem *ti, void *data);
+void CollideTileItems(
+	const TTileItem *item, const Vec2i pos,
+	const int mask, const CollisionTeam team, const bool isPVP,
+	CollideItemFunc func, void *data)
+{
+	CollideTileItemsData cData;
+	cData.Item = item;
+	cData.Pos = pos;
+	cData.Func = func;
+	cData.Data = data;
+	OverlapTileItems(
+		item, pos, item->size, mask, team, isPVP,
+		CollideTileItemsCallback, &cData);
+}
+static bool CollideTileItemsCallback(TTileItem *ti, void *data)
+{
+	CollideTileItemsData *cData = data;
+	if (!ItemsCollide(cData->Item, ti, cData->Pos)) return true;
+	return cData->Func(ti, cData->Data);
+}
+static bool GetFirstItemCallback(TTileItem *ti, void *data);
 TTileItem *CollideGetFirstItem(
 	const TTileItem *item, const Vec2i pos,
 	const int mask, const CollisionTeam team, const bool isPVP)
 {
 	TTileItem *firstItem = NULL;
 	CollideTileItems(
-		item, pos, mask, team, isPVP, CollideGetFirstItemCallback, &firstItem);
+		item, pos, mask, team, isPVP, GetFirstItemCallback, &firstItem);
 	return firstItem;
 }
-static bool CollideGetFirstItemCallback(TTileItem *ti, void *data)
+static bool GetFirstItemCallback(TTileItem *ti, void *data)
 {
 	TTileItem **pFirstItem = data;
 	// Store the first item in custom data and return
@@ -277,42 +313,14 @@ static bool CollideGetFirstItemCallback(TTileItem *ti, void *data)
 	return false;
 }
 
-// TODO: refactor with Collide functions
 TTileItem *OverlapGetFirstItem(
 	const TTileItem *item, const Vec2i pos, const Vec2i size,
 	const int mask, const CollisionTeam team, const bool isPVP)
 {
-	const Vec2i tv = Vec2iToTile(pos);
-	Vec2i dv;
-	// Check collisions with all other items on this tile, in all 8 directions
-	for (dv.y = -1; dv.y <= 1; dv.y++)
-	{
-		for (dv.x = -1; dv.x <= 1; dv.x++)
-		{
-			const Vec2i dtv = Vec2iAdd(tv, dv);
-			if (!MapIsTileIn(&gMap, dtv))
-			{
-				continue;
-			}
-			CArray *tileThings = &MapGetTile(&gMap, dtv)->things;
-			for (int i = 0; i < (int)tileThings->size; i++)
-			{
-				TTileItem *ti = ThingIdGetTileItem(CArrayGet(tileThings, i));
-				// Don't collide if items are on the same team
-				if (CollisionIsOnSameTeam(ti, team, isPVP)) continue;
-				// No same-item collision
-				if (item == ti) continue;
-				if (mask != 0 && !(ti->flags & mask)) continue;
-				if (!AreasCollide(pos, Vec2iNew(ti->x, ti->y), size, ti->size))
-				{
-					continue;
-				}
-				// Overlaps
-				return ti;
-			}
-		}
-	}
-	return NULL;
+	TTileItem *firstItem = NULL;
+	OverlapTileItems(
+		item, pos, size, mask, team, isPVP, GetFirstItemCallback, &firstItem);
+	return firstItem;
 }
 
 Vec2i GetWallBounceFullPos(
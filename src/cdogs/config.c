@@ -216,6 +216,9 @@ int StrQuickPlayQuantity(const char *s)
 
 
 Config gConfig;
+// Bumped whenever a config tree is created or destroyed, so that
+// ConfigHandles know to re-resolve their cached pointers
+static int sConfigGeneration = 0;
 
 static Config ConfigNew(const char *name, const ConfigType type);
 Config ConfigNewString(const char *name, const char *defaultValue)
@@ -289,6 +292,7 @@ static Config ConfigNew(const char *name, const ConfigType type)
 
 void ConfigDestroy(Config *c)
 {
+	sConfigGeneration++;
 	CFREE(c->Name);
 	if (c->Type == CONFIG_TYPE_GROUP)
 	{
@@ -513,8 +517,43 @@ CArray *ConfigGetGroup(Config *c, const char *name)
 	return &c->u.Group;
 }
 
+Config *ConfigHandleGet(ConfigHandle *h)
+{
+	if (h->generation != sConfigGeneration)
+	{
+		h->c = ConfigGet(&gConfig, h->Name);
+		h->generation = sConfigGeneration;
+	}
+	return h->c;
+}
+int ConfigHandleGetInt(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_INT, "wrong config type");
+	return c->u.Int.Value;
+}
+double ConfigHandleGetFloat(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_FLOAT, "wrong config type");
+	return c->u.Float.Value;
+}
+bool ConfigHandleGetBool(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_BOOL, "wrong config type");
+	return c->u.Bool.Value;
+}
+int ConfigHandleGetEnum(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_ENUM, "wrong config type");
+	return c->u.Enum.Value;
+}
+
 Config ConfigDefault(void)
 {
+	sConfigGeneration++;
 	Config root = ConfigNewGroup(NULL);
 	
 	Config game = ConfigNewGroup("Game");
@@ -646,6 +685,14 @@ Config ConfigDefault(void)
 	ConfigGroupAdd(&snd, ConfigNewBool("Footsteps", true));
 	ConfigGroupAdd(&snd, ConfigNewBool("Hits", true));
 	ConfigGroupAdd(&snd, ConfigNewBool("Reloads", true));
+	// Memory for decoded sounds, in MB
+	ConfigGroupAdd(&snd, ConfigNewInt("CacheSize",
+#ifdef __GCWZERO__
+		8
+#else
+		64
+#endif
+		, 0, 0, 0, NULL, NULL));
 	ConfigGroupAdd(&root, snd);
 
 	Config qp = ConfigNewGroup("QuickPlay");
@@ -225,5 +225,31 @@ bool ConfigGetBool(Config *c, const char *name);
 int ConfigGetEnum(Config *c, const char *name);
 CArray *ConfigGetGroup(Config *c, const char *name);
 
+// Compiled handle to an entry in gConfig
+// The dot-separated name is resolved once and then read through the cached
+// pointer, so per-frame code avoids the string walk in ConfigGet.
+// Handles re-resolve themselves whenever gConfig is rebuilt.
+// Usage:
+// static ConfigHandle sFoo = CONFIG_HANDLE("Foo.Bar");
+// ... ConfigHandleGetInt(&sFoo) ...
+typedef struct
+{
+	const char *Name;
+	Config *c;
+	int generation;
+} ConfigHandle;
+#define CONFIG_HANDLE(_name) { _name, NULL, -1 }
+Config *ConfigHandleGet(ConfigHandle *h);
+int ConfigHandleGetInt(ConfigHandle *h);
+double ConfigHandleGetFloat(ConfigHandle *h);
+bool ConfigHandleGetBool(ConfigHandle *h);
+int ConfigHandleGetEnum(ConfigHandle *h);
+
 bool ConfigApply(Config *config);
+// Listeners are called by ConfigApply, before the changes are committed,
+// so modules that cache config-derived values can refresh them
+// Use ConfigChanged on the relevant sub-config to filter changes
+typedef void (*ConfigApplyFunc)(Config *, void *);
+void ConfigAddApplyListener(ConfigApplyFunc func, void *data);
+void ConfigRemoveApplyListener(ConfigApplyFunc func, void *data);
 int ConfigGetVersion(FILE *f);
@@ -35,6 +35,35 @@
 #include "pic_manager.h"
 
 
+typedef struct
+{
+	ConfigApplyFunc Func;
+	void *Data;
+} ConfigApplyListener;
+static CArray sApplyListeners;	// of ConfigApplyListener
+
+void ConfigAddApplyListener(ConfigApplyFunc func, void *data)
+{
+	if (sApplyListeners.elemSize == 0)
+	{
+		CArrayInit(&sApplyListeners, sizeof(ConfigApplyListener));
+	}
+	ConfigApplyListener l;
+	l.Func = func;
+	l.Data = data;
+	CArrayPushBack(&sApplyListeners, &l);
+}
+void ConfigRemoveApplyListener(ConfigApplyFunc func, void *data)
+{
+	CA_FOREACH(const ConfigApplyListener, l, sApplyListeners)
+		if (l->Func == func && l->Data == data)
+		{
+			CArrayDelete(&sApplyListeners, i);
+			return;
+		}
+	CA_FOREACH_END()
+}
+
 bool ConfigApply(Config *config)
 {
 	gCampaign.seed = ConfigGetInt(config, "Game.RandomSeed");
@@ -50,6 +79,9 @@ bool ConfigApply(Config *config)
 		GrafxMakeRandomBackground(
 			&gGraphicsDevice, &gCampaign, &gMission, &gMap);
 	}
+	CA_FOREACH(const ConfigApplyListener, l, sApplyListeners)
+		l->Func(config, l->Data);
+	CA_FOREACH_END()
 	ConfigSetChanged(config);
 	return gGraphicsDevice.IsInitialized;
 }
@@ -0,0 +1,100 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "display_list.h"
+
+#include <string.h>
+
+
+void DisplayListInit(DisplayList *l)
+{
+	CArrayInit(&l->Items, sizeof(DisplayListItem));
+	CArrayInit(&l->sortBuf, sizeof(DisplayListItem));
+}
+void DisplayListTerminate(DisplayList *l)
+{
+	CArrayTerminate(&l->Items);
+	CArrayTerminate(&l->sortBuf);
+}
+
+void DisplayListClear(DisplayList *l)
+{
+	CArrayClear(&l->Items);
+}
+void DisplayListAdd(DisplayList *l, const TTileItem *item, const Uint32 key)
+{
+	const DisplayListItem dli = { item, key };
+	CArrayPushBack(&l->Items, &dli);
+}
+
+// LSD radix sort, one byte of the key at a time
+// Bytes that are the same for every item are skipped; in practice only
+// one or two passes are needed.
+void DisplayListSort(DisplayList *l)
+{
+	const int n = (int)l->Items.size;
+	if (n < 2)
+	{
+		return;
+	}
+	CArrayResize(&l->sortBuf, n, NULL);
+	int counts[4][256];
+	memset(counts, 0, sizeof counts);
+	const DisplayListItem *items = l->Items.data;
+	for (int i = 0; i < n; i++)
+	{
+		for (int b = 0; b < 4; b++)
+		{
+			counts[b][(items[i].Key >> (b * 8)) & 0xFF]++;
+		}
+	}
+	for (int b = 0; b < 4; b++)
+	{
+		const int shift = b * 8;
+		const DisplayListItem *src = l->Items.data;
+		if (counts[b][(src[0].Key >> shift) & 0xFF] == n)
+		{
+			continue;
+		}
+		// Turn the counts into start offsets, then scatter
+		int offset = 0;
+		for (int d = 0; d < 256; d++)
+		{
+			const int count = counts[b][d];
+			counts[b][d] = offset;
+			offset += count;
+		}
+		DisplayListItem *dst = l->sortBuf.data;
+		for (int i = 0; i < n; i++)
+		{
+			dst[counts[b][(src[i].Key >> shift) & 0xFF]++] = src[i];
+		}
+		const CArray tmp = l->Items;
+		l->Items = l->sortBuf;
+		l->sortBuf = tmp;
+	}
+}
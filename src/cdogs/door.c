@@ -49,6 +49,7 @@
 #include "door.h"
 
 #include "gamedata.h"
+#include "net_assets.h"
 #include "net_util.h"
 
 
@@ -63,7 +64,7 @@ static NamedPic *GetDoorBasePic(
 static TWatch *CreateCloseDoorWatch(
 	Map *map, const Mission *m, const Vec2i v,
 	const bool isHorizontal, const int doorGroupCount,
-	const char *picAltName, const int floor, const int room);
+	const NamedPic *picAlt, const int floor, const int room);
 static Trigger *CreateOpenDoorTrigger(
 	Map *map, const Mission *m, const Vec2i v,
 	const bool isHorizontal, const int doorGroupCount,
@@ -125,7 +126,7 @@ void MapAddDoorGroup(
 	}
 
 	TWatch *w = CreateCloseDoorWatch(
-		map, m, v, isHorizontal, doorGroupCount, doorPic->name, floor, room);
+		map, m, v, isHorizontal, doorGroupCount, doorPic, floor, room);
 	Trigger *t = CreateOpenDoorTrigger(
 		map, m, v, isHorizontal, doorGroupCount,
 		floor, room, keyFlags);
@@ -170,7 +171,7 @@ static int GetDoorCountInGroup(
 static TWatch *CreateCloseDoorWatch(
 	Map *map, const Mission *m, const Vec2i v,
 	const bool isHorizontal, const int doorGroupCount,
-	const char *picAltName, const int floor, const int room)
+	const NamedPic *picAlt, const int floor, const int room)
 {
 	TWatch *w = WatchNew();
 	const Vec2i dv = Vec2iNew(isHorizontal ? 1 : 0, isHorizontal ? 0 : 1);
@@ -213,10 +214,9 @@ static TWatch *CreateCloseDoorWatch(
 		a->a.Event = GameEventNew(GAME_EVENT_TILE_SET);
 		a->a.Event.u.TileSet.Pos = Vec2i2Net(vI);
 		a->a.Event.u.TileSet.Flags = DOOR_TILE_FLAGS;
-		strcpy(
-			a->a.Event.u.TileSet.PicName,
-			GetDoorBasePic(&gPicManager, m->DoorStyle, isHorizontal)->name);
-		strcpy(a->a.Event.u.TileSet.PicAltName, picAltName);
+		a->a.Event.u.TileSet.PicId = NetAssetsPicId(
+			GetDoorBasePic(&gPicManager, m->DoorStyle, isHorizontal));
+		a->a.Event.u.TileSet.PicAltId = NetAssetsPicId(picAlt);
 	}
 
 	// Add shadows below doors
@@ -232,15 +232,15 @@ static TWatch *CreateCloseDoorWatch(
 			const Vec2i vI2 = Vec2iNew(vI.x + dAside.x, vI.y + dAside.y);
 			a->a.Event.u.TileSet.Pos = Vec2i2Net(vI2);
 			const bool isFloor = IMapGet(map, vI2) == MAP_FLOOR;
-			strcpy(
-				a->a.Event.u.TileSet.PicName,
+			a->a.Event.u.TileSet.PicId = NetAssetsPicId(
 				PicManagerGetMaskedStylePic(
 					&gPicManager,
 					isFloor ? "floor" : "room",
 					isFloor ? floor : room,
 					isFloor ? FLOOR_SHADOW : ROOMFLOOR_SHADOW,
 					isFloor ? m->FloorMask : m->RoomMask,
-					m->AltMask)->name);
+					m->AltMask));
+			a->a.Event.u.TileSet.PicAltId = -1;
 		}
 	}
 
@@ -274,15 +274,14 @@ static Trigger *CreateOpenDoorTrigger(
 		a->a.Event.u.TileSet.Pos = Vec2i2Net(vI);
 		a->a.Event.u.TileSet.Flags =
 			(isHorizontal || i > 0) ? 0 : MAPTILE_OFFSET_PIC;
-		strcpy(
-			a->a.Event.u.TileSet.PicName,
-			GetDoorBasePic(&gPicManager, m->DoorStyle, isHorizontal)->name);
+		a->a.Event.u.TileSet.PicId = NetAssetsPicId(
+			GetDoorBasePic(&gPicManager, m->DoorStyle, isHorizontal));
+		a->a.Event.u.TileSet.PicAltId = -1;
 		if (!isHorizontal && i == 0)
 		{
 			// special door cavity picture
-			strcpy(
-				a->a.Event.u.TileSet.PicAltName,
-				GetDoorPic(&gPicManager, m->DoorStyle, "wall", false)->name);
+			a->a.Event.u.TileSet.PicAltId = NetAssetsPicId(
+				GetDoorPic(&gPicManager, m->DoorStyle, "wall", false));
 		}
 	}
 
@@ -299,15 +298,15 @@ static Trigger *CreateOpenDoorTrigger(
 			a->a.Event = GameEventNew(GAME_EVENT_TILE_SET);
 			const bool isFloor = IMapGet(map, vIAside) == MAP_FLOOR;
 			a->a.Event.u.TileSet.Pos = Vec2i2Net(vIAside);
-			strcpy(
-				a->a.Event.u.TileSet.PicName,
+			a->a.Event.u.TileSet.PicId = NetAssetsPicId(
 				PicManagerGetMaskedStylePic(
 					&gPicManager,
 					isFloor ? "floor" : "room",
 					isFloor? floor : room,
 					isFloor ? FLOOR_NORMAL : ROOMFLOOR_NORMAL,
 					isFloor ? m->FloorMask : m->RoomMask,
-					m->AltMask)->name);
+					m->AltMask));
+			a->a.Event.u.TileSet.PicAltId = -1;
 		}
 	}
 
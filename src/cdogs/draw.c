@@ -55,6 +55,7 @@
 #include "algorithms.h"
 #include "config.h"
 #include "drawtools.h"
+#include "floor_cache.h"
 #include "font.h"
 #include "game_events.h"
 #include "net_util.h"
@@ -62,8 +63,13 @@
 #include "pics.h"
 #include "draw.h"
 #include "blit.h"
+#include "blit_kernels.h"
 #include "pic_manager.h"
 
+static ConfigHandle sConfigFog = CONFIG_HANDLE("Game.Fog");
+static ConfigHandle sConfigLaserSight = CONFIG_HANDLE("Game.LaserSight");
+static ConfigHandle sConfigFPS = CONFIG_HANDLE("Game.FPS");
+
 //#define DEBUG_DRAW_BOUNDS
 
 
@@ -71,15 +77,15 @@
 // Unvisited: black
 // Out of sight: dark, or if fog disabled, black
 // In sight: full color
-static color_t GetTileLOSMask(Tile *tile)
+static color_t GetTileLOSMask(const Tile *tile, const Uint8 drawFlags)
 {
 	if (!tile->isVisited)
 	{
 		return colorBlack;
 	}
-	if (tile->flags & MAPTILE_OUT_OF_SIGHT)
+	if (drawFlags & DRAW_TILE_OUT_OF_SIGHT)
 	{
-		if (ConfigGetBool(&gConfig, "Game.Fog"))
+		if (ConfigHandleGetBool(&sConfigFog))
 		{
 			color_t mask = { 96, 96, 96, 255 };
 			return mask;
@@ -92,18 +98,20 @@ static color_t GetTileLOSMask(Tile *tile)
 	return colorWhite;
 }
 
-void DrawWallColumn(int y, Vec2i pos, Tile *tile)
+// Draw the wall at buffer tile index i, and the walls above it
+static void DrawWallColumn(
+	const DrawBuffer *b, int y, Vec2i pos, int i)
 {
-	while (y >= 0 && (tile->flags & MAPTILE_IS_WALL))
+	while (y >= 0 && (b->tiles[i]->flags & MAPTILE_IS_WALL))
 	{
 		BlitMasked(
 			&gGraphicsDevice,
-			&tile->pic->pic,
+			&b->tiles[i]->pic->pic,
 			pos,
-			GetTileLOSMask(tile),
+			GetTileLOSMask(b->tiles[i], b->tileFlags[i]),
 			0);
 		pos.y -= TILE_HEIGHT;
-		tile -= X_TILES;
+		i -= b->OrigSize.x;
 		y--;
 	}
 }
@@ -120,7 +128,8 @@ void DrawBufferDraw(DrawBuffer *b, Vec2i offset, GrafxDrawExtra *extra)
 {
 	// First draw the floor tiles (which do not obstruct anything)
 	DrawFloor(b, offset);
-	// Then draw debris (wrecks)
+	// Then draw debris (wrecks), after sorting everything in sight
+	DrawBufferMakeDisplayList(b);
 	DrawDebris(b, offset);
 	// Now draw walls and (non-wreck) things in proper order
 	DrawWallsAndThings(b, offset);
@@ -135,31 +144,64 @@ void DrawBufferDraw(DrawBuffer *b, Vec2i offset, GrafxDrawExtra *extra)
 	}
 }
 
+// Draw a run of tiles from the floor layer, masked for line of sight
+static void DrawFloorRun(
+	GraphicsDevice *g, const Uint32 *src, const Vec2i pos, const int n,
+	const color_t mask)
+{
+	const int x0 = MAX(pos.x, g->clipping.left);
+	const int x1 = MIN(pos.x + n * TILE_WIDTH - 1, g->clipping.right);
+	const int y0 = MAX(pos.y, g->clipping.top);
+	const int y1 = MIN(pos.y + TILE_HEIGHT - 1, g->clipping.bottom);
+	const bool isUnmasked = ColorEquals(mask, colorWhite);
+	for (int y = y0; x0 <= x1 && y <= y1; y++)
+	{
+		Uint32 *dst = g->buf + y * g->cachedConfig.Res.x + x0;
+		const Uint32 *srcRow =
+			src + (y - pos.y) * FLOOR_CACHE_STRIDE + x0 - pos.x;
+		if (isUnmasked)
+		{
+			memcpy(dst, srcRow, (x1 - x0 + 1) * sizeof *dst);
+		}
+		else
+		{
+			BlitRowMult(dst, srcRow, x1 - x0 + 1, COLOR2PIXEL(mask), false);
+		}
+	}
+}
 static void DrawFloor(DrawBuffer *b, Vec2i offset)
 {
-	int x, y;
 	Vec2i pos;
-	Tile *tile = &b->tiles[0][0];
-	for (y = 0, pos.y = b->dy + offset.y;
-		 y < Y_TILES;
-		 y++, pos.y += TILE_HEIGHT)
-	{
-		for (x = 0, pos.x = b->dx + offset.x;
-			x < b->Size.x;
-			x++, tile++, pos.x += TILE_WIDTH)
+	pos.y = b->dy + offset.y;
+	for (int y = 0; y < b->Size.y; y++, pos.y += TILE_HEIGHT)
+	{
+		const Tile **tile = b->tiles + y * b->OrigSize.x;
+		const Uint8 *flags = b->tileFlags + y * b->OrigSize.x;
+		// Draw runs of tiles with the same mask in one go, stopping at the
+		// edges of floor layer chunks
+		for (int x = 0; x < b->Size.x;)
 		{
-			if (tile->pic != NULL && tile->pic->pic.Data != NULL &&
-				!(tile->flags & MAPTILE_IS_WALL))
+			if (!FloorCacheHasTile(tile[x]))
 			{
-				BlitMasked(
-					&gGraphicsDevice,
-					&tile->pic->pic,
-					pos,
-					GetTileLOSMask(tile),
-					0);
+				x++;
+				continue;
 			}
+			const Vec2i mapTile = Vec2iNew(b->xStart + x, b->yStart + y);
+			const color_t mask = GetTileLOSMask(tile[x], flags[x]);
+			int n = 1;
+			while (x + n < b->Size.x &&
+				(mapTile.x + n) % FLOOR_CACHE_CHUNK_SIZE != 0 &&
+				FloorCacheHasTile(tile[x + n]) &&
+				ColorEquals(GetTileLOSMask(tile[x + n], flags[x + n]), mask))
+			{
+				n++;
+			}
+			pos.x = b->dx + offset.x + x * TILE_WIDTH;
+			DrawFloorRun(
+				&gGraphicsDevice, FloorCacheGetTile(&gMap, mapTile), pos, n,
+				mask);
+			x += n;
 		}
-		tile += X_TILES - b->Size.x;
 	}
 }
 
@@ -167,53 +209,33 @@ static void DrawThing(DrawBuffer *b, const TTileItem *t, const Vec2i offset);
 
 static void DrawDebris(DrawBuffer *b, Vec2i offset)
 {
-	Tile *tile = &b->tiles[0][0];
-	for (int y = 0; y < Y_TILES; y++)
+	for (int i = 0; i < b->numDebris; i++)
 	{
-		CArrayClear(&b->displaylist);
-		for (int x = 0; x < b->Size.x; x++, tile++)
-		{
-			if (tile->flags & MAPTILE_OUT_OF_SIGHT)
-			{
-				continue;
-			}
-			for (int i = 0; i < (int)tile->things.size; i++)
-			{
-				const TTileItem *ti =
-					ThingIdGetTileItem(CArrayGet(&tile->things, i));
-				if (TileItemIsDebris(ti))
-				{
-					CArrayPushBack(&b->displaylist, &ti);
-				}
-			}
-		}
-		DrawBufferSortDisplayList(b);
-		for (int i = 0; i < (int)b->displaylist.size; i++)
-		{
-			const TTileItem **tp = CArrayGet(&b->displaylist, i);
-			const TTileItem *t = *tp;
-			DrawThing(b, t, offset);
-		}
-		tile += X_TILES - b->Size.x;
+		const DisplayListItem *dli = CArrayGet(&b->displaylist.Items, i);
+		DrawThing(b, dli->Item, offset);
 	}
 }
 
 static void DrawWallsAndThings(DrawBuffer *b, Vec2i offset)
 {
 	Vec2i pos;
-	Tile *tile = &b->tiles[0][0];
 	pos.y = b->dy + cWallOffset.dy + offset.y;
-	for (int y = 0; y < Y_TILES; y++, pos.y += TILE_HEIGHT)
+	int next = b->numDebris;
+	for (int y = 0; y < b->Size.y; y++, pos.y += TILE_HEIGHT)
 	{
-		CArrayClear(&b->displaylist);
 		pos.x = b->dx + cWallOffset.dx + offset.x;
-		for (int x = 0; x < b->Size.x; x++, tile++, pos.x += TILE_WIDTH)
+		for (int x = 0; x < b->Size.x; x++, pos.x += TILE_WIDTH)
 		{
+			const int idx = y * b->OrigSize.x + x;
+			const Tile *tile = b->tiles[idx];
 			if (tile->flags & MAPTILE_IS_WALL)
 			{
-				if (!(tile->flags & MAPTILE_DELAY_DRAW))
+				// Columns that continue below the buffer are drawn from
+				// its bottom row
+				if (!(tile->flags & MAPTILE_DELAY_DRAW) ||
+					y == b->Size.y - 1)
 				{
-					DrawWallColumn(y, pos, tile);
+					DrawWallColumn(b, y, pos, idx);
 				}
 			}
 			else if (tile->flags & MAPTILE_OFFSET_PIC)
@@ -232,34 +254,22 @@ static void DrawWallsAndThings(DrawBuffer *b, Vec2i offset)
 					&gGraphicsDevice,
 					&tile->picAlt->pic,
 					doorPos,
-					GetTileLOSMask(tile),
+					GetTileLOSMask(tile, b->tileFlags[idx]),
 					0);
 			}
+		}
 
-			// Draw the items that are in LOS
-			if (tile->flags & MAPTILE_OUT_OF_SIGHT)
-			{
-				continue;
-			}
-			for (int i = 0; i < (int)tile->things.size; i++)
+		// Then the things in this row
+		for (; next < (int)b->displaylist.Items.size; next++)
+		{
+			const DisplayListItem *dli =
+				CArrayGet(&b->displaylist.Items, next);
+			if (DRAW_BUFFER_KEY_ROW(dli->Key) != y)
 			{
-				const TTileItem *ti =
-					ThingIdGetTileItem(CArrayGet(&tile->things, i));
-				// Don't draw debris, they are drawn later
-				if (TileItemIsDebris(ti))
-				{
-					continue;
-				}
-				CArrayPushBack(&b->displaylist, &ti);
+				break;
 			}
+			DrawThing(b, dli->Item, offset);
 		}
-		DrawBufferSortDisplayList(b);
-		for (int i = 0; i < (int)b->displaylist.size; i++)
-		{
-			const TTileItem **tp = CArrayGet(&b->displaylist, i);
-			DrawThing(b, *tp, offset);
-		}
-		tile += X_TILES - b->Size.x;
 	}
 }
 static void DrawActorPics(const TTileItem *t, const Vec2i picPos);
@@ -369,8 +379,8 @@ static void DrawActorPics(const TTileItem *t, const Vec2i picPos)
 		const TActor *a = CArrayGet(&gActors, t->id);
 
 		// Draw weapon indicators
-		if (ConfigGetEnum(&gConfig, "Game.LaserSight") == LASER_SIGHT_ALL ||
-			(ConfigGetEnum(&gConfig, "Game.LaserSight") == LASER_SIGHT_PLAYERS && a->PlayerUID >= 0))
+		if (ConfigHandleGetEnum(&sConfigLaserSight) == LASER_SIGHT_ALL ||
+			(ConfigHandleGetEnum(&sConfigLaserSight) == LASER_SIGHT_PLAYERS && a->PlayerUID >= 0))
 		{
 			DrawLaserSight(a, picPos);
 		}
@@ -414,27 +424,27 @@ static void DrawLaserSightSingle(
 }
 
 static void DrawObjectiveHighlight(
-	TTileItem *ti, Tile *tile, DrawBuffer *b, Vec2i offset);
+	TTileItem *ti, const Uint8 drawFlags, DrawBuffer *b, Vec2i offset);
 static void DrawObjectiveHighlights(DrawBuffer *b, Vec2i offset)
 {
-	Tile *tile = &b->tiles[0][0];
-	for (int y = 0; y < Y_TILES; y++)
+	for (int y = 0; y < b->Size.y; y++)
 	{
-		for (int x = 0; x < b->Size.x; x++, tile++)
+		for (int x = 0; x < b->Size.x; x++)
 		{
+			const int idx = y * b->OrigSize.x + x;
+			const Tile *tile = b->tiles[idx];
 			// Draw the items that are in LOS
 			for (int i = 0; i < (int)tile->things.size; i++)
 			{
 				TTileItem *ti =
 					ThingIdGetTileItem(CArrayGet(&tile->things, i));
-				DrawObjectiveHighlight(ti, tile, b, offset);
+				DrawObjectiveHighlight(ti, b->tileFlags[idx], b, offset);
 			}
 		}
-		tile += X_TILES - b->Size.x;
 	}
 }
 static void DrawObjectiveHighlight(
-	TTileItem *ti, Tile *tile, DrawBuffer *b, Vec2i offset)
+	TTileItem *ti, const Uint8 drawFlags, DrawBuffer *b, Vec2i offset)
 {
 	if (!(ti->flags & TILEITEM_OBJECTIVE))
 	{
@@ -448,7 +458,7 @@ static void DrawObjectiveHighlight(
 		return;
 	}
 	if (!(mo->Flags & OBJECTIVE_POSKNOWN) &&
-		(tile->flags & MAPTILE_OUT_OF_SIGHT))
+		(drawFlags & DRAW_TILE_OUT_OF_SIGHT))
 	{
 		return;
 	}
@@ -456,7 +466,7 @@ static void DrawObjectiveHighlight(
 		ti->x - b->xTop + offset.x, ti->y - b->yTop + offset.y);
 	const ObjectiveDef *o = CArrayGet(&gMission.Objectives, objective);
 	color_t color = o->color;
-	const int pulsePeriod = ConfigGetInt(&gConfig, "Game.FPS");
+	const int pulsePeriod = ConfigHandleGetInt(&sConfigFPS);
 	int alphaUnscaled =
 		(gMission.time % pulsePeriod) * 255 / (pulsePeriod / 2);
 	if (alphaUnscaled > 255)
@@ -494,11 +504,11 @@ static void DrawChatter(
 	const TTileItem *ti, DrawBuffer *b, const Vec2i offset);
 static void DrawChatters(DrawBuffer *b, Vec2i offset)
 {
-	const Tile *tile = &b->tiles[0][0];
-	for (int y = 0; y < Y_TILES; y++)
+	for (int y = 0; y < b->Size.y; y++)
 	{
-		for (int x = 0; x < b->Size.x; x++, tile++)
+		for (int x = 0; x < b->Size.x; x++)
 		{
+			const Tile *tile = b->tiles[y * b->OrigSize.x + x];
 			for (int i = 0; i < (int)tile->things.size; i++)
 			{
 				const TTileItem *ti =
@@ -510,7 +520,6 @@ static void DrawChatters(DrawBuffer *b, Vec2i offset)
 				DrawChatter(ti, b, offset);
 			}
 		}
-		tile += X_TILES - b->Size.x;
 	}
 }
 static void DrawChatter(
@@ -666,12 +675,11 @@ static void DrawExtra(DrawBuffer *b, Vec2i offset, GrafxDrawExtra *extra)
 static void DrawEditorTiles(DrawBuffer *b, Vec2i offset)
 {
 	Vec2i pos;
-	Tile *tile = &b->tiles[0][0];
 	pos.y = b->dy + offset.y;
-	for (int y = 0; y < Y_TILES; y++, pos.y += TILE_HEIGHT)
+	for (int y = 0; y < b->Size.y; y++, pos.y += TILE_HEIGHT)
 	{
 		pos.x = b->dx + offset.x;
-		for (int x = 0; x < b->Size.x; x++, tile++, pos.x += TILE_WIDTH)
+		for (int x = 0; x < b->Size.x; x++, pos.x += TILE_WIDTH)
 		{
 			if (gMission.missionData->Type == MAPTYPE_STATIC)
 			{
@@ -687,7 +695,6 @@ static void DrawEditorTiles(DrawBuffer *b, Vec2i offset)
 				}
 			}
 		}
-		tile += X_TILES - b->Size.x;
 	}
 }
 
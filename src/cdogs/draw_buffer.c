@@ -49,39 +49,35 @@
 #include "draw_buffer.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "algorithms.h"
 #include "los.h"
 
 
+static Tile sTileNone;
+
 void DrawBufferInit(DrawBuffer *b, Vec2i size, GraphicsDevice *g)
 {
 	debug(D_MAX, "Initialising draw buffer %dx%d\n", size.x, size.y);
 	b->OrigSize = size;
-	CMALLOC(b->tiles, size.x * sizeof *b->tiles);
-	CMALLOC(b->tiles[0], size.x * size.y * sizeof *b->tiles[0]);
-	for (int i = 1; i < size.x; i++)
-	{
-		b->tiles[i] = b->tiles[0] + i * size.y;
-	}
+	CMALLOC(b->tiles, size.x * size.y * sizeof *b->tiles);
+	CMALLOC(b->tileFlags, size.x * size.y * sizeof *b->tileFlags);
+	sTileNone = TileNone();
 	b->g = g;
-	CArrayInit(&b->displaylist, sizeof(const TTileItem *));
-	CArrayReserve(&b->displaylist, 32);
+	DisplayListInit(&b->displaylist);
 	debug(D_MAX, "Initialised draw buffer %dx%d\n", size.x, size.y);
 }
 void DrawBufferTerminate(DrawBuffer *b)
 {
-	CFREE(b->tiles[0]);
 	CFREE(b->tiles);
-	CArrayTerminate(&b->displaylist);
+	CFREE(b->tileFlags);
+	DisplayListTerminate(&b->displaylist);
 }
 
 void DrawBufferSetFromMap(
 	DrawBuffer *buffer, Map *map, Vec2i origin, int width)
 {
-	int x, y;
-	Tile *bufTile;
-
 	buffer->Size = Vec2iNew(width, buffer->OrigSize.y);
 
 	buffer->xTop = origin.x - TILE_WIDTH * width / 2;
@@ -102,90 +98,85 @@ void DrawBufferSetFromMap(
 	buffer->dx = buffer->xStart * TILE_WIDTH - buffer->xTop;
 	buffer->dy = buffer->yStart * TILE_HEIGHT - buffer->yTop;
 
-	bufTile = &buffer->tiles[0][0];
-	for (y = buffer->yStart; y < buffer->yStart + buffer->Size.y; y++)
+	const Tile *mapTiles = map->Tiles.data;
+	for (int y = 0; y < buffer->Size.y; y++)
 	{
-		for (x = buffer->xStart;
-			x < buffer->xStart + buffer->Size.x;
-			x++, bufTile++)
+		const Tile **bufTile = buffer->tiles + y * buffer->OrigSize.x;
+		const int mapY = buffer->yStart + y;
+		for (int x = 0; x < buffer->Size.x; x++)
 		{
-			if (x >= 0 && x < map->Size.x && y >= 0 && y < map->Size.y)
+			const int mapX = buffer->xStart + x;
+			if (mapX >= 0 && mapX < map->Size.x &&
+				mapY >= 0 && mapY < map->Size.y)
 			{
-				*bufTile = *MapGetTile(map, Vec2iNew(x, y));
+				bufTile[x] = &mapTiles[mapY * map->Size.x + mapX];
 			}
 			else
 			{
-				*bufTile = TileNone();
+				bufTile[x] = &sTileNone;
 			}
 		}
-		bufTile += buffer->OrigSize.x - buffer->Size.x;
 	}
+	memset(
+		buffer->tileFlags, 0,
+		buffer->OrigSize.x * buffer->OrigSize.y * sizeof *buffer->tileFlags);
 }
 
-// Set visibility and draw order for wall/door columns
+// Set line of sight for the buffer's tiles
 void DrawBufferFix(DrawBuffer *buffer)
 {
-	Tile *tile = &buffer->tiles[0][0];
-	Tile *tileBelow = &buffer->tiles[0][0] + X_TILES;
-	for (int y = 0; y < Y_TILES - 1; y++)
-	{
-		for (int x = 0; x < buffer->Size.x; x++, tile++, tileBelow++)
-		{
-			if (!(tile->flags & (MAPTILE_IS_WALL | MAPTILE_OFFSET_PIC)) &&
-				(tileBelow->flags & MAPTILE_IS_WALL))
-			{
-				tile->pic = NULL;
-			}
-			else if ((tile->flags & MAPTILE_IS_WALL) &&
-				(tileBelow->flags & MAPTILE_IS_WALL))
-			{
-				tile->flags |= MAPTILE_DELAY_DRAW;
-			}
-		}
-		tile += X_TILES - buffer->Size.x;
-		tileBelow += X_TILES - buffer->Size.x;
-	}
-
-	tile = &buffer->tiles[0][0];
-	for (int y = 0; y < Y_TILES; y++)
+	for (int y = 0; y < buffer->Size.y; y++)
 	{
-		for (int x = 0; x < buffer->Size.x; x++, tile++)
+		Uint8 *flags = buffer->tileFlags + y * buffer->OrigSize.x;
+		for (int x = 0; x < buffer->Size.x; x++)
 		{
 			const Vec2i mapTile =
 				Vec2iNew(x + buffer->xStart, y + buffer->yStart);
 			if (!LOSTileIsVisible(&gMap, mapTile))
 			{
-				tile->flags |= MAPTILE_OUT_OF_SIGHT;
-			}
-			else
-			{
-				tile->flags &= ~MAPTILE_OUT_OF_SIGHT;
+				flags[x] |= DRAW_TILE_OUT_OF_SIGHT;
 			}
 		}
-		tile += X_TILES - buffer->Size.x;
 	}
 }
 
-static int CompareY(const void *v1, const void *v2);
-void DrawBufferSortDisplayList(DrawBuffer *buffer)
+// Key for sorting things: whether the thing is debris, then row, then y
+// relative to the top of the row, biased so that it is never negative
+static Uint32 MakeKey(
+	const DrawBuffer *b, const TTileItem *ti, const int row,
+	const bool isDebris)
 {
-	qsort(
-		buffer->displaylist.data,
-		buffer->displaylist.size,
-		buffer->displaylist.elemSize,
-		CompareY);
+	const int y = ti->y - (b->yStart + row) * TILE_HEIGHT + 0x8000;
+	return (isDebris ? 0 : 0x80000000) | (Uint32)row << 16 |
+		(Uint32)CLAMP(y, 0, 0xFFFF);
 }
-static int CompareY(const void *v1, const void *v2)
+void DrawBufferMakeDisplayList(DrawBuffer *buffer)
 {
-	const TTileItem * const *t1 = v1;
-	const TTileItem * const *t2 = v2;
-	if ((*t1)->y < (*t2)->y)
-	{
-		return -1;
-	}
-	else if ((*t1)->y >(*t2)->y)
+	DisplayListClear(&buffer->displaylist);
+	buffer->numDebris = 0;
+	for (int y = 0; y < buffer->Size.y; y++)
 	{
-		return 1;
+		for (int x = 0; x < buffer->Size.x; x++)
+		{
+			const int idx = y * buffer->OrigSize.x + x;
+			if (buffer->tileFlags[idx] & DRAW_TILE_OUT_OF_SIGHT)
+			{
+				continue;
+			}
+			const Tile *tile = buffer->tiles[idx];
+			for (int i = 0; i < (int)tile->things.size; i++)
+			{
+				const TTileItem *ti =
+					ThingIdGetTileItem(CArrayGet(&tile->things, i));
+				const bool isDebris = TileItemIsDebris(ti);
+				if (isDebris)
+				{
+					buffer->numDebris++;
+				}
+				DisplayListAdd(
+					&buffer->displaylist, ti, MakeKey(buffer, ti, y, isDebris));
+			}
+		}
 	}
-	return 0;
+	DisplayListSort(&buffer->displaylist);
 }
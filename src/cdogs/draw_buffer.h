@@ -49,8 +49,15 @@
 #ifndef __DRAW_BUFFER
 #define __DRAW_BUFFER
 
+#include "display_list.h"
 #include "map.h"
 
+// Per-frame draw state of the buffer's tiles
+typedef enum
+{
+	DRAW_TILE_OUT_OF_SIGHT	= 0x01
+} DrawTileFlags;
+
 typedef struct
 {
 	GraphicsDevice *g;
@@ -59,16 +66,25 @@ typedef struct
 	int dx, dy;	// remainder pixel offset from starting tile
 	Vec2i OrigSize;
 	Vec2i Size;	// size in tiles
-	Tile **tiles;
-	CArray displaylist;	// of const TTileItem *, to determine draw order
+	// View of the map tiles covered by the buffer, in rows of OrigSize.x;
+	// tiles outside the map point to an empty tile
+	const Tile **tiles;
+	Uint8 *tileFlags;	// of DrawTileFlags, in the same layout as tiles
+	// Things on tiles in sight, in draw order: debris first, then the rest
+	// by buffer row, both by y within a row
+	DisplayList displaylist;
+	int numDebris;
 } DrawBuffer;
 
+// Buffer row of a display list key
+#define DRAW_BUFFER_KEY_ROW(_key) ((int)(((_key) >> 16) & 0x7FFF))
+
 void DrawBufferInit(DrawBuffer *b, Vec2i size, GraphicsDevice *g);
 void DrawBufferTerminate(DrawBuffer *b);
 
 void DrawBufferSetFromMap(
 	DrawBuffer *buffer, Map *map, Vec2i origin, int width);
 void DrawBufferFix(DrawBuffer *buffer);
-void DrawBufferSortDisplayList(DrawBuffer *buffer);
+void DrawBufferMakeDisplayList(DrawBuffer *buffer);
 
 #endif
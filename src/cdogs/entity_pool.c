@@ -0,0 +1,86 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "entity_pool.h"
+
+#include <string.h>
+
+#include "utils.h"
+
+
+void EntityPoolInit(EntityPool *p)
+{
+	CArrayInit(&p->Free, sizeof(int));
+	CArrayInit(&p->Live, sizeof(int));
+	CArrayInit(&p->LivePos, sizeof(int));
+}
+void EntityPoolTerminate(EntityPool *p)
+{
+	CArrayTerminate(&p->Free);
+	CArrayTerminate(&p->Live);
+	CArrayTerminate(&p->LivePos);
+}
+
+int EntityPoolAdd(EntityPool *p, CArray *store)
+{
+	int id;
+	if (p->Free.size > 0)
+	{
+		id = *(int *)CArrayGet(&p->Free, (int)p->Free.size - 1);
+		p->Free.size--;
+	}
+	else
+	{
+		id = (int)store->size;
+		if (store->size == store->capacity)
+		{
+			CArrayReserve(store, MAX(1, store->capacity * 2));
+		}
+		CArrayResize(store, id + 1, NULL);
+		memset(CArrayGet(store, id), 0, store->elemSize);
+		const int none = -1;
+		CArrayPushBack(&p->LivePos, &none);
+	}
+	const int pos = (int)p->Live.size;
+	CArrayPushBack(&p->Live, &id);
+	*(int *)CArrayGet(&p->LivePos, id) = pos;
+	return id;
+}
+
+void EntityPoolRemove(EntityPool *p, const int id)
+{
+	int *livePos = CArrayGet(&p->LivePos, id);
+	CASSERT(*livePos >= 0, "removing free entity slot");
+	// Swap the last live slot into this one's place
+	int *live = p->Live.data;
+	const int last = live[p->Live.size - 1];
+	live[*livePos] = last;
+	*(int *)CArrayGet(&p->LivePos, last) = *livePos;
+	p->Live.size--;
+	*livePos = -1;
+	CArrayPushBack(&p->Free, &id);
+}
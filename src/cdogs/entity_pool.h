@@ -0,0 +1,57 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "c_array.h"
+
+// Slot allocator for entity stores, which are CArrays of entities whose
+// indices must stay stable (they are referenced by tile items and events)
+// Free slots are kept on a free list for O(1) add and destroy, and the
+// in-use slots are kept in a dense list so that update loops don't need to
+// skip over free slots.
+typedef struct
+{
+	CArray Free;	// of int; free slot indices, used as a stack
+	CArray Live;	// of int; in-use slot indices, unordered
+	CArray LivePos;	// of int; for each slot, its position in Live or -1
+} EntityPool;
+
+void EntityPoolInit(EntityPool *p);
+void EntityPoolTerminate(EntityPool *p);
+// Get a free slot, adding a zeroed element to the store if there are none
+int EntityPoolAdd(EntityPool *p, CArray *store);
+void EntityPoolRemove(EntityPool *p, const int id);
+
+// Convenience macro for looping through the in-use entities of a store
+// Entities added or removed during the loop may or may not be visited
+#define ENTITY_POOL_FOREACH(_type, _var, _p, _store)\
+	for (int i = 0; i < (int)(_p).Live.size; i++)\
+	{\
+		_type *_var = CArrayGet(\
+			&(_store), ((const int *)(_p).Live.data)[i]);
+#define ENTITY_POOL_FOREACH_END() }
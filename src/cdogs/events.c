@@ -68,9 +68,11 @@ void EventInit(
 	KeyInit(&handlers->keyboard);
 	JoyInit(&handlers->joysticks);
 	MouseInit(&handlers->mouse, mouseCursor, mouseTrail, hideMouse);
+	ConfigAddApplyListener(KeyOnConfigApply, &handlers->keyboard);
 }
 void EventTerminate(EventHandlers *handlers)
 {
+	ConfigRemoveApplyListener(KeyOnConfigApply, &handlers->keyboard);
 	JoyTerminate(&handlers->joysticks);
 }
 void EventReset(EventHandlers *handlers, Pic *mouseCursor, Pic *mouseTrail)
@@ -0,0 +1,178 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "floor_cache.h"
+
+#include <string.h>
+
+#include "grafx.h"
+
+
+void FloorCacheInit(FloorCache *c, const Vec2i size)
+{
+	memset(c, 0, sizeof *c);
+	c->Size = Vec2iNew(
+		(size.x + FLOOR_CACHE_CHUNK_SIZE - 1) / FLOOR_CACHE_CHUNK_SIZE,
+		(size.y + FLOOR_CACHE_CHUNK_SIZE - 1) / FLOOR_CACHE_CHUNK_SIZE);
+	CArrayInit(&c->Chunks, sizeof(FloorCacheChunk));
+	const FloorCacheChunk chunk = { NULL, 0 };
+	for (int i = 0; i < c->Size.x * c->Size.y; i++)
+	{
+		CArrayPushBack(&c->Chunks, &chunk);
+	}
+}
+void FloorCacheTerminate(FloorCache *c)
+{
+	CA_FOREACH(FloorCacheChunk, chunk, c->Chunks)
+		CFREE(chunk->Pixels);
+	CA_FOREACH_END()
+	CArrayTerminate(&c->Chunks);
+}
+
+static bool HasFloorPic(const Tile *t)
+{
+	return t->pic != NULL && t->pic->pic.Data != NULL &&
+		!(t->flags & MAPTILE_IS_WALL);
+}
+bool FloorCacheHasTile(const Tile *t)
+{
+	return HasFloorPic(t) && !(t->flags & MAPTILE_COVERED_BY_WALL);
+}
+
+static FloorCacheChunk *GetChunk(FloorCache *c, const Vec2i tile)
+{
+	return CArrayGet(
+		&c->Chunks,
+		tile.y / FLOOR_CACHE_CHUNK_SIZE * c->Size.x +
+		tile.x / FLOOR_CACHE_CHUNK_SIZE);
+}
+static Uint32 *GetChunkTile(const FloorCacheChunk *chunk, const Vec2i tile)
+{
+	return chunk->Pixels +
+		tile.y % FLOOR_CACHE_CHUNK_SIZE * TILE_HEIGHT * FLOOR_CACHE_STRIDE +
+		tile.x % FLOOR_CACHE_CHUNK_SIZE * TILE_WIDTH;
+}
+
+// Draw a tile's floor pic unmasked, clipped to the tile
+static void RenderTile(Map *map, FloorCacheChunk *chunk, const Vec2i tile)
+{
+	Uint32 *dst = GetChunkTile(chunk, tile);
+	for (int y = 0; y < TILE_HEIGHT; y++)
+	{
+		memset(dst + y * FLOOR_CACHE_STRIDE, 0, TILE_WIDTH * sizeof *dst);
+	}
+	const Tile *t = MapGetTile(map, tile);
+	if (!HasFloorPic(t))
+	{
+		return;
+	}
+	const Pic *pic = &t->pic->pic;
+	const int x0 = MAX(pic->offset.x, 0);
+	const int x1 = MIN(pic->offset.x + pic->size.x, TILE_WIDTH);
+	const int y0 = MAX(pic->offset.y, 0);
+	const int y1 = MIN(pic->offset.y + pic->size.y, TILE_HEIGHT);
+	for (int y = y0; y < y1 && x0 < x1; y++)
+	{
+		memcpy(
+			dst + y * FLOOR_CACHE_STRIDE + x0,
+			pic->Data +
+			(y - pic->offset.y) * pic->size.x + x0 - pic->offset.x,
+			(x1 - x0) * sizeof *dst);
+	}
+}
+
+// Keep enough chunks for four views of the whole screen
+static int GetMaxChunks(void)
+{
+	return 4 *
+		(X_TILES / FLOOR_CACHE_CHUNK_SIZE + 2) *
+		(Y_TILES / FLOOR_CACHE_CHUNK_SIZE + 2);
+}
+static void FreeLeastRecentlyUsed(FloorCache *c)
+{
+	FloorCacheChunk *lru = NULL;
+	CA_FOREACH(FloorCacheChunk, chunk, c->Chunks)
+		if (chunk->Pixels != NULL &&
+			(lru == NULL ||
+			c->Ticks - chunk->LastUsed > c->Ticks - lru->LastUsed))
+		{
+			lru = chunk;
+		}
+	CA_FOREACH_END()
+	CFREE(lru->Pixels);
+	lru->Pixels = NULL;
+	c->NumAllocated--;
+}
+
+const Uint32 *FloorCacheGetTile(Map *map, const Vec2i tile)
+{
+	FloorCache *c = &map->FloorCache;
+	FloorCacheChunk *chunk = GetChunk(c, tile);
+	c->Ticks++;
+	chunk->LastUsed = c->Ticks;
+	if (chunk->Pixels == NULL)
+	{
+		if (c->NumAllocated >= GetMaxChunks())
+		{
+			FreeLeastRecentlyUsed(c);
+		}
+		CMALLOC(
+			chunk->Pixels,
+			FLOOR_CACHE_STRIDE * FLOOR_CACHE_CHUNK_SIZE * TILE_HEIGHT *
+			sizeof *chunk->Pixels);
+		c->NumAllocated++;
+		const Vec2i start = Vec2iNew(
+			tile.x - tile.x % FLOOR_CACHE_CHUNK_SIZE,
+			tile.y - tile.y % FLOOR_CACHE_CHUNK_SIZE);
+		Vec2i v;
+		for (v.y = start.y; v.y < start.y + FLOOR_CACHE_CHUNK_SIZE; v.y++)
+		{
+			for (v.x = start.x; v.x < start.x + FLOOR_CACHE_CHUNK_SIZE; v.x++)
+			{
+				if (v.x < map->Size.x && v.y < map->Size.y)
+				{
+					RenderTile(map, chunk, v);
+				}
+			}
+		}
+	}
+	return GetChunkTile(chunk, tile);
+}
+
+void FloorCacheOnTileChanged(Map *map, const Vec2i tile)
+{
+	if (tile.x < 0 || tile.x >= map->Size.x ||
+		tile.y < 0 || tile.y >= map->Size.y)
+	{
+		return;
+	}
+	FloorCacheChunk *chunk = GetChunk(&map->FloorCache, tile);
+	if (chunk->Pixels != NULL)
+	{
+		RenderTile(map, chunk, tile);
+	}
+}
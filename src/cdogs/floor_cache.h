@@ -0,0 +1,50 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "map.h"
+
+// Static floor layer, so that floors can be drawn with a few long copies
+// instead of a blit per tile
+// The layer is kept in square chunks of tiles, and holds unmasked floor
+// pixels only; line of sight masking is left to the drawing code.
+#define FLOOR_CACHE_CHUNK_SIZE 8
+// Pixels between rows of a chunk
+#define FLOOR_CACHE_STRIDE (FLOOR_CACHE_CHUNK_SIZE * TILE_WIDTH)
+
+void FloorCacheInit(FloorCache *c, const Vec2i size);
+void FloorCacheTerminate(FloorCache *c);
+
+// Whether a tile is drawn from the floor layer, i.e. it has a floor pic
+// that isn't covered by a wall
+bool FloorCacheHasTile(const Tile *t);
+// Get the floor pixels for the top-left of a tile
+// The tile's chunk is rendered first if it isn't cached
+const Uint32 *FloorCacheGetTile(Map *map, const Vec2i tile);
+// Redraw a tile whose pic or flags have changed
+void FloorCacheOnTileChanged(Map *map, const Vec2i tile);
@@ -0,0 +1,331 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "flow_field.h"
+
+#include "ai_utils.h"
+
+#define FLOW_FIELD_MAX 8
+
+FlowFields gFlowFields;
+
+typedef struct
+{
+	int Dist;
+	int Index;
+} FlowFieldNode;
+
+
+void FlowFieldsInit(FlowFields *ff, Map *m)
+{
+	CArrayInit(&ff->fields, sizeof(FlowField));
+	CArrayInit(&ff->walkable, sizeof(bool));
+	const bool walkable = false;
+	CArrayResize(&ff->walkable, m->Size.x * m->Size.y, &walkable);
+	CArrayInit(&ff->open, sizeof(FlowFieldNode));
+	ff->ticks = 0;
+	ff->map = m;
+}
+void FlowFieldsTerminate(FlowFields *ff)
+{
+	CA_FOREACH(FlowField, f, ff->fields)
+		CArrayTerminate(&f->Dist);
+	CA_FOREACH_END()
+	CArrayTerminate(&ff->fields);
+	CArrayTerminate(&ff->walkable);
+	CArrayTerminate(&ff->open);
+}
+
+// Binary min-heap of open nodes
+static void OpenPush(FlowFields *ff, const int dist, const int index)
+{
+	FlowFieldNode n;
+	n.Dist = dist;
+	n.Index = index;
+	CArrayPushBack(&ff->open, &n);
+	FlowFieldNode *nodes = ff->open.data;
+	int i = (int)ff->open.size - 1;
+	while (i > 0 && nodes[(i - 1) / 2].Dist > dist)
+	{
+		nodes[i] = nodes[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	nodes[i] = n;
+}
+static FlowFieldNode OpenPop(FlowFields *ff)
+{
+	FlowFieldNode *nodes = ff->open.data;
+	const FlowFieldNode top = nodes[0];
+	const FlowFieldNode last = nodes[ff->open.size - 1];
+	CArrayDelete(&ff->open, (int)ff->open.size - 1);
+	const int size = (int)ff->open.size;
+	if (size == 0)
+	{
+		return top;
+	}
+	int i = 0;
+	for (;;)
+	{
+		int child = 2 * i + 1;
+		if (child >= size)
+		{
+			break;
+		}
+		if (child + 1 < size && nodes[child + 1].Dist < nodes[child].Dist)
+		{
+			child++;
+		}
+		if (last.Dist <= nodes[child].Dist)
+		{
+			break;
+		}
+		nodes[i] = nodes[child];
+		i = child;
+	}
+	nodes[i] = last;
+	return top;
+}
+
+static bool IsInside(const Map *map, const Vec2i v)
+{
+	return v.x >= 0 && v.x < map->Size.x && v.y >= 0 && v.y < map->Size.y;
+}
+static bool IsWalkable(const FlowFields *ff, const Vec2i v)
+{
+	const bool *walkable = ff->walkable.data;
+	return IsInside(ff->map, v) && walkable[v.y * ff->map->Size.x + v.x];
+}
+static int StepCost(const Vec2i d)
+{
+	if (d.x != 0 && d.y != 0)
+	{
+		return PATH_COST_DIAGONAL;
+	}
+	return d.x != 0 ? PATH_COST_X : PATH_COST_Y;
+}
+
+// Dijkstra outwards from the open nodes
+// Only lowers distances, so it also updates a field after tiles open up
+static void Propagate(FlowFields *ff, FlowField *f)
+{
+	int *dist = f->Dist.data;
+	const int w = ff->map->Size.x;
+	while (ff->open.size > 0)
+	{
+		const FlowFieldNode n = OpenPop(ff);
+		if (n.Dist > dist[n.Index])
+		{
+			// Stale; this tile has since been reached by a shorter way
+			continue;
+		}
+		const Vec2i v = Vec2iNew(n.Index % w, n.Index / w);
+		Vec2i d;
+		for (d.y = -1; d.y <= 1; d.y++)
+		{
+			for (d.x = -1; d.x <= 1; d.x++)
+			{
+				const Vec2i u = Vec2iAdd(v, d);
+				// Same as A*: diagonal steps need both axis tiles clear
+				if ((d.x == 0 && d.y == 0) ||
+					!IsWalkable(ff, u) ||
+					!IsWalkable(ff, Vec2iNew(v.x, u.y)) ||
+					!IsWalkable(ff, Vec2iNew(u.x, v.y)))
+				{
+					continue;
+				}
+				const int ud = n.Dist + StepCost(d);
+				const int i = u.y * w + u.x;
+				if (ud < dist[i])
+				{
+					dist[i] = ud;
+					OpenPush(ff, ud, i);
+				}
+			}
+		}
+	}
+}
+
+static void Rebuild(FlowFields *ff, FlowField *f, const Vec2i goal)
+{
+	// Take the chance to refresh walkability, as things may have moved
+	bool *walkable = ff->walkable.data;
+	int *dist = f->Dist.data;
+	Vec2i v;
+	for (v.y = 0; v.y < ff->map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < ff->map->Size.x; v.x++)
+		{
+			const int i = v.y * ff->map->Size.x + v.x;
+			walkable[i] = IsTileWalkable(ff->map, v);
+			dist[i] = FLOW_FIELD_UNREACHABLE;
+		}
+	}
+	f->Goal = goal;
+	const int i = goal.y * ff->map->Size.x + goal.x;
+	dist[i] = 0;
+	CArrayClear(&ff->open);
+	OpenPush(ff, 0, i);
+	Propagate(ff, f);
+}
+
+static FlowField *NewField(FlowFields *ff)
+{
+	if ((int)ff->fields.size < FLOW_FIELD_MAX)
+	{
+		FlowField f;
+		memset(&f, 0, sizeof f);
+		CArrayInit(&f.Dist, sizeof(int));
+		const int unreachable = FLOW_FIELD_UNREACHABLE;
+		CArrayResize(&f.Dist, ff->walkable.size, &unreachable);
+		CArrayPushBack(&ff->fields, &f);
+		return CArrayGet(&ff->fields, (int)ff->fields.size - 1);
+	}
+	// Reuse the least recently used field
+	FlowField *oldest = CArrayGet(&ff->fields, 0);
+	CA_FOREACH(FlowField, f, ff->fields)
+		if (f->LastUsed < oldest->LastUsed)
+		{
+			oldest = f;
+		}
+	CA_FOREACH_END()
+	return oldest;
+}
+const FlowField *FlowFieldsGet(
+	FlowFields *ff, const int targetUID, const Vec2i goal)
+{
+	ff->ticks++;
+	CA_FOREACH(FlowField, f, ff->fields)
+		if (f->TargetUID == targetUID)
+		{
+			f->LastUsed = ff->ticks;
+			if (!Vec2iEqual(f->Goal, goal))
+			{
+				Rebuild(ff, f, goal);
+			}
+			return f;
+		}
+	CA_FOREACH_END()
+	FlowField *f = NewField(ff);
+	f->TargetUID = targetUID;
+	f->LastUsed = ff->ticks;
+	Rebuild(ff, f, goal);
+	return f;
+}
+
+void FlowFieldsOpenTile(FlowFields *ff, const Vec2i tile)
+{
+	if (ff->fields.size == 0 || !IsInside(ff->map, tile))
+	{
+		return;
+	}
+	bool *walkable = CArrayGet(
+		&ff->walkable, tile.y * ff->map->Size.x + tile.x);
+	if (*walkable || !IsTileWalkable(ff->map, tile))
+	{
+		return;
+	}
+	*walkable = true;
+	// The new steps are to this tile, or diagonally past it;
+	// relax again from the tiles around it
+	CA_FOREACH(FlowField, f, ff->fields)
+		const int *dist = f->Dist.data;
+		CArrayClear(&ff->open);
+		Vec2i v;
+		for (v.y = tile.y - 1; v.y <= tile.y + 1; v.y++)
+		{
+			for (v.x = tile.x - 1; v.x <= tile.x + 1; v.x++)
+			{
+				if (!IsInside(ff->map, v))
+				{
+					continue;
+				}
+				const int j = v.y * ff->map->Size.x + v.x;
+				if (dist[j] != FLOW_FIELD_UNREACHABLE)
+				{
+					OpenPush(ff, dist[j], j);
+				}
+			}
+		}
+		Propagate(ff, f);
+	CA_FOREACH_END()
+}
+void FlowFieldsOpenDoors(FlowFields *ff, const int keyFlags)
+{
+	if (keyFlags == 0 || ff->fields.size == 0)
+	{
+		return;
+	}
+	Vec2i v;
+	for (v.y = 0; v.y < ff->map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < ff->map->Size.x; v.x++)
+		{
+			const Tile *t = MapGetTile(ff->map, v);
+			if ((t->flags & MAPTILE_OFFSET_PIC) &&
+				(MapGetDoorKeycardFlag(ff->map, v) & keyFlags))
+			{
+				FlowFieldsOpenTile(ff, v);
+			}
+		}
+	}
+}
+
+bool FlowFieldNext(
+	const FlowField *f, const Map *map, const Vec2i tile, Vec2i *next)
+{
+	const int *dist = f->Dist.data;
+	const int w = map->Size.x;
+	int best = FLOW_FIELD_UNREACHABLE;
+	Vec2i d;
+	for (d.y = -1; d.y <= 1; d.y++)
+	{
+		for (d.x = -1; d.x <= 1; d.x++)
+		{
+			const Vec2i u = Vec2iAdd(tile, d);
+			if ((d.x == 0 && d.y == 0) || !IsInside(map, u) ||
+				dist[u.y * w + u.x] == FLOW_FIELD_UNREACHABLE)
+			{
+				continue;
+			}
+			// Axis tiles next to reachable tiles are only unreachable
+			// if they are not walkable
+			if (d.x != 0 && d.y != 0 &&
+				(dist[tile.y * w + u.x] == FLOW_FIELD_UNREACHABLE ||
+				dist[u.y * w + tile.x] == FLOW_FIELD_UNREACHABLE))
+			{
+				continue;
+			}
+			const int ud = dist[u.y * w + u.x] + StepCost(d);
+			if (ud < best)
+			{
+				best = ud;
+				*next = u;
+			}
+		}
+	}
+	return best != FLOW_FIELD_UNREACHABLE;
+}
@@ -0,0 +1,78 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <limits.h>
+
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+#define FLOW_FIELD_UNREACHABLE INT_MAX
+
+// Distances to a target actor, over all walkable tiles
+typedef struct
+{
+	int TargetUID;
+	Vec2i Goal;
+	CArray Dist;	// of int, per tile
+	int LastUsed;
+} FlowField;
+
+typedef struct
+{
+	CArray fields;	// of FlowField
+	CArray walkable;	// of bool, per tile
+	CArray open;	// of FlowFieldNode, Dijkstra heap
+	int ticks;
+	Map *map;
+} FlowFields;
+
+// Flow fields shared by all the AI heading to the same target,
+// so that the cost of pathfinding depends on the number of targets rather
+// than the number of AI
+// Walkability is the same as AIGoto ignoring objects
+// Note: lifetime managed by Map
+extern FlowFields gFlowFields;
+
+void FlowFieldsInit(FlowFields *ff, Map *m);
+void FlowFieldsTerminate(FlowFields *ff);
+
+// Get the field to this target, rebuilding it if the target changed tile
+const FlowField *FlowFieldsGet(
+	FlowFields *ff, const int targetUID, const Vec2i goal);
+// Update the fields for a tile that may now be walkable,
+// e.g. an object destroyed
+void FlowFieldsOpenTile(FlowFields *ff, const Vec2i tile);
+// Update the fields for the doors that these keys open
+void FlowFieldsOpenDoors(FlowFields *ff, const int keyFlags);
+
+// Get the next tile to go to, by steepest descent
+// Returns false if the target can't be reached from this tile
+bool FlowFieldNext(
+	const FlowField *f, const Map *map, const Vec2i tile, Vec2i *next);
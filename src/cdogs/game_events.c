@@ -28,6 +28,7 @@
 */
 #include "game_events.h"
 
+#include <stddef.h>
 #include <string.h>
 
 #include "actors.h"
@@ -36,122 +37,154 @@
 #include "utils.h"
 
 
-CArray gGameEvents;
+GameEventQueue gGameEvents;
 
-void GameEventsInit(CArray *store)
+// Big enough for dozens of the largest events
+#define GAME_EVENT_BLOCK_SIZE 16384
+struct GameEventBlock
 {
-	CArrayInit(store, sizeof(GameEvent));
+	GameEventBlock *Next;
+	size_t Used;
+	// Records are GameEvents truncated to their type's data
+	uint64_t Data[GAME_EVENT_BLOCK_SIZE / sizeof(uint64_t)];
+};
+typedef struct
+{
+	int Frame;
+	GameEventList Events;
+} GameEventBucket;
+
+static void ListRelease(GameEventQueue *q, GameEventList *l);
+void GameEventsInit(GameEventQueue *q)
+{
+	memset(q, 0, sizeof *q);
+	CArrayInit(&q->Delayed, sizeof(GameEventBucket));
+	q->IsInitialized = true;
 }
-void GameEventsTerminate(CArray *store)
+void GameEventsTerminate(GameEventQueue *q)
 {
-	CArrayTerminate(store);
+	GameEventsClear(q);
+	CArrayTerminate(&q->Delayed);
+	while (q->FreeBlocks != NULL)
+	{
+		GameEventBlock *next = q->FreeBlocks->Next;
+		CFREE(q->FreeBlocks);
+		q->FreeBlocks = next;
+	}
+	memset(q, 0, sizeof *q);
 }
 
+// Size of the event data for each type
+#define EVENT_SIZE(_member) sizeof(((const GameEvent *)NULL)->u._member)
+// For messages without their own GameEvent member
+#define EVENT_SIZE_ALL sizeof(((const GameEvent *)NULL)->u)
 
 // Array indexed by GameEvent
 static GameEventEntry sGameEventEntries[] =
 {
-	{ GAME_EVENT_NONE, false, false, false, false, NULL },
-
-	{ GAME_EVENT_CLIENT_CONNECT, false, false, false, false, NULL },
-	{ GAME_EVENT_CLIENT_ID, false, false, false, false, NClientId_fields },
-	{ GAME_EVENT_CAMPAIGN_DEF, false, false, false, false, NCampaignDef_fields },
-	{ GAME_EVENT_PLAYER_DATA, true, false, true, false, NPlayerData_fields },
-	{ GAME_EVENT_TILE_SET, true, false, true, true, NTileSet_fields },
-	{ GAME_EVENT_MAP_OBJECT_ADD, true, false, true, true, NMapObjectAdd_fields },
-	{ GAME_EVENT_MAP_OBJECT_DAMAGE, true, false, true, true, NMapObjectDamage_fields },
-	{ GAME_EVENT_CLIENT_READY, false, false, false, false, NULL },
-	{ GAME_EVENT_NET_GAME_START, false, false, false, false, NULL },
-
-	{ GAME_EVENT_SCORE, true, true, true, true, NULL },
-	{ GAME_EVENT_SOUND_AT, true, false, true, true, NSound_fields },
-	{ GAME_EVENT_SCREEN_SHAKE, false, false, true, true, NULL },
-	{ GAME_EVENT_SET_MESSAGE, false, false, true, true, NULL },
-
-	{ GAME_EVENT_GAME_START, true, false, true, true, NULL },
-
-	{ GAME_EVENT_ACTOR_ADD, true, false, true, true, NActorAdd_fields },
-	{ GAME_EVENT_ACTOR_MOVE, true, true, true, true, NActorMove_fields },
-	{ GAME_EVENT_ACTOR_STATE, true, true, true, true, NActorState_fields },
-	{ GAME_EVENT_ACTOR_DIR, true, true, true, true, NActorDir_fields },
-	{ GAME_EVENT_ACTOR_SLIDE, true, true, true, true, NActorSlide_fields },
-	{ GAME_EVENT_ACTOR_IMPULSE, true, false, true, true, NActorImpulse_fields },
-	{ GAME_EVENT_ACTOR_SWITCH_GUN, true, true, true, true, NActorSwitchGun_fields },
-	{ GAME_EVENT_ACTOR_PICKUP_ALL, false, true, true, true, NActorPickupAll_fields },
-	{ GAME_EVENT_ACTOR_REPLACE_GUN, true, false, true, true, NActorReplaceGun_fields },
-	{ GAME_EVENT_ACTOR_HEAL, true, false, true, true, NActorHeal_fields },
-	{ GAME_EVENT_ACTOR_HIT, true, false, true, true, NActorHit_fields },
-	{ GAME_EVENT_ACTOR_ADD_AMMO, true, false, true, true, NActorAddAmmo_fields },
-	{ GAME_EVENT_ACTOR_USE_AMMO, true, true, true, true, NActorUseAmmo_fields },
-	{ GAME_EVENT_ACTOR_DIE, true, false, true, true, NActorDie_fields },
-	{ GAME_EVENT_ACTOR_MELEE, true, true, true, true, NActorMelee_fields },
-
-	{ GAME_EVENT_ADD_PICKUP, true, false, true, true, NAddPickup_fields },
-	{ GAME_EVENT_REMOVE_PICKUP, true, false, true, true, NRemovePickup_fields },
-
-	{ GAME_EVENT_BULLET_BOUNCE, true, false, true, true, NBulletBounce_fields },
-	{ GAME_EVENT_REMOVE_BULLET, true, false, true, true, NRemoveBullet_fields },
-	{ GAME_EVENT_PARTICLE_REMOVE, false, false, true, true, NULL },
-	{ GAME_EVENT_GUN_FIRE, true, true, true, true, NGunFire_fields },
-	{ GAME_EVENT_GUN_RELOAD, true, true, true, true, NGunReload_fields },
-	{ GAME_EVENT_GUN_STATE, true, true, true, true, NGunState_fields },
-	{ GAME_EVENT_ADD_BULLET, true, false, true, true, NAddBullet_fields },
-	{ GAME_EVENT_ADD_PARTICLE, false, false, true, true, NULL },
-	{ GAME_EVENT_TRIGGER, true, false, true, true, NTrigger_fields },
-	{ GAME_EVENT_EXPLORE_TILES, true, false, true, true, NExploreTiles_fields },
-	{ GAME_EVENT_RESCUE_CHARACTER, true, false, true, true, NRescueCharacter_fields },
-	{ GAME_EVENT_OBJECTIVE_UPDATE, true, false, true, true, NObjectiveUpdate_fields },
-	{ GAME_EVENT_ADD_KEYS, true, false, true, true, NAddKeys_fields },
-
-	{ GAME_EVENT_MISSION_COMPLETE, true, false, true, true, NMissionComplete_fields },
-
-	{ GAME_EVENT_MISSION_INCOMPLETE, true, false, true, true, NULL },
-	{ GAME_EVENT_MISSION_PICKUP, true, false, true, true, NULL },
-	{ GAME_EVENT_MISSION_END, true, false, true, true, NULL }
+	{ GAME_EVENT_NONE, false, false, false, false, NULL, 0 },
+
+	{ GAME_EVENT_CLIENT_CONNECT, false, false, false, false, NULL, 0 },
+	{ GAME_EVENT_CLIENT_ID, false, false, false, false, NClientId_fields, EVENT_SIZE_ALL },
+	{ GAME_EVENT_CAMPAIGN_DEF, false, false, false, false, NCampaignDef_fields, EVENT_SIZE_ALL },
+	{ GAME_EVENT_ASSET_DEF, false, false, false, false, NAssetDef_fields, EVENT_SIZE_ALL },
+	{ GAME_EVENT_PLAYER_DATA, true, false, true, false, NPlayerData_fields, EVENT_SIZE(PlayerData) },
+	{ GAME_EVENT_TILE_SET, true, false, true, true, NTileSet_fields, EVENT_SIZE(TileSet) },
+	{ GAME_EVENT_MAP_OBJECT_ADD, true, false, true, true, NMapObjectAdd_fields, EVENT_SIZE(MapObjectAdd) },
+	{ GAME_EVENT_MAP_OBJECT_DAMAGE, true, false, true, true, NMapObjectDamage_fields, EVENT_SIZE(MapObjectDamage) },
+	{ GAME_EVENT_CLIENT_READY, false, false, false, false, NULL, 0 },
+	{ GAME_EVENT_NET_GAME_START, false, false, false, false, NULL, 0 },
+
+	{ GAME_EVENT_SCORE, true, true, true, true, NULL, EVENT_SIZE(Score) },
+	{ GAME_EVENT_SOUND_AT, true, false, true, true, NSound_fields, EVENT_SIZE(SoundAt) },
+	{ GAME_EVENT_SCREEN_SHAKE, false, false, true, true, NULL, EVENT_SIZE(ShakeAmount) },
+	{ GAME_EVENT_SET_MESSAGE, false, false, true, true, NULL, EVENT_SIZE(SetMessage) },
+
+	{ GAME_EVENT_GAME_START, true, false, true, true, NULL, 0 },
+
+	{ GAME_EVENT_ACTOR_ADD, true, false, true, true, NActorAdd_fields, EVENT_SIZE(ActorAdd) },
+	{ GAME_EVENT_ACTOR_MOVE, true, true, true, true, NActorMove_fields, EVENT_SIZE(ActorMove) },
+	{ GAME_EVENT_ACTOR_STATE, true, true, true, true, NActorState_fields, EVENT_SIZE(ActorState) },
+	{ GAME_EVENT_ACTOR_DIR, true, true, true, true, NActorDir_fields, EVENT_SIZE(ActorDir) },
+	{ GAME_EVENT_ACTOR_SLIDE, true, true, true, true, NActorSlide_fields, EVENT_SIZE(ActorSlide) },
+	{ GAME_EVENT_ACTOR_IMPULSE, true, false, true, true, NActorImpulse_fields, EVENT_SIZE(ActorImpulse) },
+	{ GAME_EVENT_ACTOR_SWITCH_GUN, true, true, true, true, NActorSwitchGun_fields, EVENT_SIZE(ActorSwitchGun) },
+	{ GAME_EVENT_ACTOR_PICKUP_ALL, false, true, true, true, NActorPickupAll_fields, EVENT_SIZE(ActorPickupAll) },
+	{ GAME_EVENT_ACTOR_REPLACE_GUN, true, false, true, true, NActorReplaceGun_fields, EVENT_SIZE(ActorReplaceGun) },
+	{ GAME_EVENT_ACTOR_HEAL, true, false, true, true, NActorHeal_fields, EVENT_SIZE(Heal) },
+	{ GAME_EVENT_ACTOR_HIT, true, false, true, true, NActorHit_fields, EVENT_SIZE(ActorHit) },
+	{ GAME_EVENT_ACTOR_ADD_AMMO, true, false, true, true, NActorAddAmmo_fields, EVENT_SIZE(AddAmmo) },
+	{ GAME_EVENT_ACTOR_USE_AMMO, true, true, true, true, NActorUseAmmo_fields, EVENT_SIZE(UseAmmo) },
+	{ GAME_EVENT_ACTOR_DIE, true, false, true, true, NActorDie_fields, EVENT_SIZE(ActorDie) },
+	{ GAME_EVENT_ACTOR_MELEE, true, true, true, true, NActorMelee_fields, EVENT_SIZE(Melee) },
+
+	{ GAME_EVENT_ADD_PICKUP, true, false, true, true, NAddPickup_fields, EVENT_SIZE(AddPickup) },
+	{ GAME_EVENT_REMOVE_PICKUP, true, false, true, true, NRemovePickup_fields, EVENT_SIZE(RemovePickup) },
+
+	{ GAME_EVENT_BULLET_BOUNCE, true, false, true, true, NBulletBounce_fields, EVENT_SIZE(BulletBounce) },
+	{ GAME_EVENT_REMOVE_BULLET, true, false, true, true, NRemoveBullet_fields, EVENT_SIZE(RemoveBullet) },
+	{ GAME_EVENT_PARTICLE_REMOVE, false, false, true, true, NULL, EVENT_SIZE(ParticleRemoveId) },
+	{ GAME_EVENT_GUN_FIRE, true, true, true, true, NGunFire_fields, EVENT_SIZE(GunFire) },
+	{ GAME_EVENT_GUN_RELOAD, true, true, true, true, NGunReload_fields, EVENT_SIZE(GunReload) },
+	{ GAME_EVENT_GUN_STATE, true, true, true, true, NGunState_fields, EVENT_SIZE(GunState) },
+	{ GAME_EVENT_ADD_BULLET, true, false, true, true, NAddBullet_fields, EVENT_SIZE(AddBullet) },
+	{ GAME_EVENT_ADD_PARTICLE, false, false, true, true, NULL, EVENT_SIZE(AddParticle) },
+	{ GAME_EVENT_TRIGGER, true, false, true, true, NTrigger_fields, EVENT_SIZE(TriggerEvent) },
+	{ GAME_EVENT_EXPLORE_TILES, true, false, true, true, NExploreTiles_fields, EVENT_SIZE(ExploreTiles) },
+	{ GAME_EVENT_RESCUE_CHARACTER, true, false, true, true, NRescueCharacter_fields, EVENT_SIZE(Rescue) },
+	{ GAME_EVENT_OBJECTIVE_UPDATE, true, false, true, true, NObjectiveUpdate_fields, EVENT_SIZE(ObjectiveUpdate) },
+	{ GAME_EVENT_ADD_KEYS, true, false, true, true, NAddKeys_fields, EVENT_SIZE(AddKeys) },
+
+	{ GAME_EVENT_MISSION_COMPLETE, true, false, true, true, NMissionComplete_fields, EVENT_SIZE(MissionComplete) },
+
+	{ GAME_EVENT_MISSION_INCOMPLETE, true, false, true, true, NULL, 0 },
+	{ GAME_EVENT_MISSION_PICKUP, true, false, true, true, NULL, 0 },
+	{ GAME_EVENT_MISSION_END, true, false, true, true, NULL, 0 }
 };
 GameEventEntry GameEventGetEntry(const GameEventType e)
 {
 	return sGameEventEntries[(int)e];
 }
 
-void GameEventsEnqueue(CArray *store, GameEvent e)
+static void ListAppend(GameEventQueue *q, GameEventList *l, const GameEvent *e);
+void GameEventsEnqueue(GameEventQueue *q, const GameEvent *e)
 {
-	if (store->elemSize == 0)
+	if (!q->IsInitialized)
 	{
 		return;
 	}
 	// If we're the server, broadcast any events that clients need
 	// If we're the client, pass along to server, but only if it's for a local player
 	// Otherwise we'd ping-pong the same updates from the server
-	const GameEventEntry gee = sGameEventEntries[e.Type];
+	const GameEventEntry gee = sGameEventEntries[e->Type];
 	if (gee.Broadcast)
 	{
-		NetServerSendMsg(&gNetServer, NET_SERVER_BCAST, gee.Type, &e.u);
+		NetServerSendMsg(&gNetServer, NET_SERVER_BCAST, gee.Type, &e->u);
 	}
 	if (gee.Submit)
 	{
 		int actorUID = -1;
 		bool actorIsLocal = false;
-		switch (e.Type)
+		switch (e->Type)
 		{
-		case GAME_EVENT_ACTOR_MOVE: actorUID = e.u.ActorMove.UID; break;
-		case GAME_EVENT_ACTOR_STATE: actorUID = e.u.ActorState.UID; break;
-		case GAME_EVENT_ACTOR_DIR: actorUID = e.u.ActorDir.UID; break;
-		case GAME_EVENT_ACTOR_SLIDE: actorUID = e.u.ActorSlide.UID; break;
-		case GAME_EVENT_ACTOR_SWITCH_GUN: actorUID = e.u.ActorSwitchGun.UID; break;
-		case GAME_EVENT_ACTOR_PICKUP_ALL: actorUID = e.u.ActorPickupAll.UID; break;
-		case GAME_EVENT_ACTOR_USE_AMMO: actorUID = e.u.UseAmmo.UID; break;
-		case GAME_EVENT_ACTOR_MELEE: actorUID = e.u.Melee.UID; break;
+		case GAME_EVENT_ACTOR_MOVE: actorUID = e->u.ActorMove.UID; break;
+		case GAME_EVENT_ACTOR_STATE: actorUID = e->u.ActorState.UID; break;
+		case GAME_EVENT_ACTOR_DIR: actorUID = e->u.ActorDir.UID; break;
+		case GAME_EVENT_ACTOR_SLIDE: actorUID = e->u.ActorSlide.UID; break;
+		case GAME_EVENT_ACTOR_SWITCH_GUN: actorUID = e->u.ActorSwitchGun.UID; break;
+		case GAME_EVENT_ACTOR_PICKUP_ALL: actorUID = e->u.ActorPickupAll.UID; break;
+		case GAME_EVENT_ACTOR_USE_AMMO: actorUID = e->u.UseAmmo.UID; break;
+		case GAME_EVENT_ACTOR_MELEE: actorUID = e->u.Melee.UID; break;
 		case GAME_EVENT_GUN_FIRE:
-			if (e.u.GunFire.IsGun)
+			if (e->u.GunFire.IsGun)
 			{
-				actorIsLocal = PlayerIsLocal(e.u.GunFire.PlayerUID);
+				actorIsLocal = PlayerIsLocal(e->u.GunFire.PlayerUID);
 			}
 			break;
 		case GAME_EVENT_GUN_RELOAD:
-			actorIsLocal = PlayerIsLocal(e.u.GunReload.PlayerUID);
+			actorIsLocal = PlayerIsLocal(e->u.GunReload.PlayerUID);
 			break;
-		case GAME_EVENT_GUN_STATE: actorUID = e.u.GunState.ActorUID; break;
+		case GAME_EVENT_GUN_STATE: actorUID = e->u.GunState.ActorUID; break;
 		default: break;
 		}
 		if (actorUID >= 0)
@@ -160,20 +193,126 @@ void GameEventsEnqueue(CArray *store, GameEvent e)
 		}
 		if (actorIsLocal)
 		{
-			NetClientSendMsg(&gNetClient, gee.Type, &e.u);
+			NetClientSendMsg(&gNetClient, gee.Type, &e->u);
 		}
 	}
 
-	CArrayPushBack(store, &e);
+	if (e->Delay <= 0)
+	{
+		ListAppend(q, &q->Events, e);
+		return;
+	}
+	// Delays count the dispatch in progress, if any
+	const int frame = q->Frame + e->Delay + (q->IsDispatching ? 0 : 1);
+	CA_FOREACH(GameEventBucket, b, q->Delayed)
+		if (b->Frame == frame)
+		{
+			ListAppend(q, &b->Events, e);
+			return;
+		}
+	CA_FOREACH_END()
+	GameEventBucket b;
+	b.Frame = frame;
+	memset(&b.Events, 0, sizeof b.Events);
+	ListAppend(q, &b.Events, e);
+	CArrayPushBack(&q->Delayed, &b);
 }
-static bool EventComplete(const void *elem);
-void GameEventsClear(CArray *store)
+static size_t RecordSize(const GameEventType type)
 {
-	CArrayRemoveIf(store, EventComplete);
+	const size_t size =
+		offsetof(GameEvent, u) + sGameEventEntries[type].Size;
+	// Keep records aligned
+	return (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
 }
-static bool EventComplete(const void *elem)
+static void ListAppend(GameEventQueue *q, GameEventList *l, const GameEvent *e)
 {
-	return ((const GameEvent *)elem)->Delay < 0;
+	const size_t size = RecordSize(e->Type);
+	if (l->Tail == NULL || l->Tail->Used + size > GAME_EVENT_BLOCK_SIZE)
+	{
+		GameEventBlock *b = q->FreeBlocks;
+		if (b != NULL)
+		{
+			q->FreeBlocks = b->Next;
+		}
+		else
+		{
+			CMALLOC(b, sizeof *b);
+		}
+		b->Next = NULL;
+		b->Used = 0;
+		if (l->Tail == NULL)
+		{
+			l->Head = b;
+		}
+		else
+		{
+			l->Tail->Next = b;
+		}
+		l->Tail = b;
+	}
+	memcpy((char *)l->Tail->Data + l->Tail->Used, e, size);
+	l->Tail->Used += size;
+}
+static void ListRelease(GameEventQueue *q, GameEventList *l)
+{
+	if (l->Head != NULL)
+	{
+		l->Tail->Next = q->FreeBlocks;
+		q->FreeBlocks = l->Head;
+	}
+	l->Head = l->Tail = NULL;
+}
+
+void GameEventsClear(GameEventQueue *q)
+{
+	ListRelease(q, &q->Events);
+	CA_FOREACH(GameEventBucket, b, q->Delayed)
+		ListRelease(q, &b->Events);
+	CA_FOREACH_END()
+	CArrayClear(&q->Delayed);
+}
+
+// Handle every record in the list, including those appended by handlers
+static void ListDispatch(
+	const GameEventList *l, GameEventHandlerFunc handler, void *data)
+{
+	for (const GameEventBlock *b = l->Head; b != NULL; b = b->Next)
+	{
+		for (size_t offset = 0; offset < b->Used;)
+		{
+			const GameEvent *e =
+				(const GameEvent *)((const char *)b->Data + offset);
+			offset += RecordSize(e->Type);
+			handler(e, data);
+		}
+	}
+}
+void GameEventsDispatch(
+	GameEventQueue *q, GameEventHandlerFunc handler, void *data)
+{
+	if (q->IsDispatching)
+	{
+		// Already dispatching; new events are handled by the outer loop
+		return;
+	}
+	q->IsDispatching = true;
+	q->Frame++;
+	// Delayed events that are now due were enqueued before any of the
+	// undelayed ones, so handle them first
+	CA_FOREACH(GameEventBucket, b, q->Delayed)
+		if (b->Frame == q->Frame)
+		{
+			// Take the bucket out, as handlers may add buckets
+			GameEventList l = b->Events;
+			CArrayDelete(&q->Delayed, i);
+			ListDispatch(&l, handler, data);
+			ListRelease(q, &l);
+			break;
+		}
+	CA_FOREACH_END()
+	ListDispatch(&q->Events, handler, data);
+	ListRelease(q, &q->Events);
+	q->IsDispatching = false;
 }
 
 GameEvent GameEventNew(GameEventType type)
@@ -45,6 +45,7 @@ typedef enum
 	GAME_EVENT_CLIENT_CONNECT,
 	GAME_EVENT_CLIENT_ID,
 	GAME_EVENT_CAMPAIGN_DEF,
+	GAME_EVENT_ASSET_DEF,
 	GAME_EVENT_PLAYER_DATA,
 	GAME_EVENT_TILE_SET,
 	GAME_EVENT_MAP_OBJECT_ADD,
@@ -117,6 +118,8 @@ typedef struct
 	// Whether to broadcast these events only after game start
 	bool GameStart;
 	const pb_field_t *Fields;
+	// Size of the event's data in the GameEvent union
+	size_t Size;
 } GameEventEntry;
 GameEventEntry GameEventGetEntry(const GameEventType e);
 
@@ -177,11 +180,40 @@ typedef struct
 	} u;
 } GameEvent;
 
-extern CArray gGameEvents;	// of GameEvent
-
-void GameEventsInit(CArray *store);
-void GameEventsTerminate(CArray *store);
-void GameEventsEnqueue(CArray *store, GameEvent e);
-void GameEventsClear(CArray *store);
+// Game event queue
+// Events are copied into fixed-size blocks as records only as large as
+// their type's data, and handled in place. Blocks never move, so handlers
+// can safely enqueue more events, and are recycled through a free list.
+// Delayed events wait in buckets keyed by the frame they are due.
+typedef struct GameEventBlock GameEventBlock;
+typedef struct
+{
+	GameEventBlock *Head;
+	GameEventBlock *Tail;
+} GameEventList;
+typedef struct
+{
+	GameEventList Events;
+	CArray Delayed;	// of GameEventBucket
+	GameEventBlock *FreeBlocks;
+	// Number of times events have been dispatched
+	int Frame;
+	bool IsDispatching;
+	bool IsInitialized;
+} GameEventQueue;
+
+extern GameEventQueue gGameEvents;
+
+void GameEventsInit(GameEventQueue *q);
+void GameEventsTerminate(GameEventQueue *q);
+// Events with a Delay are handled that many dispatches later
+void GameEventsEnqueue(GameEventQueue *q, const GameEvent *e);
+// Discard all pending events
+void GameEventsClear(GameEventQueue *q);
+typedef void (*GameEventHandlerFunc)(const GameEvent *e, void *data);
+// Handle all events that are due, in the order they were enqueued,
+// including events enqueued by the handler itself
+void GameEventsDispatch(
+	GameEventQueue *q, GameEventHandlerFunc handler, void *data);
 
 GameEvent GameEventNew(GameEventType type);
@@ -37,6 +37,8 @@
 #include "net_server.h"
 #include "sounds.h"
 
+static ConfigHandle sConfigStartServer = CONFIG_HANDLE("StartServer");
+
 
 GameLoopData GameLoopDataNew(
 	void *updateData, GameLoopResult (*updateFunc)(void *),
@@ -75,7 +77,7 @@ void GameLoop(GameLoopData *data)
 			continue;
 		}
 
-		if (!gCampaign.IsClient && !ConfigGetBool(&gConfig, "StartServer"))
+		if (!gCampaign.IsClient && !ConfigHandleGetBool(&sConfigStartServer))
 		{
 			MusicSetPlaying(
 				&gSoundDevice, SDL_GetAppState() & SDL_APPINPUTFOCUS);
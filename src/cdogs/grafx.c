@@ -69,6 +69,9 @@
 
 GraphicsDevice gGraphicsDevice;
 
+// Beyond this many threads, flipping is limited by memory bandwidth
+#define FLIP_THREADS_MAX 8
+
 static void Gfx_ModeSet(const GraphicsMode *mode)
 {
 	ConfigGet(&gConfig, "Graphics.ResolutionWidth")->u.Int.Value = mode->Width;
@@ -177,7 +180,10 @@ void GraphicsInit(GraphicsDevice *device, Config *c)
 	AddGraphicsMode(device, 320, 240, 2);
 	device->buf = NULL;
 	device->bkg = NULL;
+	device->ScaleBuf = NULL;
 	hqxInit();
+	ThreadPoolInit(
+		&device->FlipThreads, MIN(ThreadPoolNumCPUs(), FLIP_THREADS_MAX));
 	GraphicsConfigSetFromConfig(&device->cachedConfig, c);
 }
 
@@ -299,10 +305,14 @@ void GraphicsInitialize(GraphicsDevice *g, const bool force)
 	LOG(LM_MAIN, LL_INFO, "graphics mode(%dx%d %dx) actual(%dx%d)",
 		w, h, g->cachedConfig.ScaleFactor, rw, rh);
 	SDL_FreeSurface(g->screen);
-	//g->screen = SDL_SetVideoMode(rw, rh, 16, sdl_flags);
+#ifdef __GCWZERO__
+	// Handhelds have a fixed 320x240 16-bit panel
 	g->ScreenSurface = SDL_SetVideoMode(320, 240, 16, SDL_HWSURFACE);
+#else
+	g->ScreenSurface = SDL_SetVideoMode(rw, rh, 0, sdl_flags);
+#endif
 	g->screen = SDL_CreateRGBSurface(SDL_SWSURFACE, rw, rh, 32, 0, 0, 0, 0);
-	if (g->screen == NULL)
+	if (g->ScreenSurface == NULL || g->screen == NULL)
 	{
 		printf("ERROR: InitVideo: %s\n", SDL_GetError());
 		return;
@@ -321,6 +331,12 @@ void GraphicsInitialize(GraphicsDevice *g, const bool force)
 	CCALLOC(g->buf, GraphicsGetMemSize(&g->cachedConfig));
 	CFREE(g->bkg);
 	CCALLOC(g->bkg, GraphicsGetMemSize(&g->cachedConfig));
+	CFREE(g->ScaleBuf);
+	g->ScaleBuf = NULL;
+	if (g->cachedConfig.ScaleFactor > 1)
+	{
+		CCALLOC(g->ScaleBuf, rw * rh * sizeof *g->ScaleBuf);
+	}
 
 	debug(D_NORMAL, "Changed video mode...\n");
 
@@ -344,6 +360,8 @@ void GraphicsTerminate(GraphicsDevice *device)
 	SDL_VideoQuit();
 	CFREE(device->buf);
 	CFREE(device->bkg);
+	CFREE(device->ScaleBuf);
+	ThreadPoolTerminate(&device->FlipThreads);
 }
 
 int GraphicsGetScreenSize(GraphicsConfig *config)
@@ -56,6 +56,7 @@
 #include "color.h"
 #include "config.h"
 #include "pic_file.h"
+#include "thread_pool.h"
 #include "vector.h"
 #include "sys_specifics.h"
 
@@ -100,6 +101,10 @@ typedef struct
 	int modeIndex;
 	Uint32 *buf;
 	Uint32 *bkg;
+	// Scaled frame, for scale modes that filter
+	Uint32 *ScaleBuf;
+	// Threads for scaling and converting the frame in bands
+	ThreadPool FlipThreads;
 } GraphicsDevice;
 
 extern GraphicsDevice gGraphicsDevice;
@@ -29,10 +29,11 @@
 
 #include "c_array.h"
 #include "camera.h"
+#include "game_events.h"
 #include "powerup.h"
 
 void HandleGameEvents(
-	CArray *store,
+	GameEventQueue *store,
 	Camera *camera,
 	PowerupSpawner *healthSpawner,
 	CArray *ammoSpawners);
@@ -63,6 +63,12 @@
 #include "mission.h"
 #include "pic_manager.h"
 
+static ConfigHandle sConfigAmmo = CONFIG_HANDLE("Game.Ammo");
+static ConfigHandle sConfigShowHUDMap = CONFIG_HANDLE("Interface.ShowHUDMap");
+static ConfigHandle sConfigSplitscreen = CONFIG_HANDLE("Interface.Splitscreen");
+static ConfigHandle sConfigShowFPS = CONFIG_HANDLE("Interface.ShowFPS");
+static ConfigHandle sConfigShowTime = CONFIG_HANDLE("Interface.ShowTime");
+
 
 // Total number of milliseconds that the numeric update lasts for
 #define NUM_UPDATE_TIMER_MS 500
@@ -365,7 +371,7 @@ static void DrawWeaponStatus(
 	opts.Area = gGraphicsDevice.cachedConfig.Res;
 	opts.Pad = Vec2iNew(pos.x + GUN_ICON_PAD, pos.y);
 	char buf[128];
-	if (ConfigGetBool(&gConfig, "Game.Ammo") && weapon->Gun->AmmoId >= 0)
+	if (ConfigHandleGetBool(&sConfigAmmo) && weapon->Gun->AmmoId >= 0)
 	{
 		// Include ammo counter
 		sprintf(buf, "%s %d/%d",
@@ -619,7 +625,7 @@ static void DrawPlayerStatus(
 	char s[50];
 	if (IsScoreNeeded(gCampaign.Entry.Mode))
 	{
-		if (ConfigGetBool(&gConfig, "Game.Ammo"))
+		if (ConfigHandleGetBool(&sConfigAmmo))
 		{
 			// Display money instead of ammo
 			sprintf(s, "Cash: $%d", data->score);
@@ -657,7 +663,7 @@ static void DrawPlayerStatus(
 		FontStrOpt(s, Vec2iZero(), opts);
 	}
 
-	if (ConfigGetBool(&gConfig, "Interface.ShowHUDMap") &&
+	if (ConfigHandleGetBool(&sConfigShowHUDMap) &&
 		!(flags & HUDFLAGS_SHARE_SCREEN) &&
 		IsAutoMapEnabled(gCampaign.Entry.Mode))
 	{
@@ -852,7 +858,7 @@ void HUDDraw(HUD *hud, const input_device_e pausingDevice)
 		flags = 0;
 	}
 	else if (
-		ConfigGetEnum(&gConfig, "Interface.Splitscreen") == SPLITSCREEN_NEVER)
+		ConfigHandleGetEnum(&sConfigSplitscreen) == SPLITSCREEN_NEVER)
 	{
 		flags |= HUDFLAGS_SHARE_SCREEN;
 	}
@@ -904,7 +910,7 @@ void HUDDraw(HUD *hud, const input_device_e pausingDevice)
 		DrawAmmoUpdate(&hud->ammoUpdates[idx], drawFlags);
 	}
 	// Only draw radar once if shared
-	if (ConfigGetBool(&gConfig, "Interface.ShowHUDMap") &&
+	if (ConfigHandleGetBool(&sConfigShowHUDMap) &&
 		(flags & HUDFLAGS_SHARE_SCREEN) &&
 		IsAutoMapEnabled(gCampaign.Entry.Mode))
 	{
@@ -972,11 +978,11 @@ void HUDDraw(HUD *hud, const input_device_e pausingDevice)
 		FontStrMask(hud->message, pos, colorCyan);
 	}
 
-	if (ConfigGetBool(&gConfig, "Interface.ShowFPS"))
+	if (ConfigHandleGetBool(&sConfigShowFPS))
 	{
 		FPSCounterDraw(&hud->fpsCounter);
 	}
-	if (ConfigGetBool(&gConfig, "Interface.ShowTime"))
+	if (ConfigHandleGetBool(&sConfigShowTime))
 	{
 		WallClockDraw(&hud->clock);
 	}
@@ -54,8 +54,9 @@ void AddStringPair(json_t *parent, const char *name, const char *s)
 	}
 	else
 	{
-		json_insert_pair_into_object(
-			parent, name, json_new_string(json_escape(s)));
+		char *escaped = json_escape(s);
+		json_insert_pair_into_object(parent, name, json_new_string(escaped));
+		CFREE(escaped);
 	}
 }
 void AddColorPair(json_t *parent, const char *name, const color_t c)
@@ -59,11 +59,16 @@ void KeyInit(keyboard_t *keyboard)
 	keyboard->ticks = 0;
 	keyboard->repeatedTicks = 0;
 	keyboard->isFirstRepeat = 1;
+	KeyOnConfigApply(&gConfig, keyboard);
+}
+void KeyOnConfigApply(Config *c, void *data)
+{
+	keyboard_t *keyboard = data;
 	for (int i = 0; i < MAX_KEYBOARD_CONFIGS; i++)
 	{
 		char buf[256];
 		sprintf(buf, "Input.PlayerKeys%d", i);
-		KeyLoadPlayerKeys(&keyboard->PlayerKeys[i], ConfigGet(&gConfig, buf));
+		KeyLoadPlayerKeys(&keyboard->PlayerKeys[i], ConfigGet(c, buf));
 	}
 }
 void KeyLoadPlayerKeys(input_keys_t *keys, Config *c)
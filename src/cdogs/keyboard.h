@@ -79,6 +79,8 @@ typedef struct
 
 void KeyInit(keyboard_t *keyboard);
 void KeyLoadPlayerKeys(input_keys_t *keys, Config *c);
+// ConfigApplyFunc; reloads the player keys, data is keyboard_t *
+void KeyOnConfigApply(Config *c, void *data);
 void KeyPrePoll(keyboard_t *keyboard);
 void KeyOnKeyDown(keyboard_t *keyboard, SDL_keysym s);
 void KeyOnKeyUp(keyboard_t *keyboard, SDL_keysym s);
@@ -27,57 +27,233 @@
 */
 #include "los.h"
 
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "algorithms.h"
 #include "game_events.h"
 #include "net_util.h"
 
+static ConfigHandle sConfigSightRange = CONFIG_HANDLE("Game.SightRange");
+
+#define BIT_WORD(_x) ((_x) >> 5)
+#define BIT_MASK(_x) (1u << ((_x) & 31))
+
 
+static void BoxReset(Vec2i *min, Vec2i *max);
+static void SetBit(CArray *bits, const int stride, const Vec2i v, const bool set);
 void LOSInit(Map *map, const Vec2i size)
 {
-	CArrayInit(&map->LOS.LOS, sizeof(bool));
-	CArrayInit(&map->LOS.Explored, sizeof(bool));
+	LineOfSight *los = &map->LOS;
+	los->Stride = BIT_WORD(size.x + 31);
+	const int numWords = los->Stride * size.y;
+	const Uint32 zero = 0;
+	CArrayInit(&los->BlocksSight, sizeof(Uint32));
+	CArrayResize(&los->BlocksSight, numWords, &zero);
+	CArrayInit(&los->Visited, sizeof(Uint32));
+	CArrayResize(&los->Visited, numWords, &zero);
+	CArrayInit(&los->LOS, sizeof(Uint32));
+	CArrayResize(&los->LOS, numWords, &zero);
+	CArrayInit(&los->Explored, sizeof(Uint32));
+	CArrayResize(&los->Explored, numWords, &zero);
+	BoxReset(&los->LOSMin, &los->LOSMax);
+	BoxReset(&los->ExploredMin, &los->ExploredMax);
 	Vec2i v;
 	for (v.y = 0; v.y < size.y; v.y++)
 	{
 		for (v.x = 0; v.x < size.x; v.x++)
 		{
-			const bool f = false;
-			CArrayPushBack(&map->LOS.LOS, &f);
-			CArrayPushBack(&map->LOS.Explored, &f);
+			const Tile *t = MapGetTile(map, v);
+			SetBit(
+				&los->BlocksSight, los->Stride, v, t->flags & MAPTILE_NO_SEE);
+			SetBit(&los->Visited, los->Stride, v, t->isVisited);
 		}
 	}
+	los->Kernel = LOS_KERNEL_SHADOWCAST;
+	for (int i = 0; i < LOS_VIEWERS_MAX; i++)
+	{
+		LOSViewer *lv = &los->Viewers[i];
+		memset(lv, 0, sizeof *lv);
+		CArrayInit(&lv->Bits, sizeof(Uint32));
+	}
+	los->Ticks = 0;
 }
 void LOSTerminate(LineOfSight *los)
 {
+	CArrayTerminate(&los->BlocksSight);
+	CArrayTerminate(&los->Visited);
 	CArrayTerminate(&los->LOS);
 	CArrayTerminate(&los->Explored);
+	for (int i = 0; i < LOS_VIEWERS_MAX; i++)
+	{
+		CArrayTerminate(&los->Viewers[i].Bits);
+	}
+}
+
+static bool TestBit(const CArray *bits, const int stride, const Vec2i v)
+{
+	return ((const Uint32 *)bits->data)[v.y * stride + BIT_WORD(v.x)] &
+		BIT_MASK(v.x);
+}
+static void SetBit(CArray *bits, const int stride, const Vec2i v, const bool set)
+{
+	Uint32 *w = (Uint32 *)bits->data + v.y * stride + BIT_WORD(v.x);
+	if (set)
+	{
+		*w |= BIT_MASK(v.x);
+	}
+	else
+	{
+		*w &= ~BIT_MASK(v.x);
+	}
+}
+// Bounding boxes are inclusive; an empty box has min > max
+static void BoxReset(Vec2i *min, Vec2i *max)
+{
+	*min = Vec2iNew(INT_MAX, INT_MAX);
+	*max = Vec2iNew(-1, -1);
+}
+static void BoxAdd(Vec2i *min, Vec2i *max, const Vec2i boxMin, const Vec2i boxMax)
+{
+	*min = Vec2iMin(*min, boxMin);
+	*max = Vec2iMax(*max, boxMax);
+}
+static void ClearBox(
+	CArray *bits, const int stride, Vec2i *min, Vec2i *max)
+{
+	for (int y = min->y; y <= max->y; y++)
+	{
+		memset(
+			(Uint32 *)bits->data + y * stride + min->x, 0,
+			(max->x - min->x + 1) * sizeof(Uint32));
+	}
+	BoxReset(min, max);
 }
 
 // Reset lines of sight by setting all cells to unseen
+// Only the words that were set are cleared
 void LOSReset(LineOfSight *los)
 {
-	CArrayFillZero(&los->LOS);
-	CArrayFillZero(&los->Explored);
+	ClearBox(&los->LOS, los->Stride, &los->LOSMin, &los->LOSMax);
+	ClearBox(
+		&los->Explored, los->Stride, &los->ExploredMin, &los->ExploredMax);
 }
+
+void LOSOnTileChanged(Map *map, const Vec2i tile)
+{
+	LineOfSight *los = &map->LOS;
+	SetBit(
+		&los->BlocksSight, los->Stride, tile,
+		MapGetTile(map, tile)->flags & MAPTILE_NO_SEE);
+	for (int i = 0; i < LOS_VIEWERS_MAX; i++)
+	{
+		LOSViewer *v = &los->Viewers[i];
+		// Include an extra tile for the adjacent obstructions pass
+		const int range = v->SightRange + 1;
+		if (v->IsValid &&
+			abs(tile.x - v->Pos.x) <= range && abs(tile.y - v->Pos.y) <= range)
+		{
+			v->IsValid = false;
+		}
+	}
+}
+void LOSOnTileVisited(LineOfSight *los, const Vec2i tile)
+{
+	SetBit(&los->Visited, los->Stride, tile, true);
+}
+
 typedef struct
 {
 	Map *Map;
+	LOSViewer *Viewer;
 	Vec2i Center;
+	int SightRange;
 	int SightRange2;
-	bool Explore;
 } LOSData;
+static LOSViewer *FindViewer(
+	LineOfSight *los, const Vec2i pos, const int sightRange);
+static LOSViewer *CalcViewer(Map *map, const Vec2i pos, const int sightRange);
+static void ApplyViewer(Map *map, const LOSViewer *v, const bool explore);
+static void EnqueueExploreEvents(Map *map);
 // Calculate LOS cells from a certain start position
 // Sight range based on config
-static void SetLOSVisible(Map *map, const Vec2i pos, const bool explore);
-static bool IsNextTileBlockedAndSetVisibility(void *data, Vec2i pos);
-static void SetObstructionVisible(
-	Map *map, const Vec2i pos, const bool explore);
+// The visible cells are cached per viewer position, so they are only
+// recalculated when the viewer moves to another tile
 void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore)
 {
-	// Perform LOS by casting rays from the centre to the edges, terminating
-	// whenever an obstruction or out-of-range is reached.
+	LineOfSight *los = &map->LOS;
+	const int sightRange = ConfigHandleGetInt(&sConfigSightRange);
+	los->Ticks++;
+	LOSViewer *v = FindViewer(los, pos, sightRange);
+	if (v == NULL)
+	{
+		v = CalcViewer(map, pos, sightRange);
+	}
+	v->LastUsed = los->Ticks;
+
+	ApplyViewer(map, v, explore);
+
+	// Find all the newly visible tiles and set events for them
+	EnqueueExploreEvents(map);
+}
+static LOSViewer *FindViewer(
+	LineOfSight *los, const Vec2i pos, const int sightRange)
+{
+	for (int i = 0; i < LOS_VIEWERS_MAX; i++)
+	{
+		LOSViewer *v = &los->Viewers[i];
+		if (v->IsValid &&
+			v->SightRange == sightRange && Vec2iEqual(v->Pos, pos))
+		{
+			return v;
+		}
+	}
+	return NULL;
+}
+static void CalcShadowcast(LOSData *data);
+static void CalcRays(LOSData *data);
+static void AddViewerTile(LOSData *data, const Vec2i pos);
+static LOSViewer *CalcViewer(Map *map, const Vec2i pos, const int sightRange)
+{
+	LineOfSight *los = &map->LOS;
+	// Use a free viewer slot, or replace the least recently used
+	LOSViewer *v = NULL;
+	for (int i = 0; i < LOS_VIEWERS_MAX; i++)
+	{
+		LOSViewer *candidate = &los->Viewers[i];
+		if (!candidate->IsValid)
+		{
+			v = candidate;
+			break;
+		}
+		if (v == NULL || candidate->LastUsed < v->LastUsed)
+		{
+			v = candidate;
+		}
+	}
+	v->Pos = pos;
+	v->SightRange = sightRange;
+	v->IsValid = true;
+	// Cover the sight range plus a margin of one tile, clipped to the map
+	const int margin = sightRange + 1;
+	v->Min = Vec2iNew(
+		BIT_WORD(MAX(0, pos.x - margin)), MAX(0, pos.y - margin));
+	v->Max = Vec2iNew(
+		BIT_WORD(MIN(map->Size.x - 1, pos.x + margin)),
+		MIN(map->Size.y - 1, pos.y + margin));
+	const Uint32 zero = 0;
+	CArrayClear(&v->Bits);
+	CArrayResize(
+		&v->Bits,
+		(v->Max.x - v->Min.x + 1) * (v->Max.y - v->Min.y + 1), &zero);
 
-	CArrayFillZero(&map->LOS.Explored);
+	LOSData data;
+	data.Map = map;
+	data.Viewer = v;
+	data.Center = pos;
+	data.SightRange = sightRange;
+	data.SightRange2 = sightRange * sightRange;
 
 	// First mark center tile and all adjacent tiles as visible
 	// +-+-+-+
@@ -92,28 +268,148 @@ void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore)
 	{
 		for (end.y = pos.y - 1; end.y <= pos.y + 1; end.y++)
 		{
-			SetLOSVisible(map, end, explore);
+			AddViewerTile(&data, end);
 		}
 	}
 
-	const int sightRange = ConfigGetInt(&gConfig, "Game.SightRange");
-	if (sightRange == 0) return;
+	if (sightRange == 0) return v;
 
+	switch (los->Kernel)
+	{
+	case LOS_KERNEL_SHADOWCAST:
+		CalcShadowcast(&data);
+		break;
+	case LOS_KERNEL_RAYS:
+		CalcRays(&data);
+		break;
+	default:
+		CASSERT(false, "unknown LOS kernel");
+		break;
+	}
+	return v;
+}
+static bool IsInMap(const Map *map, const Vec2i pos)
+{
+	return pos.x >= 0 && pos.x < map->Size.x &&
+		pos.y >= 0 && pos.y < map->Size.y;
+}
+// Whether a tile blocks sight; tiles outside the map also block sight
+static bool IsBlocked(const Map *map, const Vec2i pos)
+{
+	return !IsInMap(map, pos) ||
+		TestBit(&map->LOS.BlocksSight, map->LOS.Stride, pos);
+}
+static Uint32 *GetViewerWord(const LOSData *data, const Vec2i pos)
+{
+	const LOSViewer *v = data->Viewer;
+	return (Uint32 *)v->Bits.data +
+		(pos.y - v->Min.y) * (v->Max.x - v->Min.x + 1) +
+		BIT_WORD(pos.x) - v->Min.x;
+}
+static bool IsViewerTile(const LOSData *data, const Vec2i pos)
+{
+	return *GetViewerWord(data, pos) & BIT_MASK(pos.x);
+}
+static void AddViewerTile(LOSData *data, const Vec2i pos)
+{
+	if (!IsInMap(data->Map, pos)) return;
+	*GetViewerWord(data, pos) |= BIT_MASK(pos.x);
+}
+
+// Recursive shadowcasting, scanning each octant row by row and recursing
+// whenever a run of obstructions starts, see
+// http://www.roguebasin.com/index.php?title=FOV_using_recursive_shadowcasting
+// Transforms from octant coordinates: xx, xy, yx, yy
+static const int sOctants[8][4] =
+{
+	{ 1, 0, 0, 1 },
+	{ 0, 1, 1, 0 },
+	{ 0, -1, 1, 0 },
+	{ -1, 0, 0, 1 },
+	{ -1, 0, 0, -1 },
+	{ 0, -1, -1, 0 },
+	{ 0, 1, -1, 0 },
+	{ 1, 0, 0, -1 }
+};
+static void CastLight(
+	LOSData *data, const int row, float start, const float end,
+	const int *octant);
+static void CalcShadowcast(LOSData *data)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		CastLight(data, 1, 1.0f, 0.0f, sOctants[i]);
+	}
+}
+static void CastLight(
+	LOSData *data, const int row, float start, const float end,
+	const int *octant)
+{
+	if (start < end) return;
+	float newStart = 0.0f;
+	for (int j = row; j <= data->SightRange; j++)
+	{
+		bool blocked = false;
+		const int dy = -j;
+		for (int dx = -j; dx <= 0; dx++)
+		{
+			const float lSlope = (dx - 0.5f) / (dy + 0.5f);
+			const float rSlope = (dx + 0.5f) / (dy - 0.5f);
+			if (start < rSlope) continue;
+			if (end > lSlope) break;
+
+			const Vec2i pos = Vec2iNew(
+				data->Center.x + dx * octant[0] + dy * octant[1],
+				data->Center.y + dx * octant[2] + dy * octant[3]);
+			if (dx * dx + dy * dy < data->SightRange2)
+			{
+				AddViewerTile(data, pos);
+			}
+			const bool isBlocked = IsBlocked(data->Map, pos);
+			if (blocked)
+			{
+				if (isBlocked)
+				{
+					// Still in a run of obstructions
+					newStart = rSlope;
+				}
+				else
+				{
+					// End of obstructions; continue scanning this row
+					blocked = false;
+					start = newStart;
+				}
+			}
+			else if (isBlocked && j < data->SightRange)
+			{
+				// Start of obstructions; scan the unobstructed part of
+				// the next rows, then continue past the obstructions
+				blocked = true;
+				CastLight(data, j + 1, start, lSlope, octant);
+				newStart = rSlope;
+			}
+		}
+		if (blocked) break;
+	}
+}
+
+// Cast rays from the centre to the edges, terminating
+// whenever an obstruction or out-of-range is reached.
+static bool IsNextTileBlockedAndSetVisibility(void *data, Vec2i pos);
+static void SetObstructionVisible(LOSData *data, const Vec2i pos);
+static void CalcRays(LOSData *data)
+{
+	const Vec2i pos = data->Center;
+	const int sightRange = data->SightRange;
 	// Limit the perimeter to the sight range
 	const Vec2i origin = Vec2iNew(pos.x - sightRange, pos.y - sightRange);
 	const Vec2i perimSize = Vec2iScale(Vec2iMinus(pos, origin), 2);
 
-	LOSData data;
-	data.Map = map;
-	data.Center = pos;
-	data.SightRange2 = sightRange * sightRange;
-	data.Explore = explore;
-
 	// Start from the top-left cell, and proceed clockwise around
-	end = origin;
+	Vec2i end = origin;
 	HasClearLineData lineData;
 	lineData.IsBlocked = IsNextTileBlockedAndSetVisibility;
-	lineData.data = &data;
+	lineData.data = data;
 	// Top edge
 	for (; end.x < origin.x + perimSize.x; end.x++)
 	{
@@ -142,56 +438,18 @@ void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore)
 	{
 		for (end.x = origin.x; end.x < origin.x + perimSize.x; end.x++)
 		{
-			const Tile *tile = MapGetTile(map, end);
-			if (!tile || !(tile->flags & MAPTILE_NO_SEE))
+			if (!IsInMap(data->Map, end) || !IsBlocked(data->Map, end))
 			{
 				continue;
 			}
 			// Check sight range
-			if (DistanceSquared(pos, end) >= data.SightRange2)
+			if (DistanceSquared(pos, end) >= data->SightRange2)
 			{
 				continue;
 			}
-			SetObstructionVisible(map, end, explore);
-		}
-	}
-
-	// Find all the newly visible tiles and set events for them
-	GameEvent e = GameEventNew(GAME_EVENT_EXPLORE_TILES);
-	e.u.ExploreTiles.Runs_count = 0;
-	e.u.ExploreTiles.Runs[0].Run = 0;
-	bool run = false;
-	for (end.y = 0; end.y < map->Size.y; end.y++)
-	{
-		for (end.x = 0; end.x < map->Size.x; end.x++)
-		{
-			if (LOSAddRun(
-				&e.u.ExploreTiles, &run, end,
-				*((bool *)CArrayGet(&map->LOS.Explored, end.y * map->Size.x + end.x))))
-			{
-				GameEventsEnqueue(&gGameEvents, e);
-				e.u.ExploreTiles.Runs_count = 0;
-				e.u.ExploreTiles.Runs[0].Run = 0;
-				run = false;
-			}
+			SetObstructionVisible(data, end);
 		}
 	}
-	if (e.u.ExploreTiles.Runs_count > 0)
-	{
-		GameEventsEnqueue(&gGameEvents, e);
-	}
-	CArrayFillZero(&map->LOS.Explored);
-}
-static void SetLOSVisible(Map *map, const Vec2i pos, const bool explore)
-{
-	const Tile *t = MapGetTile(map, pos);
-	if (t == NULL) return;
-	*((bool *)CArrayGet(&map->LOS.LOS, pos.y * map->Size.x + pos.x)) = true;
-	if (!t->isVisited && explore)
-	{
-		// Cache the newly explored tile
-		*((bool *)CArrayGet(&map->LOS.Explored, pos.y * map->Size.x + pos.x)) = true;
-	}
 }
 static bool IsNextTileBlockedAndSetVisibility(void *data, Vec2i pos)
 {
@@ -199,34 +457,101 @@ static bool IsNextTileBlockedAndSetVisibility(void *data, Vec2i pos)
 	// Check sight range
 	if (DistanceSquared(lData->Center, pos) >= lData->SightRange2) return true;
 	// Check map range
-	const Tile *t = MapGetTile(lData->Map, pos);
-	if (t == NULL) return true;
-	SetLOSVisible(lData->Map, pos, lData->Explore);
+	if (!IsInMap(lData->Map, pos)) return true;
+	AddViewerTile(lData, pos);
 	// Check if this tile is an obstruction
-	return t->flags & MAPTILE_NO_SEE;
+	return IsBlocked(lData->Map, pos);
 }
-static bool IsTileVisibleNonObstruction(Map *map, const Vec2i pos);
-static void SetObstructionVisible(
-	Map *map, const Vec2i pos, const bool explore)
+static void SetObstructionVisible(LOSData *data, const Vec2i pos)
 {
 	Vec2i d;
 	for (d.x = -1; d.x < 2; d.x++)
 	{
 		for (d.y = -1; d.y < 2; d.y++)
 		{
-			if (IsTileVisibleNonObstruction(map, Vec2iAdd(pos, d)))
+			const Vec2i v = Vec2iAdd(pos, d);
+			if (!IsBlocked(data->Map, v) && IsViewerTile(data, v))
 			{
-				SetLOSVisible(map, pos, explore);
+				AddViewerTile(data, pos);
 				return;
 			}
 		}
 	}
 }
-static bool IsTileVisibleNonObstruction(Map *map, const Vec2i pos)
+
+// Add the viewer's tiles to the line of sight, a word at a time
+static void ApplyViewer(Map *map, const LOSViewer *v, const bool explore)
 {
-	const Tile *t = MapGetTile(map, pos);
-	if (t == NULL) return false;
-	return !(t->flags & MAPTILE_NO_SEE) && LOSTileIsVisible(map, pos);
+	LineOfSight *los = &map->LOS;
+	Uint32 *losWords = los->LOS.data;
+	const Uint32 *visited = los->Visited.data;
+	Uint32 *explored = los->Explored.data;
+	const Uint32 *bits = v->Bits.data;
+	for (int y = v->Min.y; y <= v->Max.y; y++)
+	{
+		for (int x = v->Min.x; x <= v->Max.x; x++, bits++)
+		{
+			const int i = y * los->Stride + x;
+			losWords[i] |= *bits;
+			if (!explore) continue;
+			const Uint32 newlyExplored = *bits & ~visited[i] & ~explored[i];
+			if (newlyExplored)
+			{
+				explored[i] |= newlyExplored;
+				BoxAdd(
+					&los->ExploredMin, &los->ExploredMax,
+					Vec2iNew(x, y), Vec2iNew(x, y));
+			}
+		}
+	}
+	BoxAdd(&los->LOSMin, &los->LOSMax, v->Min, v->Max);
+}
+
+static void EnqueueExploreEvents(Map *map)
+{
+	LineOfSight *los = &map->LOS;
+	// Only scan the bounding box of the newly explored tiles
+	if (los->ExploredMin.y > los->ExploredMax.y) return;
+
+	GameEvent e = GameEventNew(GAME_EVENT_EXPLORE_TILES);
+	e.u.ExploreTiles.Runs_count = 0;
+	e.u.ExploreTiles.Runs[0].Run = 0;
+	bool run = false;
+	const Uint32 *explored = los->Explored.data;
+	Vec2i end;
+	for (end.y = los->ExploredMin.y; end.y <= los->ExploredMax.y; end.y++)
+	{
+		// Go one past the bounding box to end any runs on this row
+		const int xEnd = MIN(map->Size.x, (los->ExploredMax.x + 1) * 32);
+		for (end.x = los->ExploredMin.x * 32; end.x <= xEnd; end.x++)
+		{
+			bool isExplored = false;
+			if (end.x < xEnd)
+			{
+				const Uint32 w = explored[end.y * los->Stride + BIT_WORD(end.x)];
+				if (w == 0 && !run)
+				{
+					// Skip empty words
+					end.x |= 31;
+					continue;
+				}
+				isExplored = w & BIT_MASK(end.x);
+			}
+			if (LOSAddRun(&e.u.ExploreTiles, &run, end, isExplored))
+			{
+				GameEventsEnqueue(&gGameEvents, &e);
+				e.u.ExploreTiles.Runs_count = 0;
+				e.u.ExploreTiles.Runs[0].Run = 0;
+				run = false;
+			}
+		}
+	}
+	if (e.u.ExploreTiles.Runs_count > 0)
+	{
+		GameEventsEnqueue(&gGameEvents, &e);
+	}
+	ClearBox(
+		&los->Explored, los->Stride, &los->ExploredMin, &los->ExploredMax);
 }
 
 bool LOSAddRun(
@@ -259,6 +584,6 @@ bool LOSAddRun(
 
 bool LOSTileIsVisible(Map *map, const Vec2i pos)
 {
-	if (MapGetTile(map, pos) == NULL) return false;
-	return *((bool *)CArrayGet(&map->LOS.LOS, pos.y * map->Size.x + pos.x));
+	if (!IsInMap(map, pos)) return false;
+	return TestBit(&map->LOS.LOS, map->LOS.Stride, pos);
 }
@@ -36,6 +36,10 @@ void LOSInit(Map *map, const Vec2i size);
 void LOSTerminate(LineOfSight *los);
 void LOSReset(LineOfSight *los);
 void LOSCalcFrom(Map *map, const Vec2i pos, const bool explore);
+// Update the tile's sight-blocking flag and invalidate cached lines of sight
+// that could be affected by it
+void LOSOnTileChanged(Map *map, const Vec2i tile);
+void LOSOnTileVisited(LineOfSight *los, const Vec2i tile);
 
 // Helper function for populating explore tiles runs
 // Returns true if the runs have filled
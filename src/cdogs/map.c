@@ -54,15 +54,19 @@
 
 #include "algorithms.h"
 #include "ammo.h"
+#include "automap.h"
 #include "collision.h"
 #include "config.h"
 #include "door.h"
+#include "floor_cache.h"
+#include "flow_field.h"
 #include "game_events.h"
 #include "gamedata.h"
 #include "los.h"
 #include "map_build.h"
 #include "map_classic.h"
 #include "map_static.h"
+#include "net_assets.h"
 #include "net_util.h"
 #include "pic_manager.h"
 #include "pickup.h"
@@ -149,13 +153,22 @@ bool MapIsTileInExit(const Map *map, const TTileItem *ti)
 		ti->y / TILE_HEIGHT <= map->ExitEnd.y;
 }
 
-static Tile *MapGetTileOfItem(Map *map, TTileItem *t)
+static CArray *MapGetCollisionCell(Map *map, const Vec2i pos)
 {
-	Vec2i pos = Vec2iToTile(Vec2iNew(t->x, t->y));
-	return MapGetTile(map, pos);
+	return CArrayGet(&map->CollisionCells, pos.y * map->Size.x + pos.x);
+}
+static CollisionProxy *FindCollisionProxy(CArray *cell, const TTileItem *t)
+{
+	CA_FOREACH(CollisionProxy, cp, *cell)
+		if (cp->Id.Id == t->id && cp->Id.Kind == t->kind)
+		{
+			return cp;
+		}
+	CA_FOREACH_END()
+	return NULL;
 }
 
-static void AddItemToTile(TTileItem *t, Tile *tile);
+static void AddItemToTile(Map *map, TTileItem *t, const Vec2i tilePos);
 bool MapTryMoveTileItem(Map *map, TTileItem *t, Vec2i pos)
 {
 	// Check if we can move to new position
@@ -172,6 +185,10 @@ bool MapTryMoveTileItem(Map *map, TTileItem *t, Vec2i pos)
 	{
 		t->x = pos.x;
 		t->y = pos.y;
+		CollisionProxy *cp =
+			FindCollisionProxy(MapGetCollisionCell(map, t2), t);
+		CASSERT(cp != NULL, "cannot find collision proxy");
+		cp->Pos = pos;
 		return true;
 	}
 	// Moving; remove from old tile...
@@ -182,11 +199,12 @@ bool MapTryMoveTileItem(Map *map, TTileItem *t, Vec2i pos)
 	// ...move and add to new tile
 	t->x = pos.x;
 	t->y = pos.y;
-	AddItemToTile(t, MapGetTile(map, t2));
+	AddItemToTile(map, t, t2);
 	return true;
 }
-static void AddItemToTile(TTileItem *t, Tile *tile)
+static void AddItemToTile(Map *map, TTileItem *t, const Vec2i tilePos)
 {
+	Tile *tile = MapGetTile(map, tilePos);
 	// Lazy initialisation
 	if (tile->things.elemSize == 0)
 	{
@@ -198,6 +216,12 @@ static void AddItemToTile(TTileItem *t, Tile *tile)
 	CASSERT(tid.Id >= 0, "invalid ThingId");
 	CASSERT(tid.Kind >= 0 && tid.Kind <= KIND_PICKUP, "unknown thing kind");
 	CArrayPushBack(&tile->things, &tid);
+
+	CollisionProxy cp;
+	cp.Id = tid;
+	cp.Pos = Vec2iNew(t->x, t->y);
+	cp.Size = t->size;
+	CArrayPushBack(MapGetCollisionCell(map, tilePos), &cp);
 }
 
 void MapRemoveTileItem(Map *map, TTileItem *t)
@@ -206,13 +230,16 @@ void MapRemoveTileItem(Map *map, TTileItem *t)
 	{
 		return;
 	}
-	Tile *tile = MapGetTileOfItem(map, t);
+	const Vec2i tilePos = Vec2iToTile(Vec2iNew(t->x, t->y));
+	Tile *tile = MapGetTile(map, tilePos);
 	for (int i = 0; i < (int)tile->things.size; i++)
 	{
 		ThingId *tid = CArrayGet(&tile->things, i);
 		if (tid->Id == t->id && tid->Kind == t->kind)
 		{
 			CArrayDelete(&tile->things, i);
+			// Proxies are kept in the same order as the tile's things
+			CArrayDelete(MapGetCollisionCell(map, tilePos), i);
 			return;
 		}
 	}
@@ -268,6 +295,7 @@ void MapChangeFloor(
 		{
 			t->pic = normal;
 		}
+		FloorCacheOnTileChanged(map, pos);
 		break;
 	default:
 		// do nothing
@@ -421,7 +449,7 @@ bool MapTryPlaceOneObject(
 
 	NMapObjectAdd amo = NMapObjectAdd_init_default;
 	amo.UID = ObjsGetNextUID();
-	strcpy(amo.MapObjectClass, mo->Name);
+	amo.MapObjectId = NetAssetsMapObjectId(mo);
 	amo.Pos = Vec2i2Net(realPos);
 	amo.TileItemFlags = tileFlags | extraFlags;
 	amo.Health = mo->Health;
@@ -440,7 +468,7 @@ void MapPlaceWreck(Map *map, const Vec2i v, const MapObject *mo)
 	}
 	NMapObjectAdd amo = NMapObjectAdd_init_default;
 	amo.UID = ObjsGetNextUID();
-	strcpy(amo.MapObjectClass, mo->Name);
+	amo.MapObjectId = NetAssetsMapObjectId(mo);
 	amo.Pos = Vec2i2Net(Vec2iCenterOfTile(v));
 	amo.TileItemFlags = TILEITEM_IS_WRECK;
 	// Set health to 0 to force into a wreck
@@ -471,7 +499,7 @@ void MapPlaceCollectible(
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = ObjectiveToTileItem(objective);
 	e.u.AddPickup.Pos = Vec2i2Net(realPos);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 static int MapTryPlaceCollectible(
 	Map *map, const Mission *mission, const struct MissionOptions *mo,
@@ -559,7 +587,7 @@ void MapPlaceKey(
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = 0;
 	e.u.AddPickup.Pos = Vec2i2Net(Vec2iCenterOfTile(pos));
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 static void MapPlaceCard(Map *map, int keyIndex, int map_access)
@@ -668,8 +696,15 @@ void MapTerminate(Map *map)
 	}
 	CArrayTerminate(&map->Tiles);
 	CArrayTerminate(&map->iMap);
+	CA_FOREACH(CArray, cell, map->CollisionCells)
+		CArrayTerminate(cell);
+	CA_FOREACH_END()
+	CArrayTerminate(&map->CollisionCells);
 	LOSTerminate(&map->LOS);
+	FloorCacheTerminate(&map->FloorCache);
+	AutomapCacheTerminate(&map->Automap);
 	PathCacheTerminate(&gPathCache);
+	FlowFieldsTerminate(&gFlowFields);
 }
 void MapLoad(
 	Map *map, const struct MissionOptions *mo, const CampaignOptions *co)
@@ -680,11 +715,13 @@ void MapLoad(
 	memset(map, 0, sizeof *map);
 	CArrayInit(&map->Tiles, sizeof(Tile));
 	CArrayInit(&map->iMap, sizeof(unsigned short));
+	CArrayInit(&map->CollisionCells, sizeof(CArray));
 	const Mission *mission = mo->missionData;
 	map->Size = mission->Size;
-	LOSInit(map, map->Size);
+	FloorCacheInit(&map->FloorCache, map->Size);
 	CArrayInit(&map->triggers, sizeof(Trigger *));
 	PathCacheInit(&gPathCache, map);
+	FlowFieldsInit(&gFlowFields, map);
 
 	Vec2i v;
 	for (v.y = 0; v.y < map->Size.y; v.y++)
@@ -696,6 +733,9 @@ void MapLoad(
 			TileInit(&t);
 			CArrayPushBack(&map->Tiles, &t);
 			CArrayPushBack(&map->iMap, &tI);
+			CArray cell;
+			CArrayInit(&cell, sizeof(CollisionProxy));
+			CArrayPushBack(&map->CollisionCells, &cell);
 		}
 	}
 
@@ -712,6 +752,13 @@ void MapLoad(
 	const int floor = mission->FloorStyle % FLOOR_STYLE_COUNT;
 	const int room = mission->RoomStyle % ROOM_STYLE_COUNT;
 	MapSetupDoors(map, mission, floor, room);
+	for (v.y = 0; v.y < map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < map->Size.x; v.x++)
+		{
+			MapSetupTileDrawFlags(map, v);
+		}
+	}
 
 	// Set exit now since we have set up all the tiles
 	if (Vec2iIsZero(map->ExitStart) && Vec2iIsZero(map->ExitEnd))
@@ -731,6 +778,10 @@ void MapLoad(
 			}
 		}
 	}
+
+	// Now that the tiles are set up, init line of sight from their flags
+	LOSInit(map, map->Size);
+	AutomapCacheInit(map);
 }
 
 static void AddObjectives(Map *map, const struct MissionOptions *mo);
@@ -900,7 +951,13 @@ void MapMarkAsVisited(Map *map, Vec2i pos)
 	{
 		map->tilesSeen++;
 	}
+	const bool wasVisited = t->isVisited;
 	t->isVisited = true;
+	LOSOnTileVisited(&map->LOS, pos);
+	if (!wasVisited)
+	{
+		AutomapOnTileChanged(map, pos);
+	}
 }
 
 void MapMarkAllAsVisited(Map *map)
@@ -82,15 +82,92 @@ IMapType StrIMapType(const char *s);
 
 #define MAP_LEAVEFREE       4096
 
+// Kernels for calculating the tiles visible from a position
+typedef enum
+{
+	// Recursive shadowcasting
+	LOS_KERNEL_SHADOWCAST,
+	// Xiaolin Wu rays cast to the perimeter
+	LOS_KERNEL_RAYS
+} LOSKernel;
+
+// Cached line of sight result for one viewer position
+// Reused until the viewer changes tile, the sight range changes, or a
+// sight-blocking tile within range changes
 typedef struct
 {
-	// Array of bools to set lines of sight
-	CArray LOS;	// of bool
-
-	// Array of bools for tracking new tiles in line of sight, for delayed messaging
-	CArray Explored; // of bool
+	Vec2i Pos;
+	int SightRange;
+	bool IsValid;
+	int LastUsed;
+	// Bitset of visible tiles, covering words Min.x-Max.x and
+	// rows Min.y-Max.y of the map bitsets
+	Vec2i Min;
+	Vec2i Max;
+	CArray Bits;	// of Uint32
+} LOSViewer;
+#define LOS_VIEWERS_MAX 16
+
+// Line of sight state, stored as bitsets with one bit per tile
+// Each row of the bitsets is padded to a whole number of words
+typedef struct
+{
+	int Stride;	// words per row
+
+	// Tiles with MAPTILE_NO_SEE
+	CArray BlocksSight;	// of Uint32
+	// Tiles that have been visited, mirrors Tile.isVisited
+	CArray Visited;	// of Uint32
+
+	// Tiles in line of sight
+	CArray LOS;	// of Uint32
+	// Newly explored tiles in line of sight, for delayed messaging
+	CArray Explored;	// of Uint32
+	// Bounding boxes (in words and rows) of the set bits, so that resets and
+	// explore runs only need to look at these
+	Vec2i LOSMin, LOSMax;
+	Vec2i ExploredMin, ExploredMax;
+
+	LOSKernel Kernel;
+	LOSViewer Viewers[LOS_VIEWERS_MAX];
+	int Ticks;
 } LineOfSight;
 
+// Broad-phase collision entry: a compact copy of a tile item's bounds, so
+// that collision queries can reject most nearby items without looking up
+// the items themselves
+typedef struct
+{
+	ThingId Id;
+	Vec2i Pos;
+	Vec2i Size;
+} CollisionProxy;
+
+// Pre-rendered floor pixels for a square chunk of tiles
+// Pixels are allocated when the chunk is first drawn, and freed again if
+// the chunk goes unused for long enough
+typedef struct
+{
+	Uint32 *Pixels;
+	Uint32 LastUsed;
+} FloorCacheChunk;
+typedef struct
+{
+	Vec2i Size;	// in chunks
+	CArray Chunks;	// of FloorCacheChunk
+	int NumAllocated;
+	Uint32 Ticks;
+} FloorCache;
+
+// Automap colour of each tile as a pixel, or 0 for tiles that aren't shown
+// Kept up to date as tiles change and are explored, so that the automap
+// doesn't need to look at the tiles themselves
+typedef struct
+{
+	CArray Pixels;	// of Uint32
+	CArray VisitedPixels;	// of Uint32; 0 for tiles that aren't visited
+} AutomapCache;
+
 typedef struct
 {
 	CArray Tiles;	// of Tile
@@ -100,6 +177,12 @@ typedef struct
 	CArray iMap;	// of unsigned short
 
 	LineOfSight LOS;
+	FloorCache FloorCache;
+	AutomapCache Automap;
+
+	// One cell per tile, in the same order as Tiles; each cell has the
+	// proxies of the items on that tile, in the same order as Tile.things
+	CArray CollisionCells;	// of CArray of CollisionProxy
 
 	CArray triggers;	// of Trigger *; owner
 	int triggerId;
@@ -29,7 +29,6 @@
 
 #include <locale.h>
 
-#include <SDL_image.h>
 #include <tinydir/tinydir.h>
 
 #include "ammo.h"
@@ -90,14 +89,21 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 
 
 	// Unload previous custom data
-	SoundClear(&gSoundDevice.customSounds);
+	SoundClear(&gSoundDevice, &gSoundDevice.customSounds);
+	NameMapClear(&gSoundDevice.customSoundsByName);
 	PicManagerClearCustom(&gPicManager);
 	ParticleClassesClear(&gParticleClasses.CustomClasses);
+	NameMapClear(&gParticleClasses.CustomClassesByName);
 	AmmoClassesClear(&gAmmo.CustomAmmo);
+	NameMapClear(&gAmmo.CustomAmmoByName);
 	BulletClassesClear(&gBulletClasses.CustomClasses);
+	NameMapClear(&gBulletClasses.CustomClassesByName);
 	WeaponClassesClear(&gGunDescriptions.CustomGuns);
+	NameMapClear(&gGunDescriptions.CustomGunsByName);
 	PickupClassesClear(&gPickupClasses.CustomClasses);
+	NameMapClear(&gPickupClasses.CustomClassesByName);
 	MapObjectsClear(&gMapObjects.CustomClasses);
+	NameMapClear(&gMapObjects.CustomClassesByName);
 
 	// Load any custom data
 	LoadArchiveSounds(&gSoundDevice, filename, "sounds");
@@ -200,8 +206,6 @@ bail:
 static void LoadArchiveSounds(
 	SoundDevice *device, const char *archive, const char *dirname)
 {
-	char *buf = NULL;
-
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/%s", archive, dirname);
 	tinydir_dir dir;
@@ -214,13 +218,7 @@ static void LoadArchiveSounds(
 	{
 		tinydir_file file;
 		tinydir_readfile(&dir, &file);
-		if (!file.is_reg) goto nextFile;
-		long len;
-		buf = ReadFileIntoBuf(file.path, "rb", &len);
-		if (buf == NULL) goto nextFile;
-		SDL_RWops *rwops = SDL_RWFromMem(buf, len);
-		Mix_Chunk *data = Mix_LoadWAV_RW(rwops, 0);
-		if (data != NULL)
+		if (file.is_reg)
 		{
 			char nameBuf[CDOGS_FILENAME_MAX];
 			strcpy(nameBuf, file.name);
@@ -230,12 +228,9 @@ static void LoadArchiveSounds(
 			{
 				*dot = '\0';
 			}
-			SoundAdd(&device->customSounds, nameBuf, data);
+			// Sounds are decoded when first used
+			SoundAdd(&device->customSounds, nameBuf, file.path);
 		}
-		rwops->close(rwops);
-	nextFile:
-		CFREE(buf);
-		buf = NULL;
 		if (tinydir_next(&dir) != 0)
 		{
 			printf(
@@ -246,58 +241,14 @@ static void LoadArchiveSounds(
 	}
 
 bail:
-	CFREE(buf);
 	tinydir_close(&dir);
 }
 static void LoadArchivePics(
 	PicManager *pm, const char *archive, const char *dirname)
 {
-	char *buf = NULL;
-
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/%s", archive, dirname);
-	tinydir_dir dir;
-	if (tinydir_open(&dir, path) != 0)
-	{
-		LOG(LM_MAIN, LL_DEBUG, "no pic dir(%s): %s", path, strerror(errno));
-		goto bail;
-	}
-	while (dir.has_next)
-	{
-		tinydir_file file;
-		tinydir_readfile(&dir, &file);
-		if (!file.is_reg) goto nextFile;
-		long len;
-		buf = ReadFileIntoBuf(file.path, "rb", &len);
-		if (buf == NULL) goto nextFile;
-		SDL_RWops *rwops = SDL_RWFromMem(buf, len);
-		bool isPng = IMG_isPNG(rwops);
-		if (isPng)
-		{
-			SDL_Surface *data = IMG_Load_RW(rwops, 0);
-			if (data != NULL)
-			{
-				char nameBuf[CDOGS_FILENAME_MAX];
-				PathGetBasenameWithoutExtension(nameBuf, file.path);
-				PicManagerAdd(&pm->customPics, &pm->customSprites, nameBuf, data);
-			}
-		}
-		rwops->close(rwops);
-	nextFile:
-		CFREE(buf);
-		buf = NULL;
-		if (tinydir_next(&dir) != 0)
-		{
-			printf(
-				"Could not go to next file in dir %s: %s\n",
-				path, strerror(errno));
-			goto bail;
-		}
-	}
-
-bail:
-	CFREE(buf);
-	tinydir_close(&dir);
+	PicManagerLoadFiles(pm, &pm->customPics, &pm->customSprites, path, false);
 }
 
 static char *ReadFileIntoBuf(const char *path, const char *mode, long *len)
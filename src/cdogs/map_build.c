@@ -48,6 +48,9 @@
 */
 #include "map_build.h"
 
+#include "automap.h"
+#include "floor_cache.h"
+
 
 #define EXIT_WIDTH  8
 #define EXIT_HEIGHT 8
@@ -69,12 +72,27 @@ void MapSetTile(Map *map, Vec2i pos, unsigned short tileType, Mission *m)
 	MapSetupTile(map, Vec2iNew(pos.x + 1, pos.y), m);
 	MapSetupTile(map, Vec2iNew(pos.x, pos.y - 1), m);
 	MapSetupTile(map, Vec2iNew(pos.x, pos.y + 1), m);
+	const Vec2i changed[] =
+	{
+		Vec2iNew(pos.x, pos.y - 1),
+		Vec2iNew(pos.x - 1, pos.y),
+		pos,
+		Vec2iNew(pos.x + 1, pos.y),
+		Vec2iNew(pos.x, pos.y + 1)
+	};
+	for (int i = 0; i < (int)(sizeof changed / sizeof changed[0]); i++)
+	{
+		MapSetupTileDrawFlags(map, changed[i]);
+		FloorCacheOnTileChanged(map, changed[i]);
+		AutomapOnTileChanged(map, changed[i]);
+	}
 }
 
 void MapSetupTilesAndWalls(Map *map, const Mission *m)
 {
 	// Pre-load the tile pics that this map will use
 	// TODO: multiple styles and colours
+	PicManagerBeginBatch(&gPicManager);
 	// Walls
 	for (int i = 0; i < WALL_TYPES; i++)
 	{
@@ -93,6 +111,7 @@ void MapSetupTilesAndWalls(Map *map, const Mission *m)
 		PicManagerGenerateMaskedStylePic(
 			&gPicManager, "room", m->RoomStyle, i, m->RoomMask, m->AltMask);
 	}
+	PicManagerEndBatch(&gPicManager);
 
 	Vec2i v;
 	for (v.x = 0; v.x < map->Size.x; v.x++)
@@ -142,6 +161,32 @@ void MapSetupTilesAndWalls(Map *map, const Mission *m)
 		}
 	}
 }
+// Work out how a tile is drawn with the tile below it: walls above walls
+// are drawn as part of the bottom wall's column, and floors above walls are
+// covered by them
+void MapSetupTileDrawFlags(Map *map, const Vec2i pos)
+{
+	Tile *t = MapGetTile(map, pos);
+	if (t == NULL)
+	{
+		return;
+	}
+	t->flags &= ~(MAPTILE_DELAY_DRAW | MAPTILE_COVERED_BY_WALL);
+	const Tile *tBelow = MapGetTile(map, Vec2iNew(pos.x, pos.y + 1));
+	if (tBelow == NULL || !(tBelow->flags & MAPTILE_IS_WALL))
+	{
+		return;
+	}
+	if (t->flags & MAPTILE_IS_WALL)
+	{
+		t->flags |= MAPTILE_DELAY_DRAW;
+	}
+	else if (!(t->flags & MAPTILE_OFFSET_PIC))
+	{
+		t->flags |= MAPTILE_COVERED_BY_WALL;
+	}
+}
+
 static int MapGetWallPic(Map *m, Vec2i pos);
 // Set tile properties for a map tile, such as picture to use
 static void MapSetupTile(Map *map, const Vec2i pos, const Mission *m)
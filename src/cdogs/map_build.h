@@ -69,6 +69,7 @@ void MapMakeWall(Map *map, Vec2i pos);
 void MapSetTile(Map *map, Vec2i pos, unsigned short tileType, Mission *m);
 
 void MapSetupTilesAndWalls(Map *map, const Mission *m);
+void MapSetupTileDrawFlags(Map *map, const Vec2i pos);
 
 unsigned short GenerateAccessMask(int *accessLevel);
 void MapGenerateRandomExitArea(Map *map);
@@ -28,6 +28,7 @@
 #include "map_new.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <locale.h>
 #include <stdio.h>
 
@@ -37,10 +38,10 @@
 #include "map_archive.h"
 
 
+static int ScanJSONHeader(FILE *f, char **title, int *numMissions);
 int MapNewScan(const char *filename, char **title, int *numMissions)
 {
 	int err = 0;
-	json_t *root = NULL;
 	FILE *f = NULL;
 
 	if (strcmp(StrGetFileExt(filename), "cdogscpn") == 0 ||
@@ -59,12 +60,7 @@ int MapNewScan(const char *filename, char **title, int *numMissions)
 		err = -1;
 		goto bail;
 	}
-	if (json_stream_parse(f, &root) != JSON_OK)
-	{
-		err = -1;
-		goto bail;
-	}
-	err = MapNewScanJSON(root, title, numMissions);
+	err = ScanJSONHeader(f, title, numMissions);
 	if (err < 0)
 	{
 		goto bail;
@@ -75,7 +71,223 @@ bail:
 	{
 		fclose(f);
 	}
-	json_free_value(&root);
+	return err;
+}
+// Streaming scan of the top level of a JSON campaign, for just its version,
+// title and number of missions; unlike parsing the whole file, nothing is
+// built for the other values, including old campaigns' inline missions
+static int ScanSkipSpace(FILE *f)
+{
+	int c;
+	do
+	{
+		c = getc(f);
+	} while (c != EOF && isspace(c));
+	return c;
+}
+// Read the rest of a string after its opening quote, keeping escapes as
+// they are, into buf (of char) if it is not NULL
+static bool ScanString(FILE *f, CArray *buf)
+{
+	for (;;)
+	{
+		int c = getc(f);
+		if (c == EOF)
+		{
+			return false;
+		}
+		if (c == '"')
+		{
+			break;
+		}
+		if (c == '\\')
+		{
+			if (buf != NULL)
+			{
+				const char ch = (char)c;
+				CArrayPushBack(buf, &ch);
+			}
+			c = getc(f);
+			if (c == EOF)
+			{
+				return false;
+			}
+		}
+		if (buf != NULL)
+		{
+			const char ch = (char)c;
+			CArrayPushBack(buf, &ch);
+		}
+	}
+	if (buf != NULL)
+	{
+		const char ch = '\0';
+		CArrayPushBack(buf, &ch);
+	}
+	return true;
+}
+// Skip a value that starts with c; returns the next char after it
+static int ScanSkipValue(FILE *f, int c)
+{
+	int depth = 0;
+	for (;; c = getc(f))
+	{
+		switch (c)
+		{
+		case EOF:
+			return EOF;
+		case '"':
+			if (!ScanString(f, NULL))
+			{
+				return EOF;
+			}
+			break;
+		case '{':
+		case '[':
+			depth++;
+			break;
+		case '}':
+		case ']':
+			if (depth == 0)
+			{
+				// End of the enclosing object or array
+				return c;
+			}
+			depth--;
+			break;
+		case ',':
+			if (depth == 0)
+			{
+				return c;
+			}
+			break;
+		default:
+			break;
+		}
+		if (depth == 0 && (c == '"' || c == '}' || c == ']'))
+		{
+			return ScanSkipSpace(f);
+		}
+	}
+}
+// Read an integer value that starts with c; returns the next char after it
+static int ScanInt(FILE *f, int c, int *value)
+{
+	char buf[32];
+	int len = 0;
+	while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' ||
+		isdigit(c))
+	{
+		if (len < (int)sizeof buf - 1)
+		{
+			buf[len++] = (char)c;
+		}
+		c = getc(f);
+	}
+	buf[len] = '\0';
+	*value = atoi(buf);
+	return isspace(c) ? ScanSkipSpace(f) : c;
+}
+// Count the elements of an array after its opening bracket; returns the
+// next char after it
+static int ScanCountArray(FILE *f, int *count)
+{
+	*count = 0;
+	int c = ScanSkipSpace(f);
+	if (c == ']')
+	{
+		return ScanSkipSpace(f);
+	}
+	for (;;)
+	{
+		c = ScanSkipValue(f, c);
+		(*count)++;
+		if (c == ']')
+		{
+			return ScanSkipSpace(f);
+		}
+		if (c != ',')
+		{
+			return EOF;
+		}
+		c = ScanSkipSpace(f);
+	}
+}
+static int ScanJSONHeader(FILE *f, char **title, int *numMissions)
+{
+	int err = 0;
+	CArray key;
+	CArrayInit(&key, sizeof(char));
+	CArray rawTitle;
+	CArrayInit(&rawTitle, sizeof(char));
+	int version = 0;
+	bool hasVersion = false;
+	bool hasMissions = false;
+	*numMissions = 0;
+
+	int c = ScanSkipSpace(f);
+	if (c != '{')
+	{
+		err = -1;
+		goto bail;
+	}
+	c = ScanSkipSpace(f);
+	while (c == '"' && !(hasVersion && rawTitle.size > 0 && hasMissions))
+	{
+		CArrayClear(&key);
+		if (!ScanString(f, &key) || ScanSkipSpace(f) != ':')
+		{
+			err = -1;
+			goto bail;
+		}
+		c = ScanSkipSpace(f);
+		if (strcmp(key.data, "Version") == 0 && c != '"')
+		{
+			c = ScanInt(f, c, &version);
+			hasVersion = true;
+		}
+		else if (strcmp(key.data, "Title") == 0 && c == '"')
+		{
+			CArrayClear(&rawTitle);
+			if (!ScanString(f, &rawTitle))
+			{
+				err = -1;
+				goto bail;
+			}
+			c = ScanSkipSpace(f);
+		}
+		else if (strcmp(key.data, "Missions") == 0 && c == '[')
+		{
+			// Old campaigns have their missions inline
+			c = ScanCountArray(f, numMissions);
+			hasMissions = true;
+		}
+		else if (strcmp(key.data, "Missions") == 0 && c != '"' && c != '{')
+		{
+			c = ScanInt(f, c, numMissions);
+			hasMissions = true;
+		}
+		else
+		{
+			c = ScanSkipValue(f, c);
+		}
+		if (c == ',')
+		{
+			c = ScanSkipSpace(f);
+		}
+	}
+	// The rest of the file isn't checked, but catch it being cut short
+	if (c == EOF || !hasVersion || version > MAP_VERSION || version <= 0 ||
+		rawTitle.size == 0)
+	{
+		err = -1;
+		goto bail;
+	}
+	*title = json_unescape(rawTitle.data);
+
+bail:
+	CArrayTerminate(&key);
+	CArrayTerminate(&rawTitle);
 	return err;
 }
 int MapNewScanJSON(json_t *root, char **title, int *numMissions)
@@ -97,21 +97,15 @@ MapObject *StrMapObject(const char *s)
 	{
 		return NULL;
 	}
-	for (int i = 0; i < (int)gMapObjects.CustomClasses.size; i++)
+	int i = NameMapGet(&gMapObjects.CustomClassesByName, s);
+	if (i >= 0)
 	{
-		MapObject *c = CArrayGet(&gMapObjects.CustomClasses, i);
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
+		return CArrayGet(&gMapObjects.CustomClasses, i);
 	}
-	for (int i = 0; i < (int)gMapObjects.Classes.size; i++)
+	i = NameMapGet(&gMapObjects.ClassesByName, s);
+	if (i >= 0)
 	{
-		MapObject *c = CArrayGet(&gMapObjects.Classes, i);
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
+		return CArrayGet(&gMapObjects.Classes, i);
 	}
 	return NULL;
 }
@@ -150,25 +144,12 @@ MapObject *IndexMapObject(const int i)
 }
 int MapObjectIndex(const MapObject *mo)
 {
-	int idx = 0;
-	for (int i = 0; i < (int)gMapObjects.Classes.size; i++, idx++)
-	{
-		const MapObject *c = CArrayGet(&gMapObjects.Classes, i);
-		if (c == mo)
-		{
-			return idx;
-		}
-	}
-	for (int i = 0; i < (int)gMapObjects.CustomClasses.size; i++, idx++)
-	{
-		const MapObject *c = CArrayGet(&gMapObjects.CustomClasses, i);
-		if (c == mo)
-		{
-			return idx;
-		}
-	}
-	CASSERT(false, "cannot find map object");
-	return -1;
+	const int i = CArrayIndexOf(&gMapObjects.Classes, mo);
+	if (i >= 0) return i;
+	const int ci = CArrayIndexOf(&gMapObjects.CustomClasses, mo);
+	CASSERT(ci >= 0, "cannot find map object");
+	if (ci < 0) return -1;
+	return (int)gMapObjects.Classes.size + ci;
 }
 MapObject *RandomBloodMapObject(const MapObjects *mo)
 {
@@ -183,6 +164,11 @@ void MapObjectsInit(MapObjects *classes, const char *filename)
 {
 	CArrayInit(&classes->Classes, sizeof(MapObject));
 	CArrayInit(&classes->CustomClasses, sizeof(MapObject));
+	NAME_MAP_INIT(
+		&classes->ClassesByName, &classes->Classes, MapObject, Name, true);
+	NAME_MAP_INIT(
+		&classes->CustomClassesByName, &classes->CustomClasses, MapObject,
+		Name, true);
 	CArrayInit(&classes->Destructibles, sizeof(char *));
 	CArrayInit(&classes->Bloods, sizeof(char *));
 
@@ -404,6 +390,8 @@ void MapObjectsTerminate(MapObjects *classes)
 	CArrayTerminate(&classes->Classes);
 	MapObjectsClear(&classes->CustomClasses);
 	CArrayTerminate(&classes->CustomClasses);
+	NameMapTerminate(&classes->ClassesByName);
+	NameMapTerminate(&classes->CustomClassesByName);
 	for (int i = 0; i < (int)classes->Destructibles.size; i++)
 	{
 		char **s = CArrayGet(&classes->Destructibles, i);
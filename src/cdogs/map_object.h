@@ -50,6 +50,7 @@
 
 #include <json/json.h>
 #include "ammo.h"
+#include "name_map.h"
 #include "pic_manager.h"
 #include "pickup_class.h"
 
@@ -104,6 +105,8 @@ typedef struct
 {
 	CArray Classes;	// of MapObject
 	CArray CustomClasses;	// of MapObject
+	NameMap ClassesByName;
+	NameMap CustomClassesByName;
 	// Names of special types of map objects; for editor support
 	// Reset on load
 	CArray Destructibles;	// of char *
@@ -135,7 +135,7 @@ static void AddCharacters(const CArray *characters)
 			aa.FullPos.y = fullPos.y;
 			GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 			e.u.ActorAdd = aa;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 
 			// Process the events that actually place the players
 			HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -172,7 +172,7 @@ static void AddObjectives(
 				aa.FullPos = Vec2i2Net(fullPos);
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 				e.u.ActorAdd = aa;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			break;
 			case OBJECTIVE_COLLECT:
@@ -197,7 +197,7 @@ static void AddObjectives(
 				aa.FullPos = Vec2i2Net(fullPos);
 				GameEvent e = GameEventNew(GAME_EVENT_ACTOR_ADD);
 				e.u.ActorAdd = aa;
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			break;
 			default:
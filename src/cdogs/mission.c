@@ -65,6 +65,7 @@
 #include "defs.h"
 #include "pic_manager.h"
 #include "actors.h"
+#include "sounds.h"
 #include "triggers.h"
 
 
@@ -285,6 +286,50 @@ static void SetupWeapons(CArray *to, CArray *from)
 	CArrayCopy(to, from);
 }
 
+static void PrefetchGunSounds(SoundDevice *device, const GunDescription *g)
+{
+	if (g == NULL)
+	{
+		return;
+	}
+	SoundPrefetch(device, g->Sound);
+	SoundPrefetch(device, g->ReloadSound);
+	SoundPrefetch(device, g->SwitchSound);
+	if (g->Bullet != NULL)
+	{
+		SoundPrefetch(device, StrSound(g->Bullet->HitSound.Object));
+		SoundPrefetch(device, StrSound(g->Bullet->HitSound.Flesh));
+		SoundPrefetch(device, StrSound(g->Bullet->HitSound.Wall));
+	}
+}
+// Start decoding the sounds the mission is likely to play, so that the
+// first shots don't stall on decoding
+static void PrefetchSounds(SoundDevice *device, const Mission *m)
+{
+	CA_FOREACH(Mix_Chunk *, s, device->footstepSounds)
+		SoundPrefetch(device, *s);
+	CA_FOREACH_END()
+	CA_FOREACH(Mix_Chunk *, s, device->screamSounds)
+		SoundPrefetch(device, *s);
+	CA_FOREACH_END()
+	SoundPrefetch(device, device->slideSound);
+	SoundPrefetch(device, device->healthSound);
+	SoundPrefetch(device, device->keySound);
+	SoundPrefetch(device, device->wreckSound);
+	CA_FOREACH(const GunDescription *, g, m->Weapons)
+		PrefetchGunSounds(device, *g);
+	CA_FOREACH_END()
+	const CArray *chars = &gCampaign.Setting.characters.OtherChars;
+	CA_FOREACH(const int, e, m->Enemies)
+		const Character *c = CArrayGet(chars, *e);
+		PrefetchGunSounds(device, c->Gun);
+	CA_FOREACH_END()
+	CA_FOREACH(const int, sc, m->SpecialChars)
+		const Character *c = CArrayGet(chars, *sc);
+		PrefetchGunSounds(device, c->Gun);
+	CA_FOREACH_END()
+}
+
 void SetupMission(
 	int buildTables, Mission *m, struct MissionOptions *mo, int missionIndex)
 {
@@ -309,6 +354,7 @@ void SetupMission(
 	SetupObjectives(mo, m);
 	SetupBadguysForMission(m);
 	SetupWeapons(&mo->Weapons, &m->Weapons);
+	PrefetchSounds(&gSoundDevice, m);
 	if (buildTables)
 	{
 		BuildTranslationTables(gPicManager.palette);
@@ -335,7 +381,7 @@ void MissionSetMessageIfComplete(struct MissionOptions *options)
 	{
 		GameEvent msg = GameEventNew(GAME_EVENT_MISSION_COMPLETE);
 		msg.u.MissionComplete.ShowMsg = MissionHasRequiredObjectives(options);
-		GameEventsEnqueue(&gGameEvents, msg);
+		GameEventsEnqueue(&gGameEvents, &msg);
 	}
 }
 bool MissionHasRequiredObjectives(const struct MissionOptions *mo)
@@ -365,7 +411,7 @@ void UpdateMissionObjective(
 		GameEvent e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
 		e.u.ObjectiveUpdate.ObjectiveId = idx;
 		e.u.ObjectiveUpdate.Count = 1;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 
@@ -0,0 +1,179 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "name_map.h"
+
+#include <string.h>
+
+#include <SDL_stdinc.h>
+
+#include "utils.h"
+
+#define NAME_MAP_MIN_SIZE 64
+
+typedef struct
+{
+	Uint32 Hash;
+	int Index;	// -1 if empty
+} NameMapEntry;
+
+
+static void Rehash(NameMapTable *t, const int size);
+static void ClearTable(NameMapTable *t);
+void NameMapInit(
+	NameMap *m, const CArray *list, const size_t nameOffset,
+	const bool isNamePtr)
+{
+	memset(m, 0, sizeof *m);
+	m->List = list;
+	m->NameOffset = nameOffset;
+	m->IsNamePtr = isNamePtr;
+	CMALLOC(m->table, sizeof *m->table);
+	CArrayInit(&m->table->Entries, sizeof(NameMapEntry));
+	m->table->Count = 0;
+	Rehash(m->table, NAME_MAP_MIN_SIZE);
+}
+void NameMapTerminate(NameMap *m)
+{
+	if (m->table == NULL)
+	{
+		return;
+	}
+	CArrayTerminate(&m->table->Entries);
+	CFREE(m->table);
+	m->table = NULL;
+}
+void NameMapClear(NameMap *m)
+{
+	if (m->table != NULL)
+	{
+		ClearTable(m->table);
+	}
+}
+static void ClearTable(NameMapTable *t)
+{
+	CA_FOREACH(NameMapEntry, e, t->Entries)
+		e->Index = -1;
+	CA_FOREACH_END()
+	t->Count = 0;
+}
+
+// FNV-1a
+static Uint32 Hash(const char *s)
+{
+	Uint32 h = 2166136261u;
+	for (; *s; s++)
+	{
+		h = (h ^ (Uint8)*s) * 16777619u;
+	}
+	return h;
+}
+static const char *GetName(const NameMap *m, const int index)
+{
+	const char *p = (const char *)CArrayGet(m->List, index) + m->NameOffset;
+	return m->IsNamePtr ? *(const char * const *)p : p;
+}
+// Find the entry for this name, or the empty entry where it should go
+static NameMapEntry *Find(const NameMap *m, const char *name, const Uint32 h)
+{
+	NameMapEntry *entries = m->table->Entries.data;
+	const int mask = (int)m->table->Entries.size - 1;
+	for (int i = (int)(h & (Uint32)mask);; i = (i + 1) & mask)
+	{
+		NameMapEntry *e = &entries[i];
+		if (e->Index == -1 ||
+			(e->Hash == h && strcmp(GetName(m, e->Index), name) == 0))
+		{
+			return e;
+		}
+	}
+}
+static void Rehash(NameMapTable *t, const int size)
+{
+	CArray old = t->Entries;
+	CArrayInit(&t->Entries, sizeof(NameMapEntry));
+	NameMapEntry empty;
+	empty.Hash = 0;
+	empty.Index = -1;
+	CArrayResize(&t->Entries, size, &empty);
+	NameMapEntry *entries = t->Entries.data;
+	const int mask = size - 1;
+	// Names are already unique, so only look for empty slots
+	CA_FOREACH(const NameMapEntry, e, old)
+		if (e->Index != -1)
+		{
+			int j = (int)(e->Hash & (Uint32)mask);
+			while (entries[j].Index != -1)
+			{
+				j = (j + 1) & mask;
+			}
+			entries[j] = *e;
+		}
+	CA_FOREACH_END()
+	CArrayTerminate(&old);
+}
+// Index the list entries appended since the last lookup
+static void Update(const NameMap *m)
+{
+	NameMapTable *t = m->table;
+	if ((int)m->List->size < t->Count)
+	{
+		// The list has been cleared without telling us; start again
+		ClearTable(t);
+	}
+	for (; t->Count < (int)m->List->size; t->Count++)
+	{
+		// Keep the load factor at most 1/2
+		if ((t->Count + 1) * 2 > (int)t->Entries.size)
+		{
+			Rehash(t, (int)t->Entries.size * 2);
+		}
+		const char *name = GetName(m, t->Count);
+		if (name == NULL)
+		{
+			continue;
+		}
+		const Uint32 h = Hash(name);
+		NameMapEntry *e = Find(m, name, h);
+		// For duplicate names, keep the first entry like a linear scan
+		if (e->Index == -1)
+		{
+			e->Hash = h;
+			e->Index = t->Count;
+		}
+	}
+}
+
+int NameMapGet(const NameMap *m, const char *name)
+{
+	if (name == NULL || m->table == NULL)
+	{
+		return -1;
+	}
+	Update(m);
+	return Find(m, name, Hash(name))->Index;
+}
@@ -0,0 +1,63 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "c_array.h"
+
+// Index of a list of named assets, mapping names to their list index
+// Open addressing hash table, so lookups by name are O(1) instead of a
+// strcmp scan of the whole list.
+// The index is bound to the list and catches up with any entries appended
+// to it on the next lookup; call NameMapClear whenever the list is cleared.
+typedef struct
+{
+	CArray Entries;	// of NameMapEntry, size is a power of two
+	int Count;	// number of list entries indexed so far
+} NameMapTable;
+typedef struct
+{
+	const CArray *List;
+	size_t NameOffset;	// offset of the name in each list entry
+	bool IsNamePtr;	// whether the name is a char * or a char array
+	// Lookups bring the table up to date, so it is kept behind a pointer
+	// to allow lookups through const asset stores
+	NameMapTable *table;
+} NameMap;
+
+#define NAME_MAP_INIT(_m, _list, _type, _name, _isPtr)\
+	NameMapInit(_m, _list, offsetof(_type, _name), _isPtr)
+void NameMapInit(
+	NameMap *m, const CArray *list, const size_t nameOffset,
+	const bool isNamePtr);
+void NameMapTerminate(NameMap *m);
+void NameMapClear(NameMap *m);
+// Returns the index of the first list entry with this name, or -1
+int NameMapGet(const NameMap *m, const char *name);
@@ -0,0 +1,257 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_assets.h"
+
+#include <string.h>
+
+#include "log.h"
+#include "pic_manager.h"
+#include "utils.h"
+
+NetAssets gNetAssets;
+
+
+void NetAssetsInit(NetAssets *na)
+{
+	memset(na, 0, sizeof *na);
+	for (int i = 0; i < ASSET_KIND_COUNT; i++)
+	{
+		CArrayInit(&na->Defs[i], sizeof(NetAssetDef));
+		NAME_MAP_INIT(
+			&na->DefsByName[i], &na->Defs[i], NetAssetDef, Name, true);
+	}
+}
+static void ClearDefs(NetAssets *na, const int kind);
+void NetAssetsTerminate(NetAssets *na)
+{
+	for (int i = 0; i < ASSET_KIND_COUNT; i++)
+	{
+		ClearDefs(na, i);
+		CArrayTerminate(&na->Defs[i]);
+		NameMapTerminate(&na->DefsByName[i]);
+	}
+	memset(na, 0, sizeof *na);
+}
+void NetAssetsReset(NetAssets *na)
+{
+	for (int i = 0; i < ASSET_KIND_COUNT; i++)
+	{
+		ClearDefs(na, i);
+	}
+	na->IsRemote = false;
+}
+static void ClearDefs(NetAssets *na, const int kind)
+{
+	CA_FOREACH(NetAssetDef, d, na->Defs[kind])
+		CFREE(d->Name);
+	CA_FOREACH_END()
+	CArrayClear(&na->Defs[kind]);
+	NameMapClear(&na->DefsByName[kind]);
+}
+
+void NetAssetsAdd(NetAssets *na, const NAssetDef *def)
+{
+	if (def->Kind >= ASSET_KIND_COUNT)
+	{
+		LOG(LM_NET, LL_ERROR, "unknown asset kind(%u)", def->Kind);
+		return;
+	}
+	CArray *defs = &na->Defs[def->Kind];
+	if (def->Id == 0)
+	{
+		ClearDefs(na, (int)def->Kind);
+	}
+	// The server sends its dictionary in order
+	if (def->Id != defs->size)
+	{
+		LOG(LM_NET, LL_ERROR, "unexpected asset kind(%u) id(%u) name(%s)",
+			def->Kind, def->Id, def->Name);
+		return;
+	}
+	NetAssetDef d;
+	CSTRDUP(d.Name, def->Name);
+	d.LocalId = -1;
+	CArrayPushBack(defs, &d);
+	na->IsRemote = true;
+}
+
+int NetAssetsGetNumLocal(const AssetKind kind)
+{
+	switch (kind)
+	{
+	case ASSET_KIND_PIC:
+		return (int)(gPicManager.pics.size + gPicManager.customPics.size);
+	case ASSET_KIND_SOUND:
+		return (int)(
+			gSoundDevice.sounds.size + gSoundDevice.customSounds.size);
+	case ASSET_KIND_BULLET:
+		return (int)(
+			gBulletClasses.Classes.size + gBulletClasses.CustomClasses.size);
+	case ASSET_KIND_GUN:
+		return (int)(
+			gGunDescriptions.Guns.size + gGunDescriptions.CustomGuns.size);
+	case ASSET_KIND_MAP_OBJECT:
+		return (int)(
+			gMapObjects.Classes.size + gMapObjects.CustomClasses.size);
+	default:
+		CASSERT(false, "unknown asset kind");
+		return 0;
+	}
+}
+static const char *GetLocalName(const AssetKind kind, const int id)
+{
+	switch (kind)
+	{
+	case ASSET_KIND_PIC:
+		return PicManagerGetNamedPicById(&gPicManager, id)->name;
+	case ASSET_KIND_SOUND:
+		return IdSoundData(id)->Name;
+	case ASSET_KIND_BULLET:
+		return IdBulletClass(id)->Name;
+	case ASSET_KIND_GUN:
+		return IdGunDescription(id)->name;
+	case ASSET_KIND_MAP_OBJECT:
+		return IndexMapObject(id)->Name;
+	default:
+		CASSERT(false, "unknown asset kind");
+		return NULL;
+	}
+}
+static int GetLocalId(const AssetKind kind, const char *name)
+{
+	switch (kind)
+	{
+	case ASSET_KIND_PIC:
+		return PicManagerGetNamedPicId(
+			&gPicManager, PicManagerGetNamedPic(&gPicManager, name));
+	case ASSET_KIND_SOUND:
+		return StrSoundId(name);
+	case ASSET_KIND_BULLET:
+		{
+			const BulletClass *b = StrBulletClass(name);
+			return b != NULL ? BulletClassId(b) : -1;
+		}
+	case ASSET_KIND_GUN:
+		{
+			const GunDescription *g = StrGunDescription(name);
+			return g != NULL ? GunDescriptionId(g) : -1;
+		}
+	case ASSET_KIND_MAP_OBJECT:
+		{
+			const MapObject *mo = StrMapObject(name);
+			return mo != NULL ? MapObjectIndex(mo) : -1;
+		}
+	default:
+		CASSERT(false, "unknown asset kind");
+		return -1;
+	}
+}
+NAssetDef NetAssetsMakeDef(const AssetKind kind, const int id)
+{
+	NAssetDef def = NAssetDef_init_default;
+	def.Kind = (uint32_t)kind;
+	def.Id = (uint32_t)id;
+	// Names that don't fit can't be resolved by clients
+	const char *name = GetLocalName(kind, id);
+	const size_t len = MIN(strlen(name), sizeof def.Name - 1);
+	memcpy(def.Name, name, len);
+	def.Name[len] = '\0';
+	return def;
+}
+
+static int ToId(const NetAssets *na, const AssetKind kind, const int localId)
+{
+	if (localId < 0 || !na->IsRemote) return localId;
+	return NameMapGet(&na->DefsByName[kind], GetLocalName(kind, localId));
+}
+static int ToLocalId(NetAssets *na, const AssetKind kind, const int id)
+{
+	if (id < 0) return -1;
+	if (!na->IsRemote)
+	{
+		return id < NetAssetsGetNumLocal(kind) ? id : -1;
+	}
+	if (id >= (int)na->Defs[kind].size) return -1;
+	NetAssetDef *d = CArrayGet(&na->Defs[kind], id);
+	if (d->LocalId < 0)
+	{
+		// Resolve on first use, as some assets like masked tile pics are
+		// only generated once the map loads
+		d->LocalId = GetLocalId(kind, d->Name);
+	}
+	return d->LocalId;
+}
+
+int NetAssetsPicId(const NamedPic *p)
+{
+	return ToId(
+		&gNetAssets, ASSET_KIND_PIC,
+		PicManagerGetNamedPicId(&gPicManager, p));
+}
+NamedPic *NetAssetsGetPic(const int id)
+{
+	return PicManagerGetNamedPicById(
+		&gPicManager, ToLocalId(&gNetAssets, ASSET_KIND_PIC, id));
+}
+int NetAssetsSoundId(const char *name)
+{
+	return ToId(&gNetAssets, ASSET_KIND_SOUND, StrSoundId(name));
+}
+Mix_Chunk *NetAssetsGetSound(const int id)
+{
+	const SoundData *s =
+		IdSoundData(ToLocalId(&gNetAssets, ASSET_KIND_SOUND, id));
+	return s != NULL ? s->data : NULL;
+}
+int NetAssetsBulletId(const BulletClass *b)
+{
+	return ToId(&gNetAssets, ASSET_KIND_BULLET, BulletClassId(b));
+}
+BulletClass *NetAssetsGetBullet(const int id)
+{
+	const int localId = ToLocalId(&gNetAssets, ASSET_KIND_BULLET, id);
+	return localId >= 0 ? IdBulletClass(localId) : NULL;
+}
+int NetAssetsGunId(const GunDescription *g)
+{
+	return ToId(&gNetAssets, ASSET_KIND_GUN, GunDescriptionId(g));
+}
+const GunDescription *NetAssetsGetGun(const int id)
+{
+	const int localId = ToLocalId(&gNetAssets, ASSET_KIND_GUN, id);
+	return localId >= 0 ? IdGunDescription(localId) : NULL;
+}
+int NetAssetsMapObjectId(const MapObject *mo)
+{
+	return ToId(&gNetAssets, ASSET_KIND_MAP_OBJECT, MapObjectIndex(mo));
+}
+MapObject *NetAssetsGetMapObject(const int id)
+{
+	const int localId = ToLocalId(&gNetAssets, ASSET_KIND_MAP_OBJECT, id);
+	return localId >= 0 ? IndexMapObject(localId) : NULL;
+}
@@ -0,0 +1,89 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "bullet_class.h"
+#include "c_array.h"
+#include "map_object.h"
+#include "name_map.h"
+#include "pic.h"
+#include "proto/msg.pb.h"
+#include "sounds.h"
+#include "weapon.h"
+
+// Kinds of assets that net messages refer to by ID
+typedef enum
+{
+	ASSET_KIND_PIC,
+	ASSET_KIND_SOUND,
+	ASSET_KIND_BULLET,
+	ASSET_KIND_GUN,
+	ASSET_KIND_MAP_OBJECT,
+	ASSET_KIND_COUNT
+} AssetKind;
+
+// Session asset dictionary
+// Net messages refer to assets by compact IDs instead of names. The server's
+// IDs are simply its local asset IDs, and it sends the names for all of them
+// at game start; clients resolve the names to their own assets on first use.
+typedef struct
+{
+	char *Name;
+	int LocalId;	// -1 if not resolved yet
+} NetAssetDef;
+typedef struct
+{
+	CArray Defs[ASSET_KIND_COUNT];	// of NetAssetDef, indexed by session ID
+	NameMap DefsByName[ASSET_KIND_COUNT];
+	// Whether the IDs are from a remote server; otherwise they are local IDs
+	bool IsRemote;
+} NetAssets;
+extern NetAssets gNetAssets;
+
+void NetAssetsInit(NetAssets *na);
+void NetAssetsTerminate(NetAssets *na);
+// Go back to using local IDs
+void NetAssetsReset(NetAssets *na);
+// Add an entry of the server's dictionary; sending the ID 0 starts over
+void NetAssetsAdd(NetAssets *na, const NAssetDef *def);
+
+// The local dictionary, for sending to clients
+int NetAssetsGetNumLocal(const AssetKind kind);
+NAssetDef NetAssetsMakeDef(const AssetKind kind, const int id);
+
+// Convert between assets and the IDs used in net messages; -1 is none
+int NetAssetsPicId(const NamedPic *p);
+NamedPic *NetAssetsGetPic(const int id);
+int NetAssetsSoundId(const char *name);
+Mix_Chunk *NetAssetsGetSound(const int id);
+int NetAssetsBulletId(const BulletClass *b);
+BulletClass *NetAssetsGetBullet(const int id);
+int NetAssetsGunId(const GunDescription *g);
+const GunDescription *NetAssetsGetGun(const int id);
+int NetAssetsMapObjectId(const MapObject *mo);
+MapObject *NetAssetsGetMapObject(const int id);
@@ -36,6 +36,7 @@
 #include "game_events.h"
 #include "gamedata.h"
 #include "log.h"
+#include "net_assets.h"
 #include "net_server.h"
 #include "player.h"
 #include "utils.h"
@@ -53,6 +54,7 @@ void NetClientInit(NetClient *n)
 {
 	memset(n, 0, sizeof *n);
 	n->ClientId = -1;	// -1 is unset
+	NetAssetsInit(&gNetAssets);
 	n->client = enet_host_create(NULL, 1, 2,
 		57600 / 8 /* 56K modem with 56 Kbps downstream bandwidth */,
 		14400 / 8 /* 56K modem with 14 Kbps upstream bandwidth */);
@@ -67,6 +69,7 @@ void NetClientTerminate(NetClient *n)
 	n->peer = NULL;
 	enet_host_destroy(n->client);
 	n->client = NULL;
+	NetAssetsTerminate(&gNetAssets);
 }
 
 void NetClientFindLANServers(NetClient *n)
@@ -146,6 +149,8 @@ void NetClientDisconnect(NetClient *n)
 	}
 	n->ClientId = -1;	// -1 is unset
 	n->Ready = false;
+	// Assets are referred to by local IDs again
+	NetAssetsReset(&gNetAssets);
 }
 
 static void OnReceive(NetClient *n, ENetEvent event);
@@ -259,7 +264,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			}
 			else
 			{
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 		}
 	}
@@ -306,6 +311,15 @@ static void OnReceive(NetClient *n, ENetEvent event)
 				}
 			}
 			break;
+		case GAME_EVENT_ASSET_DEF:
+			{
+				NAssetDef def;
+				NetDecode(event.packet, &def, NAssetDef_fields);
+				LOG(LM_NET, LL_TRACE, "recv assetDef kind(%u) id(%u) name(%s)",
+					def.Kind, def.Id, def.Name);
+				NetAssetsAdd(&gNetAssets, &def);
+			}
+			break;
 		case GAME_EVENT_NET_GAME_START:
 			LOG(LM_NET, LL_DEBUG, "NetClient: received game start");
 			// Don't ready-up unless we're ready
@@ -41,6 +41,7 @@
 #include "handle_game_events.h"
 #include "log.h"
 #include "los.h"
+#include "net_assets.h"
 #include "pickup.h"
 #include "player.h"
 #include "sys_config.h"
@@ -216,7 +217,7 @@ static void OnReceive(NetServer *n, ENetEvent event)
 		LOG(LM_NET, LL_TRACE, "recv gameEvent(%d)", (int)gee.Type);
 		GameEvent e = GameEventNew(gee.Type);
 		NetDecode(event.packet, &e.u, gee.Fields);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	else
 	{
@@ -237,7 +238,7 @@ static void OnReceive(NetServer *n, ENetEvent event)
 				if (pData == NULL) continue;
 				GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
 				e.u.PlayerData = PlayerDataMissionReset(pData);
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			// Flush game events to make sure we reset player data
 			HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -283,6 +284,16 @@ void NetServerFlush(NetServer *n)
 
 void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 {
+	// Send the asset dictionary; the messages below refer to assets by ID
+	for (int k = 0; k < ASSET_KIND_COUNT; k++)
+	{
+		for (int i = 0; i < NetAssetsGetNumLocal((AssetKind)k); i++)
+		{
+			const NAssetDef def = NetAssetsMakeDef((AssetKind)k, i);
+			NetServerSendMsg(n, peerId, GAME_EVENT_ASSET_DEF, &def);
+		}
+	}
+
 	// Send details of all current players
 	for (int i = 0; i < (int)gPlayerDatas.size; i++)
 	{
@@ -342,8 +353,8 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 			const Tile *t = MapGetTile(&gMap, pos);
 			NTileSet ts = NTileSet_init_default;
 			ts.Pos = Vec2i2Net(pos);
-			if (t->pic != NULL) strcpy(ts.PicName, t->pic->name);
-			if (t->picAlt != NULL) strcpy(ts.PicAltName, t->picAlt->name);
+			ts.PicId = NetAssetsPicId(t->pic);
+			ts.PicAltId = NetAssetsPicId(t->picAlt);
 			ts.Flags = t->flags;
 			NetServerSendMsg(n, peerId, GAME_EVENT_TILE_SET, &ts);
 		}
@@ -395,7 +406,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 		if (!o->isInUse) continue;
 		NMapObjectAdd amo = NMapObjectAdd_init_default;
 		amo.UID = o->uid;
-		strcpy(amo.MapObjectClass, o->Class->Name);
+		amo.MapObjectId = NetAssetsMapObjectId(o->Class);
 		amo.Pos = Vec2i2Net(Vec2iNew(o->tileItem.x, o->tileItem.y));
 		amo.TileItemFlags = o->tileItem.flags;
 		amo.Health = o->Health;
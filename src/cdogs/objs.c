@@ -56,8 +56,10 @@
 #include "collision.h"
 #include "config.h"
 #include "damage.h"
+#include "flow_field.h"
 #include "game_events.h"
 #include "map.h"
+#include "net_assets.h"
 #include "net_util.h"
 #include "screen_shake.h"
 #include "blit.h"
@@ -65,15 +67,24 @@
 #include "pickup.h"
 #include "defs.h"
 #include "actors.h"
+#include "entity_pool.h"
 #include "gamedata.h"
 #include "mission.h"
 #include "game.h"
+#include "uid_map.h"
 #include "utils.h"
 
+static ConfigHandle sConfigShotsPushback = CONFIG_HANDLE("Game.ShotsPushback");
+
 CArray gObjs;
 CArray gMobObjs;
 static unsigned int sObjUIDs = 0;
 static unsigned int sMobObjUIDs = 0;
+// UID to index in gObjs/gMobObjs
+static UIDMap sObjUIDMap;
+static UIDMap sMobObjUIDMap;
+static EntityPool sObjPool;
+static EntityPool sMobObjPool;
 
 
 // Draw functions
@@ -121,7 +132,7 @@ static void DestroyObject(
 			GameEvent e = GameEventNew(GAME_EVENT_SCORE);
 			e.u.Score.PlayerUID = playerUID;
 			e.u.Score.Score = OBJECT_SCORE;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 
 		// Weapons that go off when this object is destroyed
@@ -136,7 +147,8 @@ static void DestroyObject(
 		// TODO: doesn't need to be network event
 		GameEvent e = GameEventNew(GAME_EVENT_ADD_BULLET);
 		e.u.AddBullet.UID = MobObjsObjsGetNextUID();
-		strcpy(e.u.AddBullet.BulletClass, "fireball_wreck");
+		e.u.AddBullet.BulletClassId =
+			NetAssetsBulletId(StrBulletClass("fireball_wreck"));
 		e.u.AddBullet.MuzzlePos = Vec2i2Net(fullPos);
 		e.u.AddBullet.MuzzleHeight = 0;
 		e.u.AddBullet.Angle = 0;
@@ -144,7 +156,7 @@ static void DestroyObject(
 		e.u.AddBullet.Flags = 0;
 		e.u.AddBullet.PlayerUID = -1;
 		e.u.AddBullet.ActorUID = -1;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 
 	SoundPlayAt(&gSoundDevice, gSoundDevice.wreckSound, realPos);
@@ -161,7 +173,8 @@ static void DestroyObject(
 
 	// Update pathfinding cache since this object could have blocked a path
 	// before
-	PathCacheClear(&gPathCache);
+	PathCacheClearTile(&gPathCache, Vec2iToTile(realPos));
+	FlowFieldsOpenTile(&gFlowFields, Vec2iToTile(realPos));
 }
 
 bool CanHit(const int flags, const int uid, const TTileItem *target)
@@ -235,7 +248,7 @@ void Damage(
 			e.u.MapObjectDamage.ActorUID = uid;
 			e.u.MapObjectDamage.PlayerUID = playerUID;
 			e.u.MapObjectDamage.Flags = flags;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 	default:
@@ -256,14 +269,14 @@ static void DoDamageCharacter(
 	CASSERT(actor->isInUse, "Cannot damage nonexistent player");
 	CASSERT(CanHitCharacter(flags, uid, actor), "damaging undamageable actor");
 
-	if (ConfigGetBool(&gConfig, "Game.ShotsPushback"))
+	if (ConfigHandleGetBool(&sConfigShotsPushback))
 	{
 		GameEvent ei = GameEventNew(GAME_EVENT_ACTOR_IMPULSE);
 		ei.u.ActorImpulse.UID = actor->uid;
 		ei.u.ActorImpulse.Vel = Vec2i2Net(Vec2iScaleDiv(
 			Vec2iScale(hitVector, power), SHOT_IMPULSE_DIVISOR));
 		ei.u.ActorImpulse.Pos = Vec2i2Net(actor->Pos);
-		GameEventsEnqueue(&gGameEvents, ei);
+		GameEventsEnqueue(&gGameEvents, &ei);
 	}
 
 	const bool canDamage =
@@ -276,7 +289,7 @@ static void DoDamageCharacter(
 	e.u.ActorHit.Special = special;
 	e.u.ActorHit.Power = canDamage ? power : 0;
 	e.u.ActorHit.Vel = Vec2i2Net(hitVector);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 
 	if (canDamage)
 	{
@@ -298,7 +311,7 @@ static void DoDamageCharacter(
 			{
 				e.u.Score.Score = power;
 			}
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 }
@@ -306,22 +319,16 @@ static void DoDamageCharacter(
 
 void UpdateMobileObjects(int ticks)
 {
-	for (int i = 0; i < (int)gMobObjs.size; i++)
-	{
-		TMobileObject *obj = CArrayGet(&gMobObjs, i);
-		if (!obj->isInUse)
-		{
-			continue;
-		}
+	ENTITY_POOL_FOREACH(TMobileObject, obj, sMobObjPool, gMobObjs)
 		if (!obj->updateFunc(obj, ticks) && !gCampaign.IsClient)
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_REMOVE_BULLET);
 			e.u.RemoveBullet.UID = obj->UID;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			continue;
 		}
 		CPicUpdate(&obj->tileItem.CPic, ticks);
-	}
+	ENTITY_POOL_FOREACH_END()
 }
 
 
@@ -330,6 +337,8 @@ void ObjsInit(void)
 	CArrayInit(&gObjs, sizeof(TObject));
 	CArrayReserve(&gObjs, 1024);
 	sObjUIDs = 0;
+	UIDMapInit(&sObjUIDMap);
+	EntityPoolInit(&sObjPool);
 }
 void ObjsTerminate(void)
 {
@@ -342,6 +351,8 @@ void ObjsTerminate(void)
 		}
 	}
 	CArrayTerminate(&gObjs);
+	UIDMapTerminate(&sObjUIDMap);
+	EntityPoolTerminate(&sObjPool);
 }
 int ObjsGetNextUID(void)
 {
@@ -350,29 +361,14 @@ int ObjsGetNextUID(void)
 
 void ObjAdd(const NMapObjectAdd amo)
 {
-	// Find an empty slot in object list
-	TObject *o = NULL;
-	int i;
-	for (i = 0; i < (int)gObjs.size; i++)
-	{
-		TObject *obj = CArrayGet(&gObjs, i);
-		if (!obj->isInUse)
-		{
-			o = obj;
-			break;
-		}
-	}
-	if (o == NULL)
-	{
-		TObject obj;
-		memset(&obj, 0, sizeof obj);
-		CArrayPushBack(&gObjs, &obj);
-		i = (int)gObjs.size - 1;
-		o = CArrayGet(&gObjs, i);
-	}
+	const int i = EntityPoolAdd(&sObjPool, &gObjs);
+	TObject *o = CArrayGet(&gObjs, i);
+	// The slot may be reused; replace its old UID
+	UIDMapRemove(&sObjUIDMap, o->uid, i);
 	memset(o, 0, sizeof *o);
 	o->uid = amo.UID;
-	o->Class = StrMapObject(amo.MapObjectClass);
+	UIDMapSet(&sObjUIDMap, o->uid, i);
+	o->Class = NetAssetsGetMapObject(amo.MapObjectId);
 	o->Health = amo.Health;
 	o->tileItem.x = o->tileItem.y = -1;
 	o->tileItem.flags = amo.TileItemFlags;
@@ -390,6 +386,7 @@ void ObjDestroy(int id)
 	CASSERT(o->isInUse, "Destroying in-use object");
 	MapRemoveTileItem(&gMap, &o->tileItem);
 	o->isInUse = false;
+	EntityPoolRemove(&sObjPool, id);
 }
 
 bool ObjIsDangerous(const TObject *o)
@@ -400,13 +397,7 @@ bool ObjIsDangerous(const TObject *o)
 
 void UpdateObjects(const int ticks)
 {
-	for (int i = 0; i < (int)gObjs.size; i++)
-	{
-		TObject *obj = CArrayGet(&gObjs, i);
-		if (!obj->isInUse)
-		{
-			continue;
-		}
+	ENTITY_POOL_FOREACH(TObject, obj, sObjPool, gObjs)
 		switch (obj->Class->Type)
 		{
 		case MAP_OBJECT_TYPE_PICKUP_SPAWNER:
@@ -432,25 +423,22 @@ void UpdateObjects(const int ticks)
 				e.u.AddPickup.TileItemFlags = 0;
 				e.u.AddPickup.Pos =
 					Vec2i2Net(Vec2iNew(obj->tileItem.x, obj->tileItem.y));
-				GameEventsEnqueue(&gGameEvents, e);
+				GameEventsEnqueue(&gGameEvents, &e);
 			}
 			break;
 		default:
 			// Do nothing
 			break;
 		}
-	}
+	ENTITY_POOL_FOREACH_END()
 }
 
 TObject *ObjGetByUID(const int uid)
 {
-	for (int i = 0; i < (int)gObjs.size; i++)
+	const int i = UIDMapGet(&sObjUIDMap, uid);
+	if (i >= 0)
 	{
-		TObject *o = CArrayGet(&gObjs, i);
-		if (o->uid == uid)
-		{
-			return o;
-		}
+		return CArrayGet(&gObjs, i);
 	}
 	CASSERT(false, "Cannot find object by UID");
 	return NULL;
@@ -462,6 +450,8 @@ void MobObjsInit(void)
 	CArrayInit(&gMobObjs, sizeof(TMobileObject));
 	CArrayReserve(&gMobObjs, 1024);
 	sMobObjUIDs = 0;
+	UIDMapInit(&sMobObjUIDMap);
+	EntityPoolInit(&sMobObjPool);
 }
 void MobObjsTerminate(void)
 {
@@ -474,6 +464,8 @@ void MobObjsTerminate(void)
 		}
 	}
 	CArrayTerminate(&gMobObjs);
+	UIDMapTerminate(&sMobObjUIDMap);
+	EntityPoolTerminate(&sMobObjPool);
 }
 int MobObjsObjsGetNextUID(void)
 {
@@ -481,19 +473,24 @@ int MobObjsObjsGetNextUID(void)
 }
 TMobileObject *MobObjGetByUID(const int uid)
 {
-	for (int i = 0; i < (int)gMobObjs.size; i++)
-	{
-		TMobileObject *o = CArrayGet(&gMobObjs, i);
-		if (o->UID == uid)
-		{
-			return o;
-		}
-	}
-	return NULL;
+	const int i = UIDMapGet(&sMobObjUIDMap, uid);
+	return i >= 0 ? CArrayGet(&gMobObjs, i) : NULL;
+}
+int MobObjAdd(const int uid)
+{
+	const int id = EntityPoolAdd(&sMobObjPool, &gMobObjs);
+	TMobileObject *o = CArrayGet(&gMobObjs, id);
+	// The slot may be reused; replace its old UID
+	UIDMapRemove(&sMobObjUIDMap, o->UID, id);
+	memset(o, 0, sizeof *o);
+	o->UID = uid;
+	UIDMapSet(&sMobObjUIDMap, uid, id);
+	return id;
 }
 void MobObjDestroy(TMobileObject *m)
 {
 	CASSERT(m->isInUse, "Destroying not-in-use mobobj");
 	MapRemoveTileItem(&gMap, &m->tileItem);
 	m->isInUse = false;
+	EntityPoolRemove(&sMobObjPool, m->tileItem.id);
 }
@@ -133,4 +133,6 @@ void MobObjsInit(void);
 void MobObjsTerminate(void);
 int MobObjsObjsGetNextUID(void);
 TMobileObject *MobObjGetByUID(const int uid);
+// Get a cleared mobile object slot with this UID; returns its index
+int MobObjAdd(const int uid);
 void MobObjDestroy(TMobileObject *m);
@@ -28,13 +28,18 @@
 #include "particle.h"
 
 #include "collision.h"
+#include "entity_pool.h"
 #include "game_events.h"
 #include "json_utils.h"
 #include "objs.h"
 
+static ConfigHandle sConfigGore = CONFIG_HANDLE("Game.Gore");
+static ConfigHandle sConfigShotsPushback = CONFIG_HANDLE("Game.ShotsPushback");
+
 
 ParticleClasses gParticleClasses;
 CArray gParticles;
+static EntityPool sParticlePool;
 
 #define VERSION 1
 
@@ -43,6 +48,12 @@ void ParticleClassesInit(ParticleClasses *classes, const char *filename)
 {
 	CArrayInit(&classes->Classes, sizeof(ParticleClass));
 	CArrayInit(&classes->CustomClasses, sizeof(ParticleClass));
+	NAME_MAP_INIT(
+		&classes->ClassesByName, &classes->Classes, ParticleClass, Name,
+		true);
+	NAME_MAP_INIT(
+		&classes->CustomClassesByName, &classes->CustomClasses,
+		ParticleClass, Name, true);
 
 	FILE *f = fopen(filename, "r");
 	json_t *root = NULL;
@@ -90,6 +101,8 @@ void ParticleClassesTerminate(ParticleClasses *classes)
 	CArrayTerminate(&classes->Classes);
 	ParticleClassesClear(&classes->CustomClasses);
 	CArrayTerminate(&classes->CustomClasses);
+	NameMapTerminate(&classes->ClassesByName);
+	NameMapTerminate(&classes->CustomClassesByName);
 }
 void ParticleClassesClear(CArray *classes)
 {
@@ -151,21 +164,15 @@ const ParticleClass *StrParticleClass(
 	{
 		return NULL;
 	}
-	for (int i = 0; i < (int)classes->CustomClasses.size; i++)
+	int i = NameMapGet(&classes->CustomClassesByName, name);
+	if (i >= 0)
 	{
-		const ParticleClass *c = CArrayGet(&classes->CustomClasses, i);
-		if (strcmp(c->Name, name) == 0)
-		{
-			return c;
-		}
+		return CArrayGet(&classes->CustomClasses, i);
 	}
-	for (int i = 0; i < (int)classes->Classes.size; i++)
+	i = NameMapGet(&classes->ClassesByName, name);
+	if (i >= 0)
 	{
-		const ParticleClass *c = CArrayGet(&classes->Classes, i);
-		if (strcmp(c->Name, name) == 0)
-		{
-			return c;
-		}
+		return CArrayGet(&classes->Classes, i);
 	}
 	CASSERT(false, "Cannot find particle class");
 	return NULL;
@@ -175,6 +182,7 @@ void ParticlesInit(CArray *particles)
 {
 	CArrayInit(particles, sizeof(Particle));
 	CArrayReserve(particles, 256);
+	EntityPoolInit(&sParticlePool);
 }
 void ParticlesTerminate(CArray *particles)
 {
@@ -187,25 +195,20 @@ void ParticlesTerminate(CArray *particles)
 		}
 	}
 	CArrayTerminate(particles);
+	EntityPoolTerminate(&sParticlePool);
 }
 
 static bool ParticleUpdate(Particle *p, const int ticks);
 void ParticlesUpdate(CArray *particles, const int ticks)
 {
-	for (int i = 0; i < (int)particles->size; i++)
-	{
-		Particle *p = CArrayGet(particles, i);
-		if (!p->isInUse)
-		{
-			continue;
-		}
+	ENTITY_POOL_FOREACH(Particle, p, sParticlePool, *particles)
 		if (!ParticleUpdate(p, ticks))
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_PARTICLE_REMOVE);
-			e.u.ParticleRemoveId = i;
-			GameEventsEnqueue(&gGameEvents, e);
+			e.u.ParticleRemoveId = p->tileItem.id;
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
-	}
+	ENTITY_POOL_FOREACH_END()
 }
 
 
@@ -285,27 +288,8 @@ static bool ParticleUpdate(Particle *p, const int ticks)
 static void DrawParticle(const Vec2i pos, const TileItemDrawFuncData *data);
 int ParticleAdd(CArray *particles, const AddParticle add)
 {
-	// Find an empty slot in list
-	Particle *p = NULL;
-	int i;
-	for (i = 0; i < (int)particles->size; i++)
-	{
-		Particle *pSlot = CArrayGet(particles, i);
-		if (!pSlot->isInUse)
-		{
-			p = pSlot;
-			break;
-		}
-	}
-	// If no empty slots, add a new one
-	if (p == NULL)
-	{
-		Particle pNew;
-		memset(&pNew, 0, sizeof pNew);
-		CArrayPushBack(particles, &pNew);
-		i = (int)particles->size - 1;
-		p = CArrayGet(particles, i);
-	}
+	const int i = EntityPoolAdd(&sParticlePool, particles);
+	Particle *p = CArrayGet(particles, i);
 	memset(p, 0, sizeof *p);
 	p->Class = add.Class;
 	p->Pos = add.FullPos;
@@ -330,6 +314,7 @@ void ParticleDestroy(CArray *particles, const int id)
 	CASSERT(p->isInUse, "Destroying not-in-use particle");
 	MapRemoveTileItem(&gMap, &p->tileItem);
 	p->isInUse = false;
+	EntityPoolRemove(&sParticlePool, id);
 }
 
 static void DrawParticle(const Vec2i pos, const TileItemDrawFuncData *data)
@@ -361,7 +346,7 @@ static void DrawParticle(const Vec2i pos, const TileItemDrawFuncData *data)
 void AddBloodSplatter(
 	const Vec2i fullPos, const int power, const Vec2i hitVector)
 {
-	const GoreAmount ga = ConfigGetEnum(&gConfig, "Game.Gore");
+	const GoreAmount ga = ConfigHandleGetEnum(&sConfigGore);
 	if (ga == GORE_NONE) return;
 
 	GameEvent e = GameEventNew(GAME_EVENT_ADD_PARTICLE);
@@ -391,7 +376,7 @@ void AddBloodSplatter(
 		{
 			bloodSize = 1;
 		}
-		if (ConfigGetBool(&gConfig, "Game.ShotsPushback"))
+		if (ConfigHandleGetBool(&sConfigShotsPushback))
 		{
 			e.u.AddParticle.Vel = Vec2iScaleDiv(
 				Vec2iScale(hitVector, (rand() % 8 + 8) * power),
@@ -407,7 +392,7 @@ void AddBloodSplatter(
 		e.u.AddParticle.Angle = RAND_DOUBLE(0, PI * 2);
 		e.u.AddParticle.DZ = (rand() % 6) + 6;
 		e.u.AddParticle.Spin = RAND_DOUBLE(-0.1, 0.1);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		switch (ga)
 		{
 		case GORE_LOW:
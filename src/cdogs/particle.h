@@ -29,6 +29,7 @@
 
 #include <json/json.h>
 
+#include "name_map.h"
 #include "pic.h"
 #include "tile.h"
 
@@ -51,6 +52,8 @@ typedef struct
 {
 	CArray Classes;	// of ParticleClass
 	CArray CustomClasses;	// of ParticleClass
+	NameMap ClassesByName;
+	NameMap CustomClassesByName;
 } ParticleClasses;
 extern ParticleClasses gParticleClasses;
 
@@ -27,8 +27,6 @@
 */
 #include "path_cache.h"
 
-#include <math.h>
-
 #include "ai_utils.h"
 
 #define PATH_CACHE_MAX 128
@@ -36,10 +34,9 @@
 PathCache gPathCache;
 
 
-static CachedPath CachedPathCopy(CachedPath *c)
+static CachedPath CachedPathCopy(const CachedPath *c)
 {
-	CachedPath copy;
-	memcpy(&copy, c, sizeof *c);
+	CachedPath copy = *c;
 	(*copy.refs)++;
 	return copy;
 }
@@ -57,167 +54,459 @@ void CachedPathDestroy(CachedPath *c)
 		CFREE(c->refs);
 	}
 }
+size_t CachedPathGetCount(const CachedPath *c)
+{
+	return c->count + (c->hasEnd ? 1 : 0);
+}
+Vec2i *CachedPathGetNode(CachedPath *c, const size_t idx)
+{
+	if (idx < c->count)
+	{
+		return ASPathGetNode(c->Path, c->start + idx);
+	}
+	if (c->hasEnd && idx == c->count)
+	{
+		return &c->end;
+	}
+	return NULL;
+}
 
-static bool CachedPathMatches(
-	const CachedPath *c, const Vec2i from, const Vec2i to)
+
+typedef struct
 {
-	return Vec2iEqual(c->from, from) && Vec2iEqual(c->to, to);
+	Map *Map;
+	TileSelectFunc IsTileOk;
+} AStarContext;
+
+// if we're moving diagonally,
+// need to check the axis-aligned neighbours are also clear
+static bool IsStepOk(const AStarContext *c, const Vec2i from, const Vec2i to)
+{
+	return c->IsTileOk(c->Map, to) &&
+		c->IsTileOk(c->Map, Vec2iNew(from.x, to.y)) &&
+		c->IsTileOk(c->Map, Vec2iNew(to.x, from.y));
 }
 
 
+// FNV-1a over the key fields
+static Uint32 HashInt(const Uint32 h, const int x)
+{
+	return (h ^ (Uint32)x) * 16777619u;
+}
+static int Bucket(Uint32 h)
+{
+	h ^= h >> 16;
+	return (int)(h & (PATH_CACHE_BUCKETS - 1));
+}
+static int KeyBucket(const Vec2i from, const Vec2i to, const bool ignoreObjects)
+{
+	Uint32 h = 2166136261u;
+	h = HashInt(h, from.x);
+	h = HashInt(h, from.y);
+	h = HashInt(h, to.x);
+	h = HashInt(h, to.y);
+	return Bucket(HashInt(h, ignoreObjects));
+}
+static int GoalBucket(const Vec2i to, const bool ignoreObjects)
+{
+	Uint32 h = 2166136261u;
+	h = HashInt(h, to.x);
+	h = HashInt(h, to.y);
+	return Bucket(HashInt(h, ignoreObjects));
+}
+
+static PathCacheEntry *GetEntry(const PathCache *pc, const int i)
+{
+	return CArrayGet(&pc->entries, i);
+}
+
+static void ResetIndices(PathCache *pc)
+{
+	for (int i = 0; i < PATH_CACHE_BUCKETS; i++)
+	{
+		pc->byKey[i] = -1;
+		pc->byGoal[i] = -1;
+	}
+	pc->newest = -1;
+	pc->oldest = -1;
+	pc->free = -1;
+}
 void PathCacheInit(PathCache *pc, Map *m)
 {
-	CArrayInit(&pc->paths, sizeof(CachedPath));
-	pc->head = 0;
+	CArrayInit(&pc->entries, sizeof(PathCacheEntry));
+	ResetIndices(pc);
+	PathGraphInit(&pc->graph, m);
+	AStarGridInit(&pc->grid, m);
 	pc->map = m;
 }
 void PathCacheTerminate(PathCache *pc)
 {
 	PathCacheClear(pc);
-	CArrayTerminate(&pc->paths);
+	CArrayTerminate(&pc->entries);
+	PathGraphTerminate(&pc->graph);
+	AStarGridTerminate(&pc->grid);
 }
 
 void PathCacheClear(PathCache *pc)
 {
-	for (int i = 0; i < (int)pc->paths.size; i++)
+	// Free entries have their paths zeroed
+	CA_FOREACH(PathCacheEntry, e, pc->entries)
+		CachedPathDestroy(&e->path);
+	CA_FOREACH_END()
+	CArrayClear(&pc->entries);
+	ResetIndices(pc);
+}
+
+static void LRUUnlink(PathCache *pc, const PathCacheEntry *e)
+{
+	if (e->prev != -1)
+	{
+		GetEntry(pc, e->prev)->next = e->next;
+	}
+	else
 	{
-		CachedPath *c = CArrayGet(&pc->paths, i);
-		CachedPathDestroy(c);
+		pc->newest = e->next;
+	}
+	if (e->next != -1)
+	{
+		GetEntry(pc, e->next)->prev = e->prev;
+	}
+	else
+	{
+		pc->oldest = e->prev;
 	}
-	CArrayClear(&pc->paths);
-	pc->head = 0;
+}
+static void LRUPushFront(PathCache *pc, const int i)
+{
+	PathCacheEntry *e = GetEntry(pc, i);
+	e->prev = -1;
+	e->next = pc->newest;
+	if (pc->newest != -1)
+	{
+		GetEntry(pc, pc->newest)->prev = i;
+	}
+	else
+	{
+		pc->oldest = i;
+	}
+	pc->newest = i;
+}
+static void Touch(PathCache *pc, const int i)
+{
+	if (pc->newest == i)
+	{
+		return;
+	}
+	LRUUnlink(pc, GetEntry(pc, i));
+	LRUPushFront(pc, i);
 }
 
-typedef struct
+static void RemoveEntry(PathCache *pc, const int i)
 {
-	Map *Map;
-	TileSelectFunc IsTileOk;
-} AStarContext;
-static void AddTileNeighbors(
-	ASNeighborList neighbors, void *node, void *context);
-static float AStarHeuristic(void *fromNode, void *toNode, void *context);
-static ASPathNodeSource cPathNodeSource =
+	PathCacheEntry *e = GetEntry(pc, i);
+	LRUUnlink(pc, e);
+	int *link = &pc->byKey[
+		KeyBucket(e->path.from, e->path.to, e->ignoreObjects)];
+	while (*link != i)
+	{
+		link = &GetEntry(pc, *link)->nextKey;
+	}
+	*link = e->nextKey;
+	link = &pc->byGoal[GoalBucket(e->path.to, e->ignoreObjects)];
+	while (*link != i)
+	{
+		link = &GetEntry(pc, *link)->nextGoal;
+	}
+	*link = e->nextGoal;
+	CachedPathDestroy(&e->path);
+	memset(&e->path, 0, sizeof e->path);
+	e->next = pc->free;
+	pc->free = i;
+}
+static int AllocEntry(PathCache *pc)
 {
-	sizeof(Vec2i), AddTileNeighbors, AStarHeuristic, NULL, NULL
-};
-CachedPath PathCacheCreate(
-	PathCache *pc, Vec2i from, Vec2i to,
-	const bool ignoreObjects, const bool cache)
+	if (pc->free == -1)
+	{
+		if ((int)pc->entries.size < PATH_CACHE_MAX)
+		{
+			PathCacheEntry e;
+			memset(&e, 0, sizeof e);
+			CArrayPushBack(&pc->entries, &e);
+			return (int)pc->entries.size - 1;
+		}
+		// Full; evict the least recently used path
+		RemoveEntry(pc, pc->oldest);
+	}
+	const int i = pc->free;
+	pc->free = GetEntry(pc, i)->next;
+	return i;
+}
+static void AddEntry(
+	PathCache *pc, const CachedPath *c, const bool ignoreObjects)
 {
-	debug(D_NORMAL, "Pathfind from (%d, %d) to (%d, %d)...",
-		from.x, from.y, to.x, to.y);
+	const int i = AllocEntry(pc);
+	PathCacheEntry *e = GetEntry(pc, i);
+	e->path = *c;
+	e->ignoreObjects = ignoreObjects;
+	int *bucket = &pc->byKey[KeyBucket(c->from, c->to, ignoreObjects)];
+	e->nextKey = *bucket;
+	*bucket = i;
+	bucket = &pc->byGoal[GoalBucket(c->to, ignoreObjects)];
+	e->nextGoal = *bucket;
+	*bucket = i;
+	LRUPushFront(pc, i);
+}
 
-	// Search through existing cache for path
-	for (int i = 0; i < (int)pc->paths.size; i++)
+static int FindEntry(
+	const PathCache *pc, const Vec2i from, const Vec2i to,
+	const bool ignoreObjects)
+{
+	for (int i = pc->byKey[KeyBucket(from, to, ignoreObjects)]; i != -1;)
 	{
-		CachedPath *c = CArrayGet(&pc->paths, i);
-		if (CachedPathMatches(c, from, to))
+		const PathCacheEntry *e = GetEntry(pc, i);
+		if (e->ignoreObjects == ignoreObjects &&
+			Vec2iEqual(e->path.from, from) && Vec2iEqual(e->path.to, to))
 		{
-			debug(D_NORMAL, "returning cached path\n");
-			return CachedPathCopy(c);
+			return i;
 		}
+		i = e->nextKey;
 	}
+	return -1;
+}
 
-	debug(D_NORMAL, "pathfinding\n");
-
-	// Cached path not found; find the path now
-	CachedPath cp;
-	AStarContext ac;
-	ac.Map = pc->map;
-	ac.IsTileOk = ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects;
-	cp.Path = ASPathCreate(&cPathNodeSource, &ac, &from, &to);
-	CMALLOC(cp.refs, sizeof *cp.refs);
-	(*cp.refs) = 1;
-	cp.from = from;
-	cp.to = to;
-	// Cache the path, optionally
-	if (cache)
+// Take the part of a cached path from the start,
+// either up to the goal if it lies on the path,
+// or to the end of the path plus a step to the goal
+static bool CachedPathReuse(
+	CachedPath *out, const CachedPath *c, const Vec2i from, const Vec2i to,
+	const AStarContext *ac)
+{
+	const size_t count = ASPathGetCount(c->Path);
+	size_t start;
+	for (start = 0; start < count; start++)
 	{
-		(*cp.refs)++;
-		// Add to the cache if we are under the max size
-		if ((int)pc->paths.size < PATH_CACHE_MAX)
+		if (Vec2iEqual(*(Vec2i *)ASPathGetNode(c->Path, start), from))
+		{
+			break;
+		}
+	}
+	if (start + 1 >= count)
+	{
+		return false;
+	}
+	size_t end;
+	for (end = start + 1; end < count; end++)
+	{
+		if (Vec2iEqual(*(Vec2i *)ASPathGetNode(c->Path, end), to))
 		{
-			CArrayPushBack(&pc->paths, &cp);
+			break;
 		}
-		else
+	}
+	const bool hasEnd = end == count;
+	if (hasEnd)
+	{
+		end--;
+		const Vec2i last = *(Vec2i *)ASPathGetNode(c->Path, end);
+		if (CHEBYSHEV_DISTANCE(last.x, last.y, to.x, to.y) != 1 ||
+			!IsStepOk(ac, last, to))
 		{
-			// Replace the oldest cached path with this one
-			CachedPath *oldest = CArrayGet(&pc->paths, pc->head);
-			CachedPathDestroy(oldest);
-			memcpy(oldest, &cp, sizeof cp);
-			// Move the head
-			pc->head++;
-			if (pc->head == pc->paths.size)
+			return false;
+		}
+	}
+	*out = CachedPathCopy(c);
+	out->from = from;
+	out->to = to;
+	out->start = start;
+	out->count = end + 1 - start;
+	out->hasEnd = hasEnd;
+	out->end = to;
+	return true;
+}
+// Look for a cached path that passes through the start,
+// to the same goal or one within a tile of it
+// This is the common case of many AI chasing the same player
+static bool FindPartialPath(
+	PathCache *pc, CachedPath *out, const Vec2i from, const Vec2i to,
+	const bool ignoreObjects, const AStarContext *ac)
+{
+	Vec2i goal;
+	for (goal.y = to.y - 1; goal.y <= to.y + 1; goal.y++)
+	{
+		for (goal.x = to.x - 1; goal.x <= to.x + 1; goal.x++)
+		{
+			int i = pc->byGoal[GoalBucket(goal, ignoreObjects)];
+			while (i != -1)
 			{
-				pc->head = 0;
+				const PathCacheEntry *e = GetEntry(pc, i);
+				if (e->ignoreObjects == ignoreObjects &&
+					Vec2iEqual(e->path.to, goal) &&
+					CachedPathReuse(out, &e->path, from, to, ac))
+				{
+					Touch(pc, i);
+					return true;
+				}
+				i = e->nextGoal;
 			}
 		}
-		debug(D_NORMAL, "Cached pathfind (%d paths)\n", (int)pc->paths.size);
 	}
-	return cp;
+	return false;
 }
 
-static void AddTileNeighbors(
-	ASNeighborList neighbors, void *node, void *context)
+static bool CachedPathIsAffected(const CachedPath *c, const Vec2i tile)
 {
-	Vec2i *v = node;
-	int y;
-	AStarContext *c = context;
-	for (y = v->y - 1; y <= v->y + 1; y++)
+	// Failed paths may now succeed
+	if (c->Path == NULL)
+	{
+		return true;
+	}
+	// Paths through or cutting diagonally past the tile may now be blocked
+	for (size_t i = 0; i < ASPathGetCount(c->Path); i++)
 	{
-		int x;
-		if (y < 0 || y >= c->Map->Size.y)
+		const Vec2i *v = ASPathGetNode(c->Path, i);
+		if (CHEBYSHEV_DISTANCE(v->x, v->y, tile.x, tile.y) <= 1)
 		{
-			continue;
+			return true;
 		}
-		for (x = v->x - 1; x <= v->x + 1; x++)
+	}
+	return false;
+}
+void PathCacheClearTile(PathCache *pc, const Vec2i tile)
+{
+	PathGraphUpdateTile(&pc->graph, tile);
+	int i = pc->newest;
+	while (i != -1)
+	{
+		const int next = GetEntry(pc, i)->next;
+		if (CachedPathIsAffected(&GetEntry(pc, i)->path, tile))
 		{
-			float cost;
-			Vec2i neighbor;
-			neighbor.x = x;
-			neighbor.y = y;
-			if (x < 0 || x >= c->Map->Size.x)
-			{
-				continue;
-			}
-			if (x == v->x && y == v->y)
-			{
-				continue;
-			}
-			// if we're moving diagonally,
-			// need to check the axis-aligned neighbours are also clear
-			if (!c->IsTileOk(c->Map, Vec2iNew(x, y)) ||
-				!c->IsTileOk(c->Map, Vec2iNew(v->x, y)) ||
-				!c->IsTileOk(c->Map, Vec2iNew(x, v->y)))
-			{
-				continue;
-			}
-			// Calculate cost of direction
-			// Note that there are different horizontal and vertical costs,
-			// due to the tiles being non-square
-			// Slightly prefer axes instead of diagonals
-			if (x != v->x && y != v->y)
-			{
-				cost = TILE_WIDTH * 1.1f;
-			}
-			else if (x != v->x)
-			{
-				cost = TILE_WIDTH;
-			}
-			else
+			RemoveEntry(pc, i);
+		}
+		i = next;
+	}
+}
+void PathCacheClearDoors(PathCache *pc, const int keyFlags)
+{
+	if (keyFlags == 0)
+	{
+		return;
+	}
+	Vec2i v;
+	for (v.y = 0; v.y < pc->map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < pc->map->Size.x; v.x++)
+		{
+			const Tile *t = MapGetTile(pc->map, v);
+			if ((t->flags & MAPTILE_OFFSET_PIC) &&
+				(MapGetDoorKeycardFlag(pc->map, v) & keyFlags))
 			{
-				cost = TILE_HEIGHT;
+				PathCacheClearTile(pc, v);
 			}
-			ASNeighborListAdd(neighbors, &neighbor, cost);
 		}
 	}
 }
-static float AStarHeuristic(void *fromNode, void *toNode, void *context)
+
+// Join up the waypoints from the path graph with A* between each one
+static ASPath JoinWaypoints(
+	PathCache *pc, const AStarContext *ac, const CArray *waypoints)
 {
-	// Simple Euclidean
-	Vec2i *v1 = fromNode;
-	Vec2i *v2 = toNode;
-	UNUSED(context);
-	return (float)sqrt(DistanceSquared(
-		Vec2iCenterOfTile(*v1), Vec2iCenterOfTile(*v2)));
+	CArray nodes;
+	CArrayInit(&nodes, sizeof(Vec2i));
+	CArrayPushBack(&nodes, CArrayGet(waypoints, 0));
+	float cost = 0;
+	ASPath path = NULL;
+	for (int i = 1; i < (int)waypoints->size; i++)
+	{
+		ASPath leg = AStarGridFindPath(
+			&pc->grid, *(const Vec2i *)CArrayGet(waypoints, i - 1),
+			*(const Vec2i *)CArrayGet(waypoints, i), ac->IsTileOk, true);
+		if (leg == NULL)
+		{
+			goto bail;
+		}
+		for (size_t j = 1; j < ASPathGetCount(leg); j++)
+		{
+			CArrayPushBack(&nodes, ASPathGetNode(leg, j));
+		}
+		cost += ASPathGetCost(leg);
+		ASPathDestroy(leg);
+	}
+	path = ASPathCreateFromNodes(sizeof(Vec2i), nodes.data, nodes.size, cost);
+
+bail:
+	CArrayTerminate(&nodes);
+	return path;
+}
+// Long paths ignoring objects are found with the path graph, which
+// searches far fewer nodes than A* over the whole map
+static ASPath FindPath(
+	PathCache *pc, AStarContext *ac, Vec2i from, Vec2i to,
+	const bool ignoreObjects)
+{
+	if (!ignoreObjects ||
+		CHEBYSHEV_DISTANCE(from.x, from.y, to.x, to.y) <
+		PATH_GRAPH_CLUSTER_SIZE * 2)
+	{
+		return AStarGridFindPath(&pc->grid, from, to, ac->IsTileOk, true);
+	}
+	CArray waypoints;
+	CArrayInit(&waypoints, sizeof(Vec2i));
+	ASPath path = NULL;
+	if (PathGraphFindWaypoints(&pc->graph, from, to, &waypoints))
+	{
+		path = JoinWaypoints(pc, ac, &waypoints);
+		if (path == NULL)
+		{
+			// The graph is out of date; fall back to A*
+			path = AStarGridFindPath(&pc->grid, from, to, ac->IsTileOk, true);
+		}
+	}
+	CArrayTerminate(&waypoints);
+	return path;
+}
+CachedPath PathCacheCreate(
+	PathCache *pc, Vec2i from, Vec2i to,
+	const bool ignoreObjects, const bool cache)
+{
+	debug(D_NORMAL, "Pathfind from (%d, %d) to (%d, %d)...",
+		from.x, from.y, to.x, to.y);
+
+	AStarContext ac;
+	ac.Map = pc->map;
+	ac.IsTileOk = ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects;
+
+	// Search through existing cache for path
+	const int i = FindEntry(pc, from, to, ignoreObjects);
+	if (i != -1)
+	{
+		debug(D_NORMAL, "returning cached path\n");
+		Touch(pc, i);
+		return CachedPathCopy(&GetEntry(pc, i)->path);
+	}
+	CachedPath cp;
+	if (FindPartialPath(pc, &cp, from, to, ignoreObjects, &ac))
+	{
+		debug(D_NORMAL, "returning part of cached path\n");
+		return cp;
+	}
+
+	debug(D_NORMAL, "pathfinding\n");
+
+	// Cached path not found; find the path now
+	cp.Path = FindPath(pc, &ac, from, to, ignoreObjects);
+	CMALLOC(cp.refs, sizeof *cp.refs);
+	(*cp.refs) = 1;
+	cp.from = from;
+	cp.to = to;
+	cp.start = 0;
+	cp.count = ASPathGetCount(cp.Path);
+	cp.hasEnd = false;
+	cp.end = to;
+	// Cache the path, optionally
+	if (cache)
+	{
+		(*cp.refs)++;
+		AddEntry(pc, &cp, ignoreObjects);
+		debug(D_NORMAL, "Cached pathfind\n");
+	}
+	return cp;
 }
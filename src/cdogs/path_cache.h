@@ -28,24 +28,51 @@
 #pragma once
 
 #include "AStar.h"
+#include "astar_grid.h"
 #include "c_array.h"
 #include "map.h"
+#include "path_graph.h"
 #include "vector.h"
 
+#define PATH_CACHE_BUCKETS 256
+
 // Ref-counted path reference
 // Once refs reaches zero, can then free the path
+// Paths reused from the cache may only cover part of the shared A* path,
+// with an optional extra step at the end; use the accessors below
 typedef struct
 {
 	ASPath Path;
 	int *refs;
 	Vec2i from;
 	Vec2i to;
+	size_t start;
+	size_t count;
+	bool hasEnd;
+	Vec2i end;
 } CachedPath;
 
 typedef struct
 {
-	CArray paths;	// of CachedPath
-	size_t head;
+	CachedPath path;
+	bool ignoreObjects;
+	// Indices into the cache entries, -1 terminated
+	int prev;	// LRU list, towards most recently used
+	int next;	// LRU list, towards least recently used; also free list
+	int nextKey;	// hash chain by (from, to, ignoreObjects)
+	int nextGoal;	// hash chain by (to, ignoreObjects)
+} PathCacheEntry;
+
+typedef struct
+{
+	CArray entries;	// of PathCacheEntry
+	int byKey[PATH_CACHE_BUCKETS];
+	int byGoal[PATH_CACHE_BUCKETS];
+	int newest;
+	int oldest;
+	int free;
+	PathGraph graph;
+	AStarGrid grid;
 	Map *map;
 } PathCache;
 
@@ -55,15 +82,25 @@ typedef struct
 extern PathCache gPathCache;
 
 void CachedPathDestroy(CachedPath *c);
+size_t CachedPathGetCount(const CachedPath *c);
+// Returns NULL if out of range
+Vec2i *CachedPathGetNode(CachedPath *c, const size_t idx);
 
 void PathCacheInit(PathCache *pc, Map *m);
 void PathCacheTerminate(PathCache *pc);
 
 // Clear all entries in cache
-// This is done when the underlying map changes, changing paths
-// e.g. keys
 void PathCacheClear(PathCache *pc);
+// Drop the paths affected by a change in walkability of this tile,
+// e.g. an object destroyed, and update the path graph
+// Paths that failed to reach their goal are dropped too,
+// since the tile may have opened a way through
+void PathCacheClearTile(PathCache *pc, const Vec2i tile);
+// Drop the paths affected by the doors that these keys open
+void PathCacheClearDoors(PathCache *pc, const int keyFlags);
 
+// Find a path, reusing a cached one if the start lies on a cached path
+// whose goal is the same or within a tile of this goal
 CachedPath PathCacheCreate(
 	PathCache *pc, Vec2i from, Vec2i to,
-	const bool ignoreObjects, const bool cache);
\ No newline at end of file
+	const bool ignoreObjects, const bool cache);
@@ -0,0 +1,459 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "path_graph.h"
+
+#include <limits.h>
+#include <math.h>
+
+#include "AStar.h"
+#include "ai_utils.h"
+
+#define UNREACHABLE INT_MAX
+// Long runs of open tiles along an edge get an entrance at each end,
+// otherwise just one in the middle
+#define ENTRANCE_RUN_SPLIT 6
+#define CLUSTER_TILES (PATH_GRAPH_CLUSTER_SIZE * PATH_GRAPH_CLUSTER_SIZE)
+
+// Node keys of the search; the start and goal are not entrances
+#define START_NODE -1
+#define GOAL_NODE -2
+typedef struct
+{
+	int Cluster;
+	int Node;
+} PathGraphKey;
+
+
+void PathGraphInit(PathGraph *g, Map *m)
+{
+	CArrayInit(&g->clusters, sizeof(PathGraphCluster));
+	g->size = Vec2iZero();
+	CArrayInit(&g->walkable, sizeof(bool));
+	g->isBuilt = false;
+	g->map = m;
+}
+void PathGraphTerminate(PathGraph *g)
+{
+	CA_FOREACH(PathGraphCluster, c, g->clusters)
+		CArrayTerminate(&c->Nodes);
+		CArrayTerminate(&c->Dist);
+	CA_FOREACH_END()
+	CArrayTerminate(&g->clusters);
+	CArrayTerminate(&g->walkable);
+	g->isBuilt = false;
+}
+
+static bool IsWalkable(const PathGraph *g, const Vec2i v)
+{
+	const bool *walkable = g->walkable.data;
+	return MapIsTileIn(g->map, v) && walkable[v.y * g->map->Size.x + v.x];
+}
+static int StepCost(const Vec2i d)
+{
+	if (d.x != 0 && d.y != 0)
+	{
+		return PATH_COST_DIAGONAL;
+	}
+	return d.x != 0 ? PATH_COST_X : PATH_COST_Y;
+}
+static PathGraphCluster *GetCluster(const PathGraph *g, const int i)
+{
+	return CArrayGet(&g->clusters, i);
+}
+static int ClusterIndexOf(const PathGraph *g, const Vec2i tile)
+{
+	return tile.y / PATH_GRAPH_CLUSTER_SIZE * g->size.x +
+		tile.x / PATH_GRAPH_CLUSTER_SIZE;
+}
+static bool IsInCluster(const PathGraphCluster *c, const Vec2i v)
+{
+	return v.x >= c->Pos.x && v.x < c->Pos.x + c->Size.x &&
+		v.y >= c->Pos.y && v.y < c->Pos.y + c->Size.y;
+}
+static int TileIndex(const PathGraphCluster *c, const Vec2i v)
+{
+	return (v.y - c->Pos.y) * c->Size.x + v.x - c->Pos.x;
+}
+
+// Distances from a tile to all the tiles of a cluster,
+// moving only within the cluster
+static void ClusterDijkstra(
+	const PathGraph *g, const PathGraphCluster *c, const Vec2i start,
+	int *dist)
+{
+	const int count = c->Size.x * c->Size.y;
+	bool done[CLUSTER_TILES];
+	for (int i = 0; i < count; i++)
+	{
+		dist[i] = UNREACHABLE;
+		done[i] = false;
+	}
+	dist[TileIndex(c, start)] = 0;
+	for (;;)
+	{
+		// Clusters are small; find the closest tile by scanning
+		int closest = -1;
+		for (int i = 0; i < count; i++)
+		{
+			if (!done[i] && dist[i] != UNREACHABLE &&
+				(closest == -1 || dist[i] < dist[closest]))
+			{
+				closest = i;
+			}
+		}
+		if (closest == -1)
+		{
+			break;
+		}
+		done[closest] = true;
+		const Vec2i v = Vec2iNew(
+			c->Pos.x + closest % c->Size.x, c->Pos.y + closest / c->Size.x);
+		Vec2i d;
+		for (d.y = -1; d.y <= 1; d.y++)
+		{
+			for (d.x = -1; d.x <= 1; d.x++)
+			{
+				const Vec2i u = Vec2iAdd(v, d);
+				// Same as A*: diagonal steps need both axis tiles clear
+				if ((d.x == 0 && d.y == 0) || !IsInCluster(c, u) ||
+					!IsWalkable(g, u) ||
+					!IsWalkable(g, Vec2iNew(v.x, u.y)) ||
+					!IsWalkable(g, Vec2iNew(u.x, v.y)))
+				{
+					continue;
+				}
+				const int i = TileIndex(c, u);
+				dist[i] = MIN(dist[i], dist[closest] + StepCost(d));
+			}
+		}
+	}
+}
+
+static void AddEntrance(PathGraphCluster *c, const Vec2i v, const Vec2i out)
+{
+	PathGraphNode n;
+	n.Tile = v;
+	n.Exit = Vec2iAdd(v, out);
+	CArrayPushBack(&c->Nodes, &n);
+}
+// Add entrances along an edge of the cluster, where the tiles on both
+// sides are open
+// Neighbouring clusters scan their shared edge the same way, so the
+// entrances on both sides match up
+static void AddEntrances(
+	const PathGraph *g, PathGraphCluster *c,
+	const Vec2i start, const Vec2i along, const Vec2i out, const int length)
+{
+	int runStart = -1;
+	for (int i = 0; i <= length; i++)
+	{
+		const Vec2i v = Vec2iAdd(start, Vec2iScale(along, i));
+		const bool isOpen =
+			i < length && IsWalkable(g, v) && IsWalkable(g, Vec2iAdd(v, out));
+		if (isOpen && runStart == -1)
+		{
+			runStart = i;
+		}
+		else if (!isOpen && runStart != -1)
+		{
+			const int runEnd = i - 1;
+			if (runEnd - runStart + 1 < ENTRANCE_RUN_SPLIT)
+			{
+				AddEntrance(
+					c, Vec2iAdd(start, Vec2iScale(along, (runStart + runEnd) / 2)),
+					out);
+			}
+			else
+			{
+				AddEntrance(c, Vec2iAdd(start, Vec2iScale(along, runStart)), out);
+				AddEntrance(c, Vec2iAdd(start, Vec2iScale(along, runEnd)), out);
+			}
+			runStart = -1;
+		}
+	}
+}
+static void BuildCluster(PathGraph *g, const Vec2i cv)
+{
+	PathGraphCluster *c = GetCluster(g, cv.y * g->size.x + cv.x);
+	CArrayClear(&c->Nodes);
+	const Vec2i bottomRight = Vec2iNew(
+		c->Pos.x + c->Size.x - 1, c->Pos.y + c->Size.y - 1);
+	if (cv.y > 0)
+	{
+		AddEntrances(
+			g, c, c->Pos, Vec2iNew(1, 0), Vec2iNew(0, -1), c->Size.x);
+	}
+	if (cv.y < g->size.y - 1)
+	{
+		AddEntrances(
+			g, c, Vec2iNew(c->Pos.x, bottomRight.y),
+			Vec2iNew(1, 0), Vec2iNew(0, 1), c->Size.x);
+	}
+	if (cv.x > 0)
+	{
+		AddEntrances(
+			g, c, c->Pos, Vec2iNew(0, 1), Vec2iNew(-1, 0), c->Size.y);
+	}
+	if (cv.x < g->size.x - 1)
+	{
+		AddEntrances(
+			g, c, Vec2iNew(bottomRight.x, c->Pos.y),
+			Vec2iNew(0, 1), Vec2iNew(1, 0), c->Size.y);
+	}
+
+	// Distances between each pair of entrances
+	const int count = (int)c->Nodes.size;
+	CArrayResize(&c->Dist, count * count, NULL);
+	int *nodeDist = c->Dist.data;
+	int dist[CLUSTER_TILES];
+	for (int i = 0; i < count; i++)
+	{
+		const PathGraphNode *n = CArrayGet(&c->Nodes, i);
+		ClusterDijkstra(g, c, n->Tile, dist);
+		for (int j = 0; j < count; j++)
+		{
+			const PathGraphNode *m = CArrayGet(&c->Nodes, j);
+			nodeDist[i * count + j] = dist[TileIndex(c, m->Tile)];
+		}
+	}
+}
+static void Build(PathGraph *g)
+{
+	const Vec2i mapSize = g->map->Size;
+	const bool walkable = false;
+	CArrayResize(&g->walkable, mapSize.x * mapSize.y, &walkable);
+	bool *w = g->walkable.data;
+	Vec2i v;
+	for (v.y = 0; v.y < mapSize.y; v.y++)
+	{
+		for (v.x = 0; v.x < mapSize.x; v.x++)
+		{
+			w[v.y * mapSize.x + v.x] = IsTileWalkable(g->map, v);
+		}
+	}
+
+	g->size = Vec2iNew(
+		(mapSize.x + PATH_GRAPH_CLUSTER_SIZE - 1) / PATH_GRAPH_CLUSTER_SIZE,
+		(mapSize.y + PATH_GRAPH_CLUSTER_SIZE - 1) / PATH_GRAPH_CLUSTER_SIZE);
+	for (v.y = 0; v.y < g->size.y; v.y++)
+	{
+		for (v.x = 0; v.x < g->size.x; v.x++)
+		{
+			PathGraphCluster c;
+			c.Pos = Vec2iScale(v, PATH_GRAPH_CLUSTER_SIZE);
+			c.Size = Vec2iNew(
+				MIN(PATH_GRAPH_CLUSTER_SIZE, mapSize.x - c.Pos.x),
+				MIN(PATH_GRAPH_CLUSTER_SIZE, mapSize.y - c.Pos.y));
+			CArrayInit(&c.Nodes, sizeof(PathGraphNode));
+			CArrayInit(&c.Dist, sizeof(int));
+			CArrayPushBack(&g->clusters, &c);
+		}
+	}
+	for (v.y = 0; v.y < g->size.y; v.y++)
+	{
+		for (v.x = 0; v.x < g->size.x; v.x++)
+		{
+			BuildCluster(g, v);
+		}
+	}
+	g->isBuilt = true;
+}
+
+void PathGraphUpdateTile(PathGraph *g, const Vec2i tile)
+{
+	if (!g->isBuilt || !MapIsTileIn(g->map, tile))
+	{
+		return;
+	}
+	bool *walkable = CArrayGet(&g->walkable, tile.y * g->map->Size.x + tile.x);
+	const bool isWalkable = IsTileWalkable(g->map, tile);
+	if (*walkable == isWalkable)
+	{
+		return;
+	}
+	*walkable = isWalkable;
+	// Rebuild the tile's cluster, and the neighbours whose shared edge
+	// the tile is on
+	const Vec2i cv = Vec2iScaleDiv(tile, PATH_GRAPH_CLUSTER_SIZE);
+	const PathGraphCluster *c = GetCluster(g, ClusterIndexOf(g, tile));
+	BuildCluster(g, cv);
+	if (tile.x == c->Pos.x && cv.x > 0)
+	{
+		BuildCluster(g, Vec2iNew(cv.x - 1, cv.y));
+	}
+	if (tile.x == c->Pos.x + c->Size.x - 1 && cv.x < g->size.x - 1)
+	{
+		BuildCluster(g, Vec2iNew(cv.x + 1, cv.y));
+	}
+	if (tile.y == c->Pos.y && cv.y > 0)
+	{
+		BuildCluster(g, Vec2iNew(cv.x, cv.y - 1));
+	}
+	if (tile.y == c->Pos.y + c->Size.y - 1 && cv.y < g->size.y - 1)
+	{
+		BuildCluster(g, Vec2iNew(cv.x, cv.y + 1));
+	}
+}
+
+
+typedef struct
+{
+	const PathGraph *Graph;
+	Vec2i From;
+	Vec2i To;
+	int ToCluster;
+	// Distances from the start and goal to the tiles of their clusters
+	int FromDist[CLUSTER_TILES];
+	int ToDist[CLUSTER_TILES];
+} SearchContext;
+static Vec2i KeyTile(const SearchContext *s, const PathGraphKey *k)
+{
+	switch (k->Node)
+	{
+	case START_NODE:
+		return s->From;
+	case GOAL_NODE:
+		return s->To;
+	default:
+		{
+			const PathGraphNode *n = CArrayGet(
+				&GetCluster(s->Graph, k->Cluster)->Nodes, k->Node);
+			return n->Tile;
+		}
+	}
+}
+static void AddNeighbor(
+	ASNeighborList neighbors, const int cluster, const int node,
+	const int dist)
+{
+	if (dist == UNREACHABLE)
+	{
+		return;
+	}
+	PathGraphKey k;
+	k.Cluster = cluster;
+	k.Node = node;
+	ASNeighborListAdd(neighbors, &k, dist / 10.0f);
+}
+static void AddNodeNeighbors(
+	ASNeighborList neighbors, void *node, void *context)
+{
+	const PathGraphKey *k = node;
+	const SearchContext *s = context;
+	if (k->Node == GOAL_NODE)
+	{
+		return;
+	}
+	const PathGraphCluster *c = GetCluster(s->Graph, k->Cluster);
+	const int count = (int)c->Nodes.size;
+	const int *nodeDist = c->Dist.data;
+	// Other entrances of this cluster
+	CA_FOREACH(const PathGraphNode, n, c->Nodes)
+		if (i != k->Node)
+		{
+			AddNeighbor(
+				neighbors, k->Cluster, i,
+				k->Node == START_NODE ?
+				s->FromDist[TileIndex(c, n->Tile)] :
+				nodeDist[k->Node * count + i]);
+		}
+	CA_FOREACH_END()
+	// The goal, if it is in this cluster
+	if (k->Cluster == s->ToCluster)
+	{
+		AddNeighbor(
+			neighbors, k->Cluster, GOAL_NODE,
+			s->ToDist[TileIndex(c, KeyTile(s, k))]);
+	}
+	// Through this entrance to the next cluster
+	if (k->Node >= 0)
+	{
+		const PathGraphNode *n = CArrayGet(&c->Nodes, k->Node);
+		const int next = ClusterIndexOf(s->Graph, n->Exit);
+		CA_FOREACH(const PathGraphNode, m, GetCluster(s->Graph, next)->Nodes)
+			if (Vec2iEqual(m->Tile, n->Exit) && Vec2iEqual(m->Exit, n->Tile))
+			{
+				AddNeighbor(
+					neighbors, next, i,
+					StepCost(Vec2iMinus(n->Exit, n->Tile)));
+				break;
+			}
+		CA_FOREACH_END()
+	}
+}
+static float NodeHeuristic(void *fromNode, void *toNode, void *context)
+{
+	const SearchContext *s = context;
+	const Vec2i v1 = KeyTile(s, fromNode);
+	const Vec2i v2 = KeyTile(s, toNode);
+	return (float)sqrt(DistanceSquared(
+		Vec2iCenterOfTile(v1), Vec2iCenterOfTile(v2)));
+}
+static ASPathNodeSource cNodeSource =
+{
+	sizeof(PathGraphKey), AddNodeNeighbors, NodeHeuristic, NULL, NULL
+};
+bool PathGraphFindWaypoints(
+	PathGraph *g, const Vec2i from, const Vec2i to, CArray *waypoints)
+{
+	if (!g->isBuilt)
+	{
+		Build(g);
+	}
+	SearchContext s;
+	s.Graph = g;
+	s.From = from;
+	s.To = to;
+	s.ToCluster = ClusterIndexOf(g, to);
+	PathGraphKey start;
+	start.Cluster = ClusterIndexOf(g, from);
+	start.Node = START_NODE;
+	PathGraphKey goal;
+	goal.Cluster = s.ToCluster;
+	goal.Node = GOAL_NODE;
+	ClusterDijkstra(g, GetCluster(g, start.Cluster), from, s.FromDist);
+	ClusterDijkstra(g, GetCluster(g, goal.Cluster), to, s.ToDist);
+
+	ASPath path = ASPathCreate(&cNodeSource, &s, &start, &goal);
+	if (path == NULL)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < ASPathGetCount(path); i++)
+	{
+		const Vec2i v = KeyTile(&s, ASPathGetNode(path, i));
+		// Entrances at corners share tiles
+		if (waypoints->size == 0 || !Vec2iEqual(
+			v, *(const Vec2i *)CArrayGet(waypoints, (int)waypoints->size - 1)))
+		{
+			CArrayPushBack(waypoints, &v);
+		}
+	}
+	ASPathDestroy(path);
+	return true;
+}
@@ -0,0 +1,76 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+#define PATH_GRAPH_CLUSTER_SIZE 10
+
+// Entrance to a cluster, from a walkable tile on its edge to the walkable
+// tile on the other side
+typedef struct
+{
+	Vec2i Tile;
+	Vec2i Exit;
+} PathGraphNode;
+
+typedef struct
+{
+	Vec2i Pos;	// top-left tile
+	Vec2i Size;
+	CArray Nodes;	// of PathGraphNode
+	CArray Dist;	// of int, between each pair of nodes, within the cluster
+} PathGraphCluster;
+
+// Abstract graph of the map for finding long paths (HPA*)
+// The map is split into square clusters, joined by entrances along their
+// edges; paths are first found between entrances, then between tiles
+// Walkability is the same as pathfinding ignoring objects
+// Note: built on first use, lifetime managed by PathCache
+typedef struct
+{
+	CArray clusters;	// of PathGraphCluster
+	Vec2i size;	// in clusters
+	CArray walkable;	// of bool, per tile
+	bool isBuilt;
+	Map *map;
+} PathGraph;
+
+void PathGraphInit(PathGraph *g, Map *m);
+void PathGraphTerminate(PathGraph *g);
+
+// Update the clusters around a tile whose walkability may have changed
+void PathGraphUpdateTile(PathGraph *g, const Vec2i tile);
+
+// Find the tiles to go through to get from one tile to another:
+// the start, the cluster entrances along the way, and the goal
+// Returns false if there is no path
+bool PathGraphFindWaypoints(
+	PathGraph *g, const Vec2i from, const Vec2i to, CArray *waypoints);
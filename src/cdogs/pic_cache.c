@@ -0,0 +1,561 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "pic_cache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "log.h"
+#include "sys_config.h"
+#include "utils.h"
+
+#define PIC_CACHE_MAGIC "CDPC"
+#define PIC_CACHE_VERSION 1
+
+// Cache file layout, in native byte order since the cache is only ever
+// read back on the same machine:
+// - header
+// - file records, one per image file, in the order they were found
+// - pic records; each file has a contiguous range of them
+// - NUL-terminated strings
+// - pixels of each pic, 4-byte aligned
+// Offsets are from the start of the file.
+typedef struct
+{
+	char magic[4];
+	uint32_t version;
+	// Pixel format the pics were converted to
+	uint32_t rMask;
+	uint32_t gMask;
+	uint32_t bMask;
+	uint32_t aShift;
+	uint32_t numFiles;
+	uint32_t numPics;
+} PicCacheHeader;
+typedef enum
+{
+	PIC_CACHE_NONE,	// not an image, or failed to load
+	PIC_CACHE_PIC,
+	PIC_CACHE_SPRITES
+} PicCacheType;
+typedef struct
+{
+	uint32_t path;
+	uint32_t name;
+	uint32_t type;
+	uint32_t firstPic;
+	uint32_t numPics;
+	uint32_t pad;
+	uint64_t size;
+	int64_t mtime;
+	uint64_t hash;
+} PicCacheFile;
+typedef struct
+{
+	int32_t w;
+	int32_t h;
+	int32_t offsetX;
+	int32_t offsetY;
+	uint32_t data;
+} PicCachePic;
+
+
+static int PicFileNumPics(const PicFile *pf)
+{
+	if (!pf->isLoaded)
+	{
+		return 0;
+	}
+	return pf->pics.isSpritesheet ? (int)pf->pics.sprites.pics.size : 1;
+}
+static Pic *PicFileGetPic(PicFile *pf, const int idx)
+{
+	if (pf->pics.isSpritesheet)
+	{
+		return CArrayGet(&pf->pics.sprites.pics, idx);
+	}
+	return &pf->pics.pic.pic;
+}
+static const char *PicFileGetName(const PicFile *pf)
+{
+	if (!pf->isLoaded)
+	{
+		return pf->name;
+	}
+	return pf->pics.isSpritesheet ? pf->pics.sprites.name : pf->pics.pic.name;
+}
+static size_t PicDataSize(const int w, const int h)
+{
+	return (size_t)w * h * sizeof(Uint32);
+}
+
+static bool GetFileStamp(uint64_t *size, int64_t *mtime, const char *path)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return false;
+	}
+	*size = (uint64_t)st.st_size;
+	*mtime = (int64_t)st.st_mtime;
+	return true;
+}
+// 64-bit FNV-1a hash of the file contents
+static bool HashFile(uint64_t *hash, const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+	{
+		return false;
+	}
+	*hash = 14695981039346656037ULL;
+	unsigned char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof buf, f)) > 0)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			*hash = (*hash ^ buf[i]) * 1099511628211ULL;
+		}
+	}
+	const bool ok = !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+static bool MapFile(PicCache *c, const char *path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(
+		path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	// Copy-on-write, so that pics can be modified without touching the file
+	c->mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (c->mapping == NULL)
+	{
+		return false;
+	}
+	c->data = MapViewOfFile(c->mapping, FILE_MAP_COPY, 0, 0, 0);
+	if (c->data == NULL)
+	{
+		CloseHandle(c->mapping);
+		c->mapping = NULL;
+		return false;
+	}
+	c->size = (size_t)size.QuadPart;
+#else
+	const int fd = open(path, O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	// Private mapping, so that pics can be modified without touching the file
+	void *data = mmap(
+		NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+	c->data = data;
+	c->size = (size_t)st.st_size;
+#endif
+	return true;
+}
+void PicCacheTerminate(PicCache *c)
+{
+	if (c->data == NULL)
+	{
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(c->data);
+	CloseHandle(c->mapping);
+#else
+	munmap(c->data, c->size);
+#endif
+	memset(c, 0, sizeof *c);
+}
+
+bool PicCacheOwns(const PicCache *c, const void *data)
+{
+	const char *p = data;
+	const char *start = c->data;
+	return start != NULL && p >= start && p < start + c->size;
+}
+
+// The cache file may be truncated or corrupt, so check that everything
+// is within bounds before it is used
+static const char *GetString(const PicCache *c, const uint32_t offset)
+{
+	const char *s = (const char *)c->data + offset;
+	if (offset >= c->size || memchr(s, '\0', c->size - offset) == NULL)
+	{
+		return NULL;
+	}
+	return s;
+}
+static bool IsHeaderValid(
+	const PicCache *c, const SDL_PixelFormat *f, const Uint8 aShift)
+{
+	const PicCacheHeader *h = c->data;
+	return
+		c->size >= sizeof *h &&
+		memcmp(h->magic, PIC_CACHE_MAGIC, sizeof h->magic) == 0 &&
+		h->version == PIC_CACHE_VERSION &&
+		h->rMask == f->Rmask && h->gMask == f->Gmask &&
+		h->bMask == f->Bmask && h->aShift == aShift &&
+		sizeof *h +
+		(uint64_t)h->numFiles * sizeof(PicCacheFile) +
+		(uint64_t)h->numPics * sizeof(PicCachePic) <= c->size;
+}
+static bool IsRecordValid(
+	const PicCache *c, const PicCacheFile *r, const PicCachePic *pics)
+{
+	const PicCacheHeader *h = c->data;
+	if (GetString(c, r->name) == NULL ||
+		r->type > PIC_CACHE_SPRITES ||
+		(uint64_t)r->firstPic + r->numPics > h->numPics ||
+		(r->type == PIC_CACHE_PIC && r->numPics != 1))
+	{
+		return false;
+	}
+	for (uint32_t i = 0; i < r->numPics; i++)
+	{
+		const PicCachePic *p = &pics[r->firstPic + i];
+		if (p->w <= 0 || p->h <= 0 || p->data % sizeof(Uint32) != 0 ||
+			p->data + (uint64_t)PicDataSize(p->w, p->h) > c->size)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+// Files are usually found in the same order as last time
+static const PicCacheFile *FindRecord(
+	const PicCache *c, const PicCacheFile *records, const char *path,
+	const int idx)
+{
+	const PicCacheHeader *h = c->data;
+	if (idx < (int)h->numFiles)
+	{
+		const char *p = GetString(c, records[idx].path);
+		if (p != NULL && strcmp(p, path) == 0)
+		{
+			return &records[idx];
+		}
+	}
+	for (uint32_t i = 0; i < h->numFiles; i++)
+	{
+		const char *p = GetString(c, records[i].path);
+		if (p != NULL && strcmp(p, path) == 0)
+		{
+			return &records[i];
+		}
+	}
+	return NULL;
+}
+// Whether the file has the same contents as when it was cached
+// If its modification time has changed but not its contents, the record
+// is stale and the cache should be saved again
+static bool IsFileUnchanged(
+	const PicCacheFile *r, const char *path, bool *isStale)
+{
+	*isStale = false;
+	uint64_t size;
+	int64_t mtime;
+	if (!GetFileStamp(&size, &mtime, path) || size != r->size)
+	{
+		return false;
+	}
+	if (mtime == r->mtime)
+	{
+		return true;
+	}
+	uint64_t hash;
+	if (!HashFile(&hash, path) || hash != r->hash)
+	{
+		return false;
+	}
+	*isStale = true;
+	return true;
+}
+static void LoadPic(const PicCache *c, Pic *p, const PicCachePic *cp)
+{
+	p->size = Vec2iNew(cp->w, cp->h);
+	p->offset = Vec2iNew(cp->offsetX, cp->offsetY);
+	p->Data = (Uint32 *)((char *)c->data + cp->data);
+}
+static void LoadRecord(
+	const PicCache *c, PicFile *pf, const PicCacheFile *r,
+	const PicCachePic *pics)
+{
+	LoadedPics *l = &pf->pics;
+	const char *name = GetString(c, r->name);
+	switch (r->type)
+	{
+	case PIC_CACHE_PIC:
+		l->isSpritesheet = false;
+		CSTRDUP(l->pic.name, name);
+		LoadPic(c, &l->pic.pic, &pics[r->firstPic]);
+		break;
+	case PIC_CACHE_SPRITES:
+		l->isSpritesheet = true;
+		CSTRDUP(l->sprites.name, name);
+		CArrayInit(&l->sprites.pics, sizeof(Pic));
+		for (uint32_t i = 0; i < r->numPics; i++)
+		{
+			Pic p;
+			LoadPic(c, &p, &pics[r->firstPic + i]);
+			CArrayPushBack(&l->sprites.pics, &p);
+		}
+		break;
+	default:
+		break;
+	}
+	pf->isLoaded = r->type != PIC_CACHE_NONE;
+}
+// Copy the pics loaded from the cache, so that it can be closed
+static void CopyPics(const PicCache *c, CArray *files)
+{
+	CA_FOREACH(PicFile, pf, *files)
+		for (int j = 0; j < PicFileNumPics(pf); j++)
+		{
+			Pic *p = PicFileGetPic(pf, j);
+			if (!PicCacheOwns(c, p->Data))
+			{
+				continue;
+			}
+			const size_t size = PicDataSize(p->size.x, p->size.y);
+			Uint32 *data;
+			CMALLOC(data, size);
+			memcpy(data, p->Data, size);
+			p->Data = data;
+		}
+	CA_FOREACH_END()
+}
+bool PicCacheLoad(
+	PicCache *c, const char *path, CArray *files,
+	const SDL_PixelFormat *f, const Uint8 aShift)
+{
+	CASSERT(c->data == NULL, "pic cache already loaded");
+	if (!MapFile(c, path))
+	{
+		LOG(LM_MAIN, LL_DEBUG, "no pic cache(%s)", path);
+		return false;
+	}
+	if (!IsHeaderValid(c, f, aShift))
+	{
+		LOG(LM_MAIN, LL_INFO, "pic cache(%s) is out of date", path);
+		PicCacheTerminate(c);
+		return false;
+	}
+	const PicCacheHeader *h = c->data;
+	const PicCacheFile *records = (const PicCacheFile *)(h + 1);
+	const PicCachePic *pics = (const PicCachePic *)(records + h->numFiles);
+	bool isComplete = files->size == h->numFiles;
+	int numLoaded = 0;
+	CA_FOREACH(PicFile, pf, *files)
+		const PicCacheFile *r = FindRecord(c, records, pf->path, i);
+		bool isStale;
+		if (r == NULL || !IsRecordValid(c, r, pics) ||
+			!IsFileUnchanged(r, pf->path, &isStale))
+		{
+			isComplete = false;
+			continue;
+		}
+		if (isStale)
+		{
+			isComplete = false;
+		}
+		LoadRecord(c, pf, r, pics);
+		numLoaded++;
+	CA_FOREACH_END()
+	LOG(LM_MAIN, LL_DEBUG, "loaded %d of %d pic files from cache(%s)",
+		numLoaded, (int)files->size, path);
+	if (!isComplete)
+	{
+		CopyPics(c, files);
+		PicCacheTerminate(c);
+	}
+	return isComplete;
+}
+
+void PicCacheSave(
+	const char *path, const CArray *files,
+	const SDL_PixelFormat *f, const Uint8 aShift)
+{
+	CArray records;
+	CArrayInit(&records, sizeof(PicCacheFile));
+	CArray pics;
+	CArrayInit(&pics, sizeof(PicCachePic));
+	FILE *file = NULL;
+	char tmpPath[CDOGS_PATH_MAX];
+	sprintf(tmpPath, "%s.tmp", path);
+
+	// Lay out the records first, as they hold the offsets of the strings
+	// and pixels that follow
+	PicCacheHeader h;
+	memset(&h, 0, sizeof h);
+	memcpy(h.magic, PIC_CACHE_MAGIC, sizeof h.magic);
+	h.version = PIC_CACHE_VERSION;
+	h.rMask = f->Rmask;
+	h.gMask = f->Gmask;
+	h.bMask = f->Bmask;
+	h.aShift = aShift;
+	h.numFiles = (uint32_t)files->size;
+	CA_FOREACH(PicFile, pf, *files)
+		h.numPics += PicFileNumPics(pf);
+	CA_FOREACH_END()
+	uint32_t firstPic = 0;
+	uint64_t offset = sizeof h +
+		(uint64_t)h.numFiles * sizeof(PicCacheFile) +
+		(uint64_t)h.numPics * sizeof(PicCachePic);
+	CA_FOREACH(PicFile, pf, *files)
+		PicCacheFile r;
+		memset(&r, 0, sizeof r);
+		if (!pf->isLoaded)
+		{
+			r.type = PIC_CACHE_NONE;
+		}
+		else
+		{
+			r.type = pf->pics.isSpritesheet ?
+				PIC_CACHE_SPRITES : PIC_CACHE_PIC;
+		}
+		r.firstPic = firstPic;
+		r.numPics = (uint32_t)PicFileNumPics(pf);
+		firstPic += r.numPics;
+		// Stamp the file; if this fails the record won't match next time
+		GetFileStamp(&r.size, &r.mtime, pf->path);
+		HashFile(&r.hash, pf->path);
+		r.path = (uint32_t)offset;
+		offset += strlen(pf->path) + 1;
+		r.name = (uint32_t)offset;
+		offset += strlen(PicFileGetName(pf)) + 1;
+		CArrayPushBack(&records, &r);
+	CA_FOREACH_END()
+	offset = (offset + sizeof(Uint32) - 1) / sizeof(Uint32) * sizeof(Uint32);
+	CA_FOREACH(PicFile, pf, *files)
+		for (int j = 0; j < PicFileNumPics(pf); j++)
+		{
+			const Pic *p = PicFileGetPic(pf, j);
+			PicCachePic cp;
+			cp.w = p->size.x;
+			cp.h = p->size.y;
+			cp.offsetX = p->offset.x;
+			cp.offsetY = p->offset.y;
+			cp.data = (uint32_t)offset;
+			offset += PicDataSize(p->size.x, p->size.y);
+			CArrayPushBack(&pics, &cp);
+		}
+	CA_FOREACH_END()
+	if (offset > UINT32_MAX)
+	{
+		LOG(LM_MAIN, LL_WARN, "too many pics to cache");
+		goto bail;
+	}
+
+	file = fopen(tmpPath, "wb");
+	if (file == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot write pic cache(%s)", tmpPath);
+		goto bail;
+	}
+	fwrite(&h, sizeof h, 1, file);
+	if (records.size > 0)
+	{
+		fwrite(records.data, records.elemSize, records.size, file);
+	}
+	if (pics.size > 0)
+	{
+		fwrite(pics.data, pics.elemSize, pics.size, file);
+	}
+	CA_FOREACH(PicFile, pf, *files)
+		fwrite(pf->path, strlen(pf->path) + 1, 1, file);
+		const char *name = PicFileGetName(pf);
+		fwrite(name, strlen(name) + 1, 1, file);
+	CA_FOREACH_END()
+	const Uint32 zero = 0;
+	const long pad = -ftell(file) & (long)(sizeof(Uint32) - 1);
+	fwrite(&zero, (size_t)pad, 1, file);
+	CA_FOREACH(PicFile, pf, *files)
+		for (int j = 0; j < PicFileNumPics(pf); j++)
+		{
+			const Pic *p = PicFileGetPic(pf, j);
+			fwrite(p->Data, PicDataSize(p->size.x, p->size.y), 1, file);
+		}
+	CA_FOREACH_END()
+	const bool ok = !ferror(file);
+	fclose(file);
+	file = NULL;
+	// Replace the old cache only once the new one is complete
+	remove(path);
+	if (!ok || rename(tmpPath, path) != 0)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot write pic cache(%s)", path);
+		remove(tmpPath);
+		goto bail;
+	}
+	LOG(LM_MAIN, LL_DEBUG, "saved %d pics to cache(%s)", (int)h.numPics, path);
+
+bail:
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+	CArrayTerminate(&records);
+	CArrayTerminate(&pics);
+}
@@ -0,0 +1,86 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <SDL_video.h>
+
+#include "c_array.h"
+#include "pic.h"
+
+#define PIC_CACHE_FILE "pics.cache"
+
+// Pics converted from an image, before they are added
+typedef struct
+{
+	bool isSpritesheet;
+	NamedPic pic;
+	NamedSprites sprites;
+} LoadedPics;
+// An image file and the pics converted from it
+typedef struct
+{
+	char *path;
+	char *name;
+	bool isLoaded;
+	LoadedPics pics;
+} PicFile;
+
+// Cache of the pics converted from a directory of images, so that later
+// starts don't need to decode the images again.
+// The cache file holds the final pixels in the screen format, and is
+// memory-mapped so that the cached pics point straight into it; each image
+// file is stamped with its size, modification time and a hash of its
+// contents, and pics are only taken from the cache if their file is
+// unchanged.
+typedef struct
+{
+	void *data;
+	size_t size;
+#ifdef _WIN32
+	void *mapping;
+#endif
+} PicCache;
+
+// Map the cache file and load the pics of the unchanged files from it
+// Returns whether all the files were loaded from the cache; if not, the
+// cache is closed, with the pics loaded from it copied out, so that it can
+// be saved again once the rest of the files are loaded.
+bool PicCacheLoad(
+	PicCache *c, const char *path, CArray *files,
+	const SDL_PixelFormat *f, const Uint8 aShift);
+// Save the pics loaded from the files; the cache file must not be mapped
+void PicCacheSave(
+	const char *path, const CArray *files,
+	const SDL_PixelFormat *f, const Uint8 aShift);
+void PicCacheTerminate(PicCache *c);
+
+// Whether pic data points into the mapped cache, and so mustn't be freed
+bool PicCacheOwns(const PicCache *c, const void *data);
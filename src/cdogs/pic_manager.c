@@ -27,12 +27,15 @@
 */
 #include "pic_manager.h"
 
+#include <errno.h>
+
 #include <SDL_image.h>
 
 #include <tinydir/tinydir.h>
 
 #include "files.h"
 #include "log.h"
+#include "thread_pool.h"
 
 PicManager gPicManager;
 
@@ -58,6 +61,13 @@ bool PicManagerTryInit(
 	CArrayInit(&pm->sprites, sizeof(NamedSprites));
 	CArrayInit(&pm->customPics, sizeof(NamedPic));
 	CArrayInit(&pm->customSprites, sizeof(NamedSprites));
+	NAME_MAP_INIT(&pm->picsByName, &pm->pics, NamedPic, name, true);
+	NAME_MAP_INIT(&pm->spritesByName, &pm->sprites, NamedSprites, name, true);
+	NAME_MAP_INIT(
+		&pm->customPicsByName, &pm->customPics, NamedPic, name, true);
+	NAME_MAP_INIT(
+		&pm->customSpritesByName, &pm->customSprites, NamedSprites, name,
+		true);
 	CArrayInit(&pm->drainPics, sizeof(NamedPic *));
 	CArrayInit(&pm->doorStyleNames, sizeof(char *));
 
@@ -108,16 +118,16 @@ static void SetPaletteRange(
 	}
 }
 
-static void AfterAdd(PicManager *pm);
-void PicManagerAdd(
-	CArray *pics, CArray *sprites, const char *name, SDL_Surface *image)
+// Convert an image into pics, freeing the image
+// Doesn't touch the pic manager, so it is safe to call from worker threads
+static bool LoadPics(LoadedPics *l, const char *name, SDL_Surface *image)
 {
 	if (image->format->BytesPerPixel != 4)
 	{
 		perror("Cannot load non-32-bit image");
 		fprintf(stderr, "Only 32-bit depth images supported (%s)\n", name);
 		SDL_FreeSurface(image);
-		return;
+		return false;
 	}
 	char buf[CDOGS_FILENAME_MAX];
 	const char *dot = strrchr(name, '.');
@@ -136,7 +146,7 @@ void PicManagerAdd(
 	// this is a spritesheet where each sprite is W wide by H high
 	// Load multiple images from this single sheet
 	Vec2i size = Vec2iNew(image->w, image->h);
-	bool isSpritesheet = false;
+	l->isSpritesheet = false;
 	char *underscore = strrchr(buf, '_');
 	const char *x = strrchr(buf, 'x');
 	if (underscore != NULL && x != NULL &&
@@ -149,21 +159,16 @@ void PicManagerAdd(
 		else
 		{
 			*underscore = '\0';
-			isSpritesheet = true;
+			l->isSpritesheet = true;
 		}
 	}
-	NamedSprites *nsp = NULL;
-	NamedPic *np = NULL;
-	if (isSpritesheet)
+	if (l->isSpritesheet)
 	{
-		NamedSprites ns;
-		NamedSpritesInit(&ns, buf);
-		CArrayPushBack(sprites, &ns);
-		nsp = CArrayGet(sprites, sprites->size - 1);
+		NamedSpritesInit(&l->sprites, buf);
 	}
 	else
 	{
-		np = AddNamedPic(pics, buf, NULL);
+		CSTRDUP(l->pic.name, buf);
 	}
 	SDL_LockSurface(image);
 	Vec2i offset;
@@ -172,32 +177,59 @@ void PicManagerAdd(
 		for (offset.x = 0; offset.x < image->w; offset.x += size.x)
 		{
 			Pic *pic;
-			if (isSpritesheet)
+			if (l->isSpritesheet)
 			{
 				Pic p;
-				CArrayPushBack(&nsp->pics, &p);
-				pic = CArrayGet(&nsp->pics, nsp->pics.size - 1);
+				CArrayPushBack(&l->sprites.pics, &p);
+				pic = CArrayGet(&l->sprites.pics, l->sprites.pics.size - 1);
 			}
 			else
 			{
-				pic = &np->pic;
+				pic = &l->pic.pic;
 			}
 			PicLoad(pic, size, offset, image);
 		}
 	}
 	SDL_UnlockSurface(image);
 	SDL_FreeSurface(image);
+	return true;
+}
+static void AddLoadedPics(
+	CArray *pics, CArray *sprites, const LoadedPics *l)
+{
+	if (l->isSpritesheet)
+	{
+		CArrayPushBack(sprites, &l->sprites);
+	}
+	else
+	{
+		CArrayPushBack(pics, &l->pic);
+	}
+}
+static void AfterAdd(PicManager *pm);
+void PicManagerAdd(
+	CArray *pics, CArray *sprites, const char *name, SDL_Surface *image)
+{
+	LoadedPics l;
+	if (!LoadPics(&l, name, image))
+	{
+		return;
+	}
+	AddLoadedPics(pics, sprites, &l);
 
 	AfterAdd(&gPicManager);
 }
 
-static void PicManagerLoadDirImpl(
-	PicManager *pm, const char *path, const char *prefix)
+// Image files are found first, then decoded and converted on a thread
+// pool, then added in the order they were found so the names and pic
+// order don't depend on the threads
+static void FindPicFiles(
+	CArray *files, const char *path, const char *prefix, const bool recurse)
 {
 	tinydir_dir dir;
 	if (tinydir_open(&dir, path) == -1)
 	{
-		perror("Cannot open image dir");
+		LOG(LM_MAIN, LL_DEBUG, "no pic dir(%s): %s", path, strerror(errno));
 		goto bail;
 	}
 
@@ -211,45 +243,34 @@ static void PicManagerLoadDirImpl(
 		}
 		if (file.is_reg)
 		{
-			SDL_RWops *rwops = SDL_RWFromFile(file.path, "rb");
-			const bool isPng = IMG_isPNG(rwops);
-			if (isPng)
+			PicFile f;
+			memset(&f, 0, sizeof f);
+			CSTRDUP(f.path, file.path);
+			char buf[CDOGS_PATH_MAX];
+			if (prefix)
 			{
-				SDL_Surface *data = IMG_Load_RW(rwops, 0);
-				if (!data)
-				{
-					LOG(LM_MAIN, LL_ERROR, "Cannot load image");
-					LOG(LM_MAIN, LL_ERROR, "IMG_Load: %s", IMG_GetError());
-				}
-				else
-				{
-					char buf[CDOGS_PATH_MAX];
-					if (prefix)
-					{
-						char buf1[CDOGS_PATH_MAX];
-						sprintf(buf1, "%s/%s", prefix, file.name);
-						PathGetWithoutExtension(buf, buf1);
-					}
-					else
-					{
-						PathGetBasenameWithoutExtension(buf, file.name);
-					}
-					PicManagerAdd(&pm->pics, &pm->sprites, buf, data);
-				}
+				char buf1[CDOGS_PATH_MAX];
+				sprintf(buf1, "%s/%s", prefix, file.name);
+				PathGetWithoutExtension(buf, buf1);
 			}
-			rwops->close(rwops);
+			else
+			{
+				PathGetBasenameWithoutExtension(buf, file.name);
+			}
+			CSTRDUP(f.name, buf);
+			CArrayPushBack(files, &f);
 		}
-		else if (file.is_dir && file.name[0] != '.')
+		else if (recurse && file.is_dir && file.name[0] != '.')
 		{
 			if (prefix)
 			{
 				char buf[CDOGS_PATH_MAX];
 				sprintf(buf, "%s/%s", prefix, file.name);
-				PicManagerLoadDirImpl(pm, file.path, buf);
+				FindPicFiles(files, file.path, buf, recurse);
 			}
 			else
 			{
-				PicManagerLoadDirImpl(pm, file.path, file.name);
+				FindPicFiles(files, file.path, file.name, recurse);
 			}
 		}
 	}
@@ -257,17 +278,126 @@ static void PicManagerLoadDirImpl(
 bail:
 	tinydir_close(&dir);
 }
+static void LoadPicFile(PicFile *f)
+{
+	SDL_RWops *rwops = SDL_RWFromFile(f->path, "rb");
+	if (rwops == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Cannot open image %s", f->path);
+		return;
+	}
+	if (IMG_isPNG(rwops))
+	{
+		SDL_Surface *data = IMG_Load_RW(rwops, 0);
+		if (!data)
+		{
+			LOG(LM_MAIN, LL_ERROR, "Cannot load image");
+			LOG(LM_MAIN, LL_ERROR, "IMG_Load: %s", IMG_GetError());
+		}
+		else
+		{
+			f->isLoaded = LoadPics(&f->pics, f->name, data);
+		}
+	}
+	rwops->close(rwops);
+}
+typedef struct
+{
+	CArray *files;	// of PicFile
+	SDL_mutex *mutex;
+	int next;
+} PicFileQueue;
+// Each thread takes files from the queue until it is empty, since the
+// files vary a lot in size
+static void LoadPicFiles(void *data, const int begin, const int end)
+{
+	PicFileQueue *q = data;
+	UNUSED(begin);
+	UNUSED(end);
+	for (;;)
+	{
+		SDL_LockMutex(q->mutex);
+		const int i = q->next++;
+		SDL_UnlockMutex(q->mutex);
+		if (i >= (int)q->files->size)
+		{
+			break;
+		}
+		PicFile *f = CArrayGet(q->files, i);
+		// Skip files already loaded from the cache
+		if (!f->isLoaded)
+		{
+			LoadPicFile(f);
+		}
+	}
+}
+static void DecodePicFiles(CArray *files)
+{
+	ThreadPool pool;
+	ThreadPoolInit(&pool, MIN(ThreadPoolNumCPUs(), (int)files->size));
+	PicFileQueue q;
+	q.files = files;
+	q.mutex = SDL_CreateMutex();
+	q.next = 0;
+	ThreadPoolRun(&pool, LoadPicFiles, &q, ThreadPoolNumThreads(&pool));
+	SDL_DestroyMutex(q.mutex);
+	ThreadPoolTerminate(&pool);
+}
+// Add the loaded pics and free the files
+static void AddPicFiles(
+	PicManager *pm, CArray *pics, CArray *sprites, CArray *files)
+{
+	PicManagerBeginBatch(pm);
+	CA_FOREACH(PicFile, f, *files)
+		if (f->isLoaded)
+		{
+			AddLoadedPics(pics, sprites, &f->pics);
+			AfterAdd(pm);
+		}
+		CFREE(f->path);
+		CFREE(f->name);
+	CA_FOREACH_END()
+	PicManagerEndBatch(pm);
+	CArrayTerminate(files);
+}
+void PicManagerLoadFiles(
+	PicManager *pm, CArray *pics, CArray *sprites, const char *path,
+	const bool recurse)
+{
+	CArray files;
+	CArrayInit(&files, sizeof(PicFile));
+	FindPicFiles(&files, path, NULL, recurse);
+	DecodePicFiles(&files);
+	AddPicFiles(pm, pics, sprites, &files);
+}
 static void GenerateOldPics(PicManager *pm);
 static void LoadOldSprites(
 	PicManager *pm, const char *name, const TOffsetPic *pics, const int count);
-void PicManagerLoadDir(PicManager *pm, const char *path)
+void PicManagerLoadDir(
+	PicManager *pm, const char *path, const char *cachePath)
 {
 	if (!IMG_Init(IMG_INIT_PNG))
 	{
 		perror("Cannot initialise SDL_Image");
 		return;
 	}
-	PicManagerLoadDirImpl(pm, path, NULL);
+	CArray files;
+	CArrayInit(&files, sizeof(PicFile));
+	FindPicFiles(&files, path, NULL, true);
+	// The pics are converted to the screen format, so that's part of the key
+	const SDL_PixelFormat *f = gGraphicsDevice.screen->format;
+	const Uint8 aShift = gGraphicsDevice.Ashift;
+	if (cachePath == NULL ||
+		!PicCacheLoad(&pm->cache, cachePath, &files, f, aShift))
+	{
+		DecodePicFiles(&files);
+		if (cachePath != NULL)
+		{
+			PicCacheSave(cachePath, &files, f, aShift);
+		}
+	}
+	PicManagerBeginBatch(pm);
+	AddPicFiles(pm, &pm->pics, &pm->sprites, &files);
 	GenerateOldPics(pm);
 
 	// Load old pics and sprites
@@ -280,6 +410,7 @@ void PicManagerLoadDir(PicManager *pm, const char *path)
 	LoadOldSprites(pm, "gas_cloud", cFireBallPics + 8, 4);
 	LoadOldSprites(pm, "beam", cBeamPics[0], DIRECTION_COUNT);
 	LoadOldSprites(pm, "beam_bright", cBeamPics[1], DIRECTION_COUNT);
+	PicManagerEndBatch(pm);
 }
 static void LoadOldSprites(
 	PicManager *pm, const char *name, const TOffsetPic *pics, const int count)
@@ -378,9 +509,28 @@ static void FindDrainPics(PicManager *pm);
 static void FindDoorPics(PicManager *pm);
 static void AfterAdd(PicManager *pm)
 {
+	if (pm->batchDepth > 0)
+	{
+		pm->isBatchAdded = true;
+		return;
+	}
 	FindDrainPics(pm);
 	FindDoorPics(pm);
 }
+void PicManagerBeginBatch(PicManager *pm)
+{
+	pm->batchDepth++;
+}
+void PicManagerEndBatch(PicManager *pm)
+{
+	CASSERT(pm->batchDepth > 0, "unbalanced pic manager batch");
+	pm->batchDepth--;
+	if (pm->batchDepth == 0 && pm->isBatchAdded)
+	{
+		pm->isBatchAdded = false;
+		AfterAdd(pm);
+	}
+}
 static void FindDrainPics(PicManager *pm)
 {
 	// Scan all pics for drainage pics
@@ -440,6 +590,8 @@ static void PicManagerClear(CArray *pics, CArray *sprites);
 void PicManagerClearCustom(PicManager *pm)
 {
 	PicManagerClear(&pm->customPics, &pm->customSprites);
+	NameMapClear(&pm->customPicsByName);
+	NameMapClear(&pm->customSpritesByName);
 	FindDrainPics(pm);
 }
 void PicManagerTerminate(PicManager *pm)
@@ -455,12 +607,34 @@ void PicManagerTerminate(PicManager *pm)
 			PicFree(&pm->picsFromOld[i]);
 		}
 	}
+	// Pics loaded from the cache are freed along with it
+	CA_FOREACH(NamedPic, n, pm->pics)
+		if (PicCacheOwns(&pm->cache, n->pic.Data))
+		{
+			n->pic.Data = NULL;
+		}
+	CA_FOREACH_END()
+	CA_FOREACH(NamedSprites, ns, pm->sprites)
+		for (int j = 0; j < (int)ns->pics.size; j++)
+		{
+			Pic *p = CArrayGet(&ns->pics, j);
+			if (PicCacheOwns(&pm->cache, p->Data))
+			{
+				p->Data = NULL;
+			}
+		}
+	CA_FOREACH_END()
 	PicManagerClear(&pm->pics, &pm->sprites);
+	PicCacheTerminate(&pm->cache);
 	CArrayTerminate(&pm->pics);
 	CArrayTerminate(&pm->sprites);
+	NameMapTerminate(&pm->picsByName);
+	NameMapTerminate(&pm->spritesByName);
 	PicManagerClearCustom(pm);
 	CArrayTerminate(&pm->customPics);
 	CArrayTerminate(&pm->customSprites);
+	NameMapTerminate(&pm->customPicsByName);
+	NameMapTerminate(&pm->customSpritesByName);
 	CArrayTerminate(&pm->drainPics);
 	CA_FOREACH(char *, doorStyleName, pm->doorStyleNames)
 		CFREE(*doorStyleName);
@@ -502,21 +676,38 @@ Pic *PicManagerGetFromOld(PicManager *pm, int idx)
 }
 NamedPic *PicManagerGetNamedPic(const PicManager *pm, const char *name)
 {
-	for (int i = 0; i < (int)pm->customPics.size; i++)
+	int i = NameMapGet(&pm->customPicsByName, name);
+	if (i >= 0)
 	{
-		NamedPic *n = CArrayGet(&pm->customPics, i);
-		if (strcmp(n->name, name) == 0)
-		{
-			return n;
-		}
+		return CArrayGet(&pm->customPics, i);
 	}
-	for (int i = 0; i < (int)pm->pics.size; i++)
+	i = NameMapGet(&pm->picsByName, name);
+	if (i >= 0)
 	{
-		NamedPic *n = CArrayGet(&pm->pics, i);
-		if (strcmp(n->name, name) == 0)
-		{
-			return n;
-		}
+		return CArrayGet(&pm->pics, i);
+	}
+	return NULL;
+}
+int PicManagerGetNamedPicId(const PicManager *pm, const NamedPic *p)
+{
+	if (p == NULL) return -1;
+	const int i = CArrayIndexOf(&pm->pics, p);
+	if (i >= 0) return i;
+	const int ci = CArrayIndexOf(&pm->customPics, p);
+	CASSERT(ci >= 0, "cannot find pic");
+	if (ci < 0) return -1;
+	return (int)pm->pics.size + ci;
+}
+NamedPic *PicManagerGetNamedPicById(const PicManager *pm, const int id)
+{
+	if (id < 0) return NULL;
+	if (id < (int)pm->pics.size)
+	{
+		return CArrayGet(&pm->pics, id);
+	}
+	if (id < (int)(pm->pics.size + pm->customPics.size))
+	{
+		return CArrayGet(&pm->customPics, id - (int)pm->pics.size);
 	}
 	return NULL;
 }
@@ -553,21 +744,15 @@ defaultPic:
 const NamedSprites *PicManagerGetSprites(
 	const PicManager *pm, const char *name)
 {
-	for (int i = 0; i < (int)pm->customSprites.size; i++)
+	int i = NameMapGet(&pm->customSpritesByName, name);
+	if (i >= 0)
 	{
-		const NamedSprites *n = CArrayGet(&pm->customSprites, i);
-		if (strcmp(n->name, name) == 0)
-		{
-			return n;
-		}
+		return CArrayGet(&pm->customSprites, i);
 	}
-	for (int i = 0; i < (int)pm->sprites.size; i++)
+	i = NameMapGet(&pm->spritesByName, name);
+	if (i >= 0)
 	{
-		const NamedSprites *n = CArrayGet(&pm->sprites, i);
-		if (strcmp(n->name, name) == 0)
-		{
-			return n;
-		}
+		return CArrayGet(&pm->sprites, i);
 	}
 	return NULL;
 }
@@ -27,7 +27,9 @@
 */
 #pragma once
 
+#include "name_map.h"
 #include "pic.h"
+#include "pic_cache.h"
 #include "pics.h"
 
 typedef struct
@@ -39,26 +41,55 @@ typedef struct
 	CArray sprites;	// of NamedSprites
 	CArray customPics;	// of NamedPic
 	CArray customSprites;	// of NamedSprites
+	// Name indices of the above lists
+	NameMap picsByName;
+	NameMap spritesByName;
+	NameMap customPicsByName;
+	NameMap customSpritesByName;
 
 	CArray drainPics;	// of NamedPic *
 
 	CArray doorStyleNames;	// of char *, for editor
+
+	// Nesting depth of batch loads, and whether pics were added in them
+	int batchDepth;
+	bool isBatchAdded;
+
+	// Cache of the pics loaded from the graphics dir
+	PicCache cache;
 } PicManager;
 
 extern PicManager gPicManager;
 
 bool PicManagerTryInit(
 	PicManager *pm, const char *oldGfxFile1, const char *oldGfxFile2);
-void PicManagerLoadDir(PicManager *pm, const char *path);
+// Load the graphics dir, and the pics generated from the old graphics
+// If cachePath is not NULL, the converted pics are cached in that file,
+// which is rebuilt whenever the images change
+void PicManagerLoadDir(
+	PicManager *pm, const char *path, const char *cachePath);
+// Load the PNG images in a directory, optionally including subdirectories,
+// whose pics are named by their path from the directory
+// Images are decoded in parallel, then added in directory order
+void PicManagerLoadFiles(
+	PicManager *pm, CArray *pics, CArray *sprites, const char *path,
+	const bool recurse);
 void PicManagerAdd(
 	CArray *pics, CArray *sprites, const char *name, SDL_Surface *image);
 void PicManagerClearCustom(PicManager *pm);
+// Adding a pic rebuilds the indices derived from all pics (drains, door
+// styles); wrap many adds in a batch so they are only rebuilt once, at the end
+void PicManagerBeginBatch(PicManager *pm);
+void PicManagerEndBatch(PicManager *pm);
 void PicManagerTerminate(PicManager *pm);
 
 PicPaletted *PicManagerGetOldPic(PicManager *pm, int idx);
 Pic *PicManagerGetFromOld(PicManager *pm, int idx);
 // Note: return ptr to NamedPic so we can store that instead of the name
 NamedPic *PicManagerGetNamedPic(const PicManager *pm, const char *name);
+// IDs of named pics, -1 for none; custom pics follow the built-in ones
+int PicManagerGetNamedPicId(const PicManager *pm, const NamedPic *p);
+NamedPic *PicManagerGetNamedPicById(const PicManager *pm, const int id);
 Pic *PicManagerGetPic(const PicManager *pm, const char *name);
 Pic *PicManagerGet(PicManager *pm, const char *name, const int oldIdx);
 const NamedSprites *PicManagerGetSprites(
@@ -30,13 +30,19 @@
 #include "ammo.h"
 #include "game_events.h"
 #include "gamedata.h"
+#include "entity_pool.h"
 #include "json_utils.h"
+#include "net_assets.h"
 #include "net_util.h"
 #include "map.h"
+#include "uid_map.h"
 
 
 CArray gPickups;
 static unsigned int sPickupUIDs;
+// UID to index in gPickups
+static UIDMap sPickupUIDMap;
+static EntityPool sPickupPool;
 
 
 void PickupsInit(void)
@@ -44,6 +50,8 @@ void PickupsInit(void)
 	CArrayInit(&gPickups, sizeof(Pickup));
 	CArrayReserve(&gPickups, 128);
 	sPickupUIDs = 0;
+	UIDMapInit(&sPickupUIDMap);
+	EntityPoolInit(&sPickupPool);
 }
 void PickupsTerminate(void)
 {
@@ -56,6 +64,8 @@ void PickupsTerminate(void)
 		}
 	}
 	CArrayTerminate(&gPickups);
+	UIDMapTerminate(&sPickupUIDMap);
+	EntityPoolTerminate(&sPickupPool);
 }
 int PickupsGetNextUID(void)
 {
@@ -70,28 +80,13 @@ void PickupAdd(const NAddPickup ap)
 	{
 		PickupDestroy(ap.UID);
 	}
-	// Find an empty slot in pickup list
-	p = NULL;
-	int i;
-	for (i = 0; i < (int)gPickups.size; i++)
-	{
-		Pickup *pu = CArrayGet(&gPickups, i);
-		if (!pu->isInUse)
-		{
-			p = pu;
-			break;
-		}
-	}
-	if (p == NULL)
-	{
-		Pickup pu;
-		memset(&pu, 0, sizeof pu);
-		CArrayPushBack(&gPickups, &pu);
-		i = (int)gPickups.size - 1;
-		p = CArrayGet(&gPickups, i);
-	}
+	const int i = EntityPoolAdd(&sPickupPool, &gPickups);
+	p = CArrayGet(&gPickups, i);
+	// The slot may be reused; replace its old UID
+	UIDMapRemove(&sPickupUIDMap, p->UID, i);
 	memset(p, 0, sizeof *p);
 	p->UID = ap.UID;
+	UIDMapSet(&sPickupUIDMap, p->UID, i);
 	p->class = StrPickupClass(ap.PickupClass);
 	p->tileItem.x = p->tileItem.y = -1;
 	p->tileItem.flags = ap.TileItemFlags;
@@ -112,6 +107,7 @@ void PickupDestroy(const int uid)
 	CASSERT(p->isInUse, "Destroying not-in-use pickup");
 	MapRemoveTileItem(&gMap, &p->tileItem);
 	p->isInUse = false;
+	EntityPoolRemove(&sPickupPool, p->tileItem.id);
 }
 
 void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
@@ -128,7 +124,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			GameEvent e = GameEventNew(GAME_EVENT_SCORE);
 			e.u.Score.PlayerUID = a->PlayerUID;
 			e.u.Score.Score = p->class->u.Score;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			sound = "pickup";
 			UpdateMissionObjective(
 				&gMission, p->tileItem.flags, OBJECTIVE_COLLECT);
@@ -146,7 +142,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			e.u.Heal.PlayerUID = a->PlayerUID;
 			e.u.Heal.Amount = p->class->u.Health;
 			e.u.Heal.IsRandomSpawned = p->IsRandomSpawned;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 
@@ -186,7 +182,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			e.u.AddAmmo.Amount = p->class->u.Ammo.Amount;
 			e.u.AddAmmo.IsRandomSpawned = p->IsRandomSpawned;
 			// Note: receiving end will prevent ammo from exceeding max
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 
 			sound = ammo->Sound;
 		}
@@ -197,7 +193,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			GameEvent e = GameEventNew(GAME_EVENT_ADD_KEYS);
 			e.u.AddKeys.KeyFlags = p->class->u.Keys;
 			e.u.AddKeys.Pos = Vec2i2Net(actorPos);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		break;
 
@@ -210,8 +206,8 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 			e.u.ActorReplaceGun.GunIdx =
 				(int)a->guns.size == MAX_WEAPONS ?
 				a->gunIndex : (int)a->guns.size;
-			strcpy(e.u.ActorReplaceGun.Gun, gun->name);
-			GameEventsEnqueue(&gGameEvents, e);
+			e.u.ActorReplaceGun.GunId = NetAssetsGunId(gun);
+			GameEventsEnqueue(&gGameEvents, &e);
 
 			// If the player has less ammo than the default amount,
 			// replenish up to this amount
@@ -229,7 +225,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 					e.u.AddAmmo.AmmoId = ammoId;
 					e.u.AddAmmo.Amount = ammoDeficit;
 					e.u.AddAmmo.IsRandomSpawned = false;
-					GameEventsEnqueue(&gGameEvents, e);
+					GameEventsEnqueue(&gGameEvents, &e);
 				}
 			}
 		}
@@ -248,15 +244,15 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 		if (sound != NULL)
 		{
 			GameEvent es = GameEventNew(GAME_EVENT_SOUND_AT);
-			strcpy(es.u.SoundAt.Sound, sound);
+			es.u.SoundAt.SoundId = NetAssetsSoundId(sound);
 			es.u.SoundAt.Pos = Vec2i2Net(actorPos);
 			es.u.SoundAt.IsHit = false;
-			GameEventsEnqueue(&gGameEvents, es);
+			GameEventsEnqueue(&gGameEvents, &es);
 		}
 		GameEvent e = GameEventNew(GAME_EVENT_REMOVE_PICKUP);
 		e.u.RemovePickup.UID = p->UID;
 		e.u.RemovePickup.SpawnerUID = p->SpawnerUID;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		// Prevent multiple pickups by marking
 		p->PickedUp = true;
 	}
@@ -282,13 +278,6 @@ static const Pic *GetPickupPic(const int id, Vec2i *offset)
 
 Pickup *PickupGetByUID(const int uid)
 {
-	for (int i = 0; i < (int)gPickups.size; i++)
-	{
-		Pickup *p = CArrayGet(&gPickups, i);
-		if (p->UID == uid)
-		{
-			return p;
-		}
-	}
-	return NULL;
+	const int i = UIDMapGet(&sPickupUIDMap, uid);
+	return i >= 0 ? CArrayGet(&gPickups, i) : NULL;
 }
@@ -53,21 +53,15 @@ PickupClass *StrPickupClass(const char *s)
 	{
 		return NULL;
 	}
-	for (int i = 0; i < (int)gPickupClasses.CustomClasses.size; i++)
+	int i = NameMapGet(&gPickupClasses.CustomClassesByName, s);
+	if (i >= 0)
 	{
-		PickupClass *c = CArrayGet(&gPickupClasses.CustomClasses, i);
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
+		return CArrayGet(&gPickupClasses.CustomClasses, i);
 	}
-	for (int i = 0; i < (int)gPickupClasses.Classes.size; i++)
+	i = NameMapGet(&gPickupClasses.ClassesByName, s);
+	if (i >= 0)
 	{
-		PickupClass *c = CArrayGet(&gPickupClasses.Classes, i);
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
+		return CArrayGet(&gPickupClasses.Classes, i);
 	}
 	CASSERT(false, "cannot parse bullet name");
 	return NULL;
@@ -128,21 +122,15 @@ int StrPickupClassId(const char *s)
 	{
 		return 0;
 	}
-	for (int i = 0; i < (int)gPickupClasses.CustomClasses.size; i++)
+	int i = NameMapGet(&gPickupClasses.CustomClassesByName, s);
+	if (i >= 0)
 	{
-		Ammo *a = CArrayGet(&gPickupClasses.CustomClasses, i);
-		if (strcmp(s, a->Name) == 0)
-		{
-			return i + (int)gPickupClasses.Classes.size;
-		}
+		return i + (int)gPickupClasses.Classes.size;
 	}
-	for (int i = 0; i < (int)gPickupClasses.Classes.size; i++)
+	i = NameMapGet(&gPickupClasses.ClassesByName, s);
+	if (i >= 0)
 	{
-		Ammo *a = CArrayGet(&gPickupClasses.Classes, i);
-		if (strcmp(s, a->Name) == 0)
-		{
-			return i;
-		}
+		return i;
 	}
 	CASSERT(false, "cannot parse pickup class name");
 	return 0;
@@ -156,6 +144,11 @@ void PickupClassesInit(
 {
 	CArrayInit(&classes->Classes, sizeof(PickupClass));
 	CArrayInit(&classes->CustomClasses, sizeof(PickupClass));
+	NAME_MAP_INIT(
+		&classes->ClassesByName, &classes->Classes, PickupClass, Name, true);
+	NAME_MAP_INIT(
+		&classes->CustomClassesByName, &classes->CustomClasses, PickupClass,
+		Name, true);
 
 	FILE *f = fopen(filename, "r");
 	json_t *root = NULL;
@@ -286,6 +279,8 @@ void PickupClassesTerminate(PickupClasses *classes)
 	CArrayTerminate(&classes->Classes);
 	PickupClassesClear(&classes->CustomClasses);
 	CArrayTerminate(&classes->CustomClasses);
+	NameMapTerminate(&classes->ClassesByName);
+	NameMapTerminate(&classes->CustomClassesByName);
 }
 
 int PickupClassesGetScoreCount(const PickupClasses *classes)
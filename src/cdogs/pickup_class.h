@@ -30,6 +30,7 @@
 #include <json/json.h>
 
 #include "ammo.h"
+#include "name_map.h"
 #include "utils.h"
 #include "weapon.h"
 
@@ -63,6 +64,8 @@ typedef struct
 {
 	CArray Classes;	// of PickupClass
 	CArray CustomClasses;	// of PickupClass
+	NameMap ClassesByName;
+	NameMap CustomClassesByName;
 } PickupClasses;
 extern PickupClasses gPickupClasses;
 
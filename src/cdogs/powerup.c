@@ -35,6 +35,9 @@
 #include "net_util.h"
 #include "pickup.h"
 
+static ConfigHandle sConfigHealthPickups = CONFIG_HANDLE("Game.HealthPickups");
+static ConfigHandle sConfigAmmo = CONFIG_HANDLE("Game.Ammo");
+
 
 #define TIME_DECAY_EXPONENT 1.04
 #define HEALTH_W 6
@@ -140,7 +143,7 @@ void HealthSpawnerInit(PowerupSpawner *p, Map *map)
 	PowerupSpawnerInit(p, map);
 	p->Enabled =
 		AreHealthPickupsAllowed(gCampaign.Entry.Mode) &&
-		ConfigGetBool(&gConfig, "Game.HealthPickups") &&
+		ConfigHandleGetBool(&sConfigHealthPickups) &&
 		!gCampaign.IsClient;
 	p->SpawnTime = HEALTH_SPAWN_TIME;
 	p->RateScaleFunc = HealthScale;
@@ -179,7 +182,7 @@ static void HealthPlace(const Vec2i pos, void *data)
 	e.u.AddPickup.IsRandomSpawned = true;
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = 0;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 
@@ -192,7 +195,7 @@ void AmmoSpawnerInit(PowerupSpawner *p, Map *map, const int ammoId)
 	PowerupSpawnerInit(p, map);
 	// TODO: disable ammo spawners unless classic mode
 	p->Enabled =
-		ConfigGetBool(&gConfig, "Game.Ammo") &&
+		ConfigHandleGetBool(&sConfigAmmo) &&
 		!gCampaign.IsClient;
 	p->SpawnTime = AMMO_SPAWN_TIME;
 	p->RateScaleFunc = AmmoScale;
@@ -242,5 +245,5 @@ static void AmmoPlace(const Vec2i pos, void *data)
 	e.u.AddPickup.IsRandomSpawned = true;
 	e.u.AddPickup.SpawnerUID = -1;
 	e.u.AddPickup.TileItemFlags = 0;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
@@ -1,5 +1,5 @@
 /* Automatically generated nanopb constant definitions */
-/* Generated by nanopb-0.3.3 at Thu Sep  3 22:42:15 2015. */
+/* Generated by nanopb-0.3.3 at Sun Oct 18 14:21:07 2026. */
 
 #include "msg.pb.h"
 
@@ -7,6 +7,9 @@
 #error Regenerate this file with the current version of nanopb generator.
 #endif
 
+const int32_t NTileSet_PicId_default = -1;
+const int32_t NTileSet_PicAltId_default = -1;
+const int32_t NSound_SoundId_default = -1;
 const int32_t NActorAdd_PlayerUID_default = -1;
 const int32_t NActorHeal_PlayerUID_default = -1;
 const int32_t NActorHit_PlayerUID_default = -1;
@@ -35,6 +38,13 @@ const pb_field_t NCampaignDef_fields[4] = {
     PB_LAST_FIELD
 };
 
+const pb_field_t NAssetDef_fields[4] = {
+    PB_FIELD(  1, UINT32  , REQUIRED, STATIC  , FIRST, NAssetDef, Kind, Kind, 0),
+    PB_FIELD(  2, UINT32  , REQUIRED, STATIC  , OTHER, NAssetDef, Id, Kind, 0),
+    PB_FIELD(  3, STRING  , REQUIRED, STATIC  , OTHER, NAssetDef, Name, Id, 0),
+    PB_LAST_FIELD
+};
+
 const pb_field_t NCharLooks_fields[7] = {
     PB_FIELD(  1, INT32   , REQUIRED, STATIC  , FIRST, NCharLooks, Face, Face, 0),
     PB_FIELD(  2, INT32   , REQUIRED, STATIC  , OTHER, NCharLooks, Skin, Face, 0),
@@ -64,15 +74,15 @@ const pb_field_t NPlayerData_fields[13] = {
 const pb_field_t NTileSet_fields[5] = {
     PB_FIELD(  1, MESSAGE , REQUIRED, STATIC  , FIRST, NTileSet, Pos, Pos, &NVec2i_fields),
     PB_FIELD(  2, UINT32  , REQUIRED, STATIC  , OTHER, NTileSet, Flags, Pos, 0),
-    PB_FIELD(  3, STRING  , REQUIRED, STATIC  , OTHER, NTileSet, PicName, Flags, 0),
-    PB_FIELD(  4, STRING  , REQUIRED, STATIC  , OTHER, NTileSet, PicAltName, PicName, 0),
+    PB_FIELD(  3, SINT32  , REQUIRED, STATIC  , OTHER, NTileSet, PicId, Flags, &NTileSet_PicId_default),
+    PB_FIELD(  4, SINT32  , REQUIRED, STATIC  , OTHER, NTileSet, PicAltId, PicId, &NTileSet_PicAltId_default),
     PB_LAST_FIELD
 };
 
 const pb_field_t NMapObjectAdd_fields[6] = {
     PB_FIELD(  1, UINT32  , REQUIRED, STATIC  , FIRST, NMapObjectAdd, UID, UID, 0),
-    PB_FIELD(  2, STRING  , REQUIRED, STATIC  , OTHER, NMapObjectAdd, MapObjectClass, UID, 0),
-    PB_FIELD(  3, MESSAGE , REQUIRED, STATIC  , OTHER, NMapObjectAdd, Pos, MapObjectClass, &NVec2i_fields),
+    PB_FIELD(  2, SINT32  , REQUIRED, STATIC  , OTHER, NMapObjectAdd, MapObjectId, UID, 0),
+    PB_FIELD(  3, MESSAGE , REQUIRED, STATIC  , OTHER, NMapObjectAdd, Pos, MapObjectId, &NVec2i_fields),
     PB_FIELD(  4, UINT32  , REQUIRED, STATIC  , OTHER, NMapObjectAdd, TileItemFlags, Pos, 0),
     PB_FIELD(  5, INT32   , REQUIRED, STATIC  , OTHER, NMapObjectAdd, Health, TileItemFlags, 0),
     PB_LAST_FIELD
@@ -94,8 +104,8 @@ const pb_field_t NScore_fields[3] = {
 };
 
 const pb_field_t NSound_fields[4] = {
-    PB_FIELD(  1, STRING  , REQUIRED, STATIC  , FIRST, NSound, Sound, Sound, 0),
-    PB_FIELD(  2, MESSAGE , REQUIRED, STATIC  , OTHER, NSound, Pos, Sound, &NVec2i_fields),
+    PB_FIELD(  1, SINT32  , REQUIRED, STATIC  , FIRST, NSound, SoundId, SoundId, &NSound_SoundId_default),
+    PB_FIELD(  2, MESSAGE , REQUIRED, STATIC  , OTHER, NSound, Pos, SoundId, &NVec2i_fields),
     PB_FIELD(  3, BOOL    , REQUIRED, STATIC  , OTHER, NSound, IsHit, Pos, 0),
     PB_LAST_FIELD
 };
@@ -164,7 +174,7 @@ const pb_field_t NActorPickupAll_fields[3] = {
 const pb_field_t NActorReplaceGun_fields[4] = {
     PB_FIELD(  1, UINT32  , REQUIRED, STATIC  , FIRST, NActorReplaceGun, UID, UID, 0),
     PB_FIELD(  2, UINT32  , REQUIRED, STATIC  , OTHER, NActorReplaceGun, GunIdx, UID, 0),
-    PB_FIELD(  3, STRING  , REQUIRED, STATIC  , OTHER, NActorReplaceGun, Gun, GunIdx, 0),
+    PB_FIELD(  3, SINT32  , REQUIRED, STATIC  , OTHER, NActorReplaceGun, GunId, GunIdx, 0),
     PB_LAST_FIELD
 };
 
@@ -210,8 +220,8 @@ const pb_field_t NActorDie_fields[2] = {
 
 const pb_field_t NActorMelee_fields[6] = {
     PB_FIELD(  1, UINT32  , REQUIRED, STATIC  , FIRST, NActorMelee, UID, UID, 0),
-    PB_FIELD(  2, STRING  , REQUIRED, STATIC  , OTHER, NActorMelee, BulletClass, UID, 0),
-    PB_FIELD(  3, INT32   , REQUIRED, STATIC  , OTHER, NActorMelee, HitType, BulletClass, 0),
+    PB_FIELD(  2, SINT32  , REQUIRED, STATIC  , OTHER, NActorMelee, BulletClassId, UID, 0),
+    PB_FIELD(  3, INT32   , REQUIRED, STATIC  , OTHER, NActorMelee, HitType, BulletClassId, 0),
     PB_FIELD(  4, INT32   , REQUIRED, STATIC  , OTHER, NActorMelee, TargetKind, HitType, 0),
     PB_FIELD(  5, UINT32  , REQUIRED, STATIC  , OTHER, NActorMelee, TargetUID, TargetKind, 0),
     PB_LAST_FIELD
@@ -249,8 +259,8 @@ const pb_field_t NRemoveBullet_fields[2] = {
 
 const pb_field_t NGunReload_fields[5] = {
     PB_FIELD(  1, INT32   , REQUIRED, STATIC  , FIRST, NGunReload, PlayerUID, PlayerUID, &NGunReload_PlayerUID_default),
-    PB_FIELD(  2, STRING  , REQUIRED, STATIC  , OTHER, NGunReload, Gun, PlayerUID, 0),
-    PB_FIELD(  3, MESSAGE , REQUIRED, STATIC  , OTHER, NGunReload, FullPos, Gun, &NVec2i_fields),
+    PB_FIELD(  2, SINT32  , REQUIRED, STATIC  , OTHER, NGunReload, GunId, PlayerUID, 0),
+    PB_FIELD(  3, MESSAGE , REQUIRED, STATIC  , OTHER, NGunReload, FullPos, GunId, &NVec2i_fields),
     PB_FIELD(  4, INT32   , REQUIRED, STATIC  , OTHER, NGunReload, Direction, FullPos, 0),
     PB_LAST_FIELD
 };
@@ -258,8 +268,8 @@ const pb_field_t NGunReload_fields[5] = {
 const pb_field_t NGunFire_fields[10] = {
     PB_FIELD(  1, INT32   , REQUIRED, STATIC  , FIRST, NGunFire, UID, UID, &NGunFire_UID_default),
     PB_FIELD(  2, INT32   , REQUIRED, STATIC  , OTHER, NGunFire, PlayerUID, UID, &NGunFire_PlayerUID_default),
-    PB_FIELD(  3, STRING  , REQUIRED, STATIC  , OTHER, NGunFire, Gun, PlayerUID, 0),
-    PB_FIELD(  4, MESSAGE , REQUIRED, STATIC  , OTHER, NGunFire, MuzzleFullPos, Gun, &NVec2i_fields),
+    PB_FIELD(  3, SINT32  , REQUIRED, STATIC  , OTHER, NGunFire, GunId, PlayerUID, 0),
+    PB_FIELD(  4, MESSAGE , REQUIRED, STATIC  , OTHER, NGunFire, MuzzleFullPos, GunId, &NVec2i_fields),
     PB_FIELD(  5, INT32   , REQUIRED, STATIC  , OTHER, NGunFire, Z, MuzzleFullPos, 0),
     PB_FIELD(  6, FLOAT   , REQUIRED, STATIC  , OTHER, NGunFire, Angle, Z, 0),
     PB_FIELD(  7, BOOL    , REQUIRED, STATIC  , OTHER, NGunFire, Sound, Angle, 0),
@@ -276,8 +286,8 @@ const pb_field_t NGunState_fields[3] = {
 
 const pb_field_t NAddBullet_fields[10] = {
     PB_FIELD(  1, UINT32  , REQUIRED, STATIC  , FIRST, NAddBullet, UID, UID, 0),
-    PB_FIELD(  2, STRING  , REQUIRED, STATIC  , OTHER, NAddBullet, BulletClass, UID, 0),
-    PB_FIELD(  3, MESSAGE , REQUIRED, STATIC  , OTHER, NAddBullet, MuzzlePos, BulletClass, &NVec2i_fields),
+    PB_FIELD(  2, SINT32  , REQUIRED, STATIC  , OTHER, NAddBullet, BulletClassId, UID, 0),
+    PB_FIELD(  3, MESSAGE , REQUIRED, STATIC  , OTHER, NAddBullet, MuzzlePos, BulletClassId, &NVec2i_fields),
     PB_FIELD(  4, INT32   , REQUIRED, STATIC  , OTHER, NAddBullet, MuzzleHeight, MuzzlePos, 0),
     PB_FIELD(  5, FLOAT   , REQUIRED, STATIC  , OTHER, NAddBullet, Angle, MuzzleHeight, 0),
     PB_FIELD(  6, INT32   , REQUIRED, STATIC  , OTHER, NAddBullet, Elevation, Angle, 0),
@@ -336,7 +346,7 @@ const pb_field_t NMissionComplete_fields[2] = {
  * numbers or field sizes that are larger than what can fit in 8 or 16 bit
  * field descriptors.
  */
-PB_STATIC_ASSERT((pb_membersize(NPlayerData, Looks) < 65536 && pb_membersize(NTileSet, Pos) < 65536 && pb_membersize(NMapObjectAdd, Pos) < 65536 && pb_membersize(NSound, Pos) < 65536 && pb_membersize(NActorAdd, FullPos) < 65536 && pb_membersize(NActorMove, Pos) < 65536 && pb_membersize(NActorMove, MoveVel) < 65536 && pb_membersize(NActorSlide, Vel) < 65536 && pb_membersize(NActorImpulse, Vel) < 65536 && pb_membersize(NActorImpulse, Pos) < 65536 && pb_membersize(NActorHit, Vel) < 65536 && pb_membersize(NAddPickup, Pos) < 65536 && pb_membersize(NBulletBounce, BouncePos) < 65536 && pb_membersize(NBulletBounce, BounceVel) < 65536 && pb_membersize(NGunReload, FullPos) < 65536 && pb_membersize(NGunFire, MuzzleFullPos) < 65536 && pb_membersize(NAddBullet, MuzzlePos) < 65536 && pb_membersize(NTrigger, Tile) < 65536 && pb_membersize(NExploreTiles, Runs[0]) < 65536 && pb_membersize(NExploreTiles_Run, Tile) < 65536 && pb_membersize(NAddKeys, Pos) < 65536), YOU_MUST_DEFINE_PB_FIELD_32BIT_FOR_MESSAGES_NClientId_NCampaignDef_NCharLooks_NPlayerData_NTileSet_NMapObjectAdd_NMapObjectDamage_NScore_NSound_NVec2i_NActorAdd_NActorMove_NActorState_NActorDir_NActorSlide_NActorImpulse_NActorSwitchGun_NActorPickupAll_NActorReplaceGun_NActorHeal_NActorHit_NActorAddAmmo_NActorUseAmmo_NActorDie_NActorMelee_NAddPickup_NRemovePickup_NBulletBounce_NRemoveBullet_NGunReload_NGunFire_NGunState_NAddBullet_NTrigger_NExploreTiles_NExploreTiles_Run_NRescueCharacter_NObjectiveUpdate_NAddKeys_NMissionComplete)
+PB_STATIC_ASSERT((pb_membersize(NPlayerData, Looks) < 65536 && pb_membersize(NTileSet, Pos) < 65536 && pb_membersize(NMapObjectAdd, Pos) < 65536 && pb_membersize(NSound, Pos) < 65536 && pb_membersize(NActorAdd, FullPos) < 65536 && pb_membersize(NActorMove, Pos) < 65536 && pb_membersize(NActorMove, MoveVel) < 65536 && pb_membersize(NActorSlide, Vel) < 65536 && pb_membersize(NActorImpulse, Vel) < 65536 && pb_membersize(NActorImpulse, Pos) < 65536 && pb_membersize(NActorHit, Vel) < 65536 && pb_membersize(NAddPickup, Pos) < 65536 && pb_membersize(NBulletBounce, BouncePos) < 65536 && pb_membersize(NBulletBounce, BounceVel) < 65536 && pb_membersize(NGunReload, FullPos) < 65536 && pb_membersize(NGunFire, MuzzleFullPos) < 65536 && pb_membersize(NAddBullet, MuzzlePos) < 65536 && pb_membersize(NTrigger, Tile) < 65536 && pb_membersize(NExploreTiles, Runs[0]) < 65536 && pb_membersize(NExploreTiles_Run, Tile) < 65536 && pb_membersize(NAddKeys, Pos) < 65536), YOU_MUST_DEFINE_PB_FIELD_32BIT_FOR_MESSAGES_NClientId_NCampaignDef_NAssetDef_NCharLooks_NPlayerData_NTileSet_NMapObjectAdd_NMapObjectDamage_NScore_NSound_NVec2i_NActorAdd_NActorMove_NActorState_NActorDir_NActorSlide_NActorImpulse_NActorSwitchGun_NActorPickupAll_NActorReplaceGun_NActorHeal_NActorHit_NActorAddAmmo_NActorUseAmmo_NActorDie_NActorMelee_NAddPickup_NRemovePickup_NBulletBounce_NRemoveBullet_NGunReload_NGunFire_NGunState_NAddBullet_NTrigger_NExploreTiles_NExploreTiles_Run_NRescueCharacter_NObjectiveUpdate_NAddKeys_NMissionComplete)
 #endif
 
 #if !defined(PB_FIELD_16BIT) && !defined(PB_FIELD_32BIT)
@@ -1,5 +1,5 @@
 /* Automatically generated nanopb header */
-/* Generated by nanopb-0.3.3 at Thu Sep  3 22:42:15 2015. */
+/* Generated by nanopb-0.3.3 at Sun Oct 18 14:21:07 2026. */
 
 #ifndef PB_MSG_PB_H_INCLUDED
 #define PB_MSG_PB_H_INCLUDED
@@ -41,7 +41,7 @@ typedef struct _NActorHeal {
 
 typedef struct _NActorMelee {
     uint32_t UID;
-    char BulletClass[128];
+    int32_t BulletClassId;
     int32_t HitType;
     int32_t TargetKind;
     uint32_t TargetUID;
@@ -55,7 +55,7 @@ typedef struct _NActorPickupAll {
 typedef struct _NActorReplaceGun {
     uint32_t UID;
     uint32_t GunIdx;
-    char Gun[128];
+    int32_t GunId;
 } NActorReplaceGun;
 
 typedef struct _NActorState {
@@ -75,6 +75,12 @@ typedef struct _NActorUseAmmo {
     uint32_t Amount;
 } NActorUseAmmo;
 
+typedef struct _NAssetDef {
+    uint32_t Kind;
+    uint32_t Id;
+    char Name[128];
+} NAssetDef;
+
 typedef struct _NCampaignDef {
     char Path[4096];
     int32_t GameMode;
@@ -178,7 +184,7 @@ typedef struct _NActorSlide {
 
 typedef struct _NAddBullet {
     uint32_t UID;
-    char BulletClass[128];
+    int32_t BulletClassId;
     NVec2i MuzzlePos;
     int32_t MuzzleHeight;
     float Angle;
@@ -218,7 +224,7 @@ typedef struct _NExploreTiles_Run {
 typedef struct _NGunFire {
     int32_t UID;
     int32_t PlayerUID;
-    char Gun[128];
+    int32_t GunId;
     NVec2i MuzzleFullPos;
     int32_t Z;
     float Angle;
@@ -229,14 +235,14 @@ typedef struct _NGunFire {
 
 typedef struct _NGunReload {
     int32_t PlayerUID;
-    char Gun[128];
+    int32_t GunId;
     NVec2i FullPos;
     int32_t Direction;
 } NGunReload;
 
 typedef struct _NMapObjectAdd {
     uint32_t UID;
-    char MapObjectClass[128];
+    int32_t MapObjectId;
     NVec2i Pos;
     uint32_t TileItemFlags;
     int32_t Health;
@@ -259,7 +265,7 @@ typedef struct _NPlayerData {
 } NPlayerData;
 
 typedef struct _NSound {
-    char Sound[128];
+    int32_t SoundId;
     NVec2i Pos;
     bool IsHit;
 } NSound;
@@ -267,8 +273,8 @@ typedef struct _NSound {
 typedef struct _NTileSet {
     NVec2i Pos;
     uint32_t Flags;
-    char PicName[128];
-    char PicAltName[128];
+    int32_t PicId;
+    int32_t PicAltId;
 } NTileSet;
 
 typedef struct _NTrigger {
@@ -282,6 +288,9 @@ typedef struct _NExploreTiles {
 } NExploreTiles;
 
 /* Default values for struct fields */
+extern const int32_t NTileSet_PicId_default;
+extern const int32_t NTileSet_PicAltId_default;
+extern const int32_t NSound_SoundId_default;
 extern const int32_t NActorAdd_PlayerUID_default;
 extern const int32_t NActorHeal_PlayerUID_default;
 extern const int32_t NActorHit_PlayerUID_default;
@@ -299,13 +308,14 @@ extern const int32_t NAddBullet_ActorUID_default;
 /* Initializer values for message structs */
 #define NClientId_init_default                   {0, 0}
 #define NCampaignDef_init_default                {"", 0, 0}
+#define NAssetDef_init_default                   {0, 0, ""}
 #define NCharLooks_init_default                  {0, 0, 0, 0, 0, 0}
 #define NPlayerData_init_default                 {"", NCharLooks_init_default, 0, {"", "", ""}, 0, 0, 0, 0, 0, 0, 0, 0, 0}
-#define NTileSet_init_default                    {NVec2i_init_default, 0, "", ""}
-#define NMapObjectAdd_init_default               {0, "", NVec2i_init_default, 0, 0}
+#define NTileSet_init_default                    {NVec2i_init_default, 0, -1, -1}
+#define NMapObjectAdd_init_default               {0, 0, NVec2i_init_default, 0, 0}
 #define NMapObjectDamage_init_default            {0, 0, 0, 0, 0}
 #define NScore_init_default                      {0, 0}
-#define NSound_init_default                      {"", NVec2i_init_default, 0}
+#define NSound_init_default                      {-1, NVec2i_init_default, 0}
 #define NVec2i_init_default                      {0, 0}
 #define NActorAdd_init_default                   {0, 0, 0, 0, -1, 0, NVec2i_init_default}
 #define NActorMove_init_default                  {0, NVec2i_init_default, NVec2i_init_default}
@@ -315,21 +325,21 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorImpulse_init_default               {0, NVec2i_init_default, NVec2i_init_default}
 #define NActorSwitchGun_init_default             {0, 0}
 #define NActorPickupAll_init_default             {0, 0}
-#define NActorReplaceGun_init_default            {0, 0, ""}
+#define NActorReplaceGun_init_default            {0, 0, 0}
 #define NActorHeal_init_default                  {0, -1, 0, 0}
 #define NActorHit_init_default                   {0, -1, -1, 0, 0, NVec2i_init_default}
 #define NActorAddAmmo_init_default               {0, -1, 0, 0, 0}
 #define NActorUseAmmo_init_default               {0, -1, 0, 0}
 #define NActorDie_init_default                   {0}
-#define NActorMelee_init_default                 {0, "", 0, 0, 0}
+#define NActorMelee_init_default                 {0, 0, 0, 0, 0}
 #define NAddPickup_init_default                  {0, "", 0, -1, 0, NVec2i_init_default}
 #define NRemovePickup_init_default               {0, -1}
 #define NBulletBounce_init_default               {0, 0, 0, NVec2i_init_default, NVec2i_init_default}
 #define NRemoveBullet_init_default               {0}
-#define NGunReload_init_default                  {-1, "", NVec2i_init_default, 0}
-#define NGunFire_init_default                    {-1, -1, "", NVec2i_init_default, 0, 0, 0, 0, 0}
+#define NGunReload_init_default                  {-1, 0, NVec2i_init_default, 0}
+#define NGunFire_init_default                    {-1, -1, 0, NVec2i_init_default, 0, 0, 0, 0, 0}
 #define NGunState_init_default                   {0, 0}
-#define NAddBullet_init_default                  {0, "", NVec2i_init_default, 0, 0, 0, 0, -1, -1}
+#define NAddBullet_init_default                  {0, 0, NVec2i_init_default, 0, 0, 0, 0, -1, -1}
 #define NTrigger_init_default                    {0, NVec2i_init_default}
 #define NExploreTiles_init_default               {0, {NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default}}
 #define NExploreTiles_Run_init_default           {NVec2i_init_default, 0}
@@ -339,13 +349,14 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NMissionComplete_init_default            {0}
 #define NClientId_init_zero                      {0, 0}
 #define NCampaignDef_init_zero                   {"", 0, 0}
+#define NAssetDef_init_zero                      {0, 0, ""}
 #define NCharLooks_init_zero                     {0, 0, 0, 0, 0, 0}
 #define NPlayerData_init_zero                    {"", NCharLooks_init_zero, 0, {"", "", ""}, 0, 0, 0, 0, 0, 0, 0, 0, 0}
-#define NTileSet_init_zero                       {NVec2i_init_zero, 0, "", ""}
-#define NMapObjectAdd_init_zero                  {0, "", NVec2i_init_zero, 0, 0}
+#define NTileSet_init_zero                       {NVec2i_init_zero, 0, 0, 0}
+#define NMapObjectAdd_init_zero                  {0, 0, NVec2i_init_zero, 0, 0}
 #define NMapObjectDamage_init_zero               {0, 0, 0, 0, 0}
 #define NScore_init_zero                         {0, 0}
-#define NSound_init_zero                         {"", NVec2i_init_zero, 0}
+#define NSound_init_zero                         {0, NVec2i_init_zero, 0}
 #define NVec2i_init_zero                         {0, 0}
 #define NActorAdd_init_zero                      {0, 0, 0, 0, 0, 0, NVec2i_init_zero}
 #define NActorMove_init_zero                     {0, NVec2i_init_zero, NVec2i_init_zero}
@@ -355,21 +366,21 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorImpulse_init_zero                  {0, NVec2i_init_zero, NVec2i_init_zero}
 #define NActorSwitchGun_init_zero                {0, 0}
 #define NActorPickupAll_init_zero                {0, 0}
-#define NActorReplaceGun_init_zero               {0, 0, ""}
+#define NActorReplaceGun_init_zero               {0, 0, 0}
 #define NActorHeal_init_zero                     {0, 0, 0, 0}
 #define NActorHit_init_zero                      {0, 0, 0, 0, 0, NVec2i_init_zero}
 #define NActorAddAmmo_init_zero                  {0, 0, 0, 0, 0}
 #define NActorUseAmmo_init_zero                  {0, 0, 0, 0}
 #define NActorDie_init_zero                      {0}
-#define NActorMelee_init_zero                    {0, "", 0, 0, 0}
+#define NActorMelee_init_zero                    {0, 0, 0, 0, 0}
 #define NAddPickup_init_zero                     {0, "", 0, 0, 0, NVec2i_init_zero}
 #define NRemovePickup_init_zero                  {0, 0}
 #define NBulletBounce_init_zero                  {0, 0, 0, NVec2i_init_zero, NVec2i_init_zero}
 #define NRemoveBullet_init_zero                  {0}
-#define NGunReload_init_zero                     {0, "", NVec2i_init_zero, 0}
-#define NGunFire_init_zero                       {0, 0, "", NVec2i_init_zero, 0, 0, 0, 0, 0}
+#define NGunReload_init_zero                     {0, 0, NVec2i_init_zero, 0}
+#define NGunFire_init_zero                       {0, 0, 0, NVec2i_init_zero, 0, 0, 0, 0, 0}
 #define NGunState_init_zero                      {0, 0}
-#define NAddBullet_init_zero                     {0, "", NVec2i_init_zero, 0, 0, 0, 0, 0, 0}
+#define NAddBullet_init_zero                     {0, 0, NVec2i_init_zero, 0, 0, 0, 0, 0, 0}
 #define NTrigger_init_zero                       {0, NVec2i_init_zero}
 #define NExploreTiles_init_zero                  {0, {NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero}}
 #define NExploreTiles_Run_init_zero              {NVec2i_init_zero, 0}
@@ -392,7 +403,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorHeal_Amount_tag                    3
 #define NActorHeal_IsRandomSpawned_tag           4
 #define NActorMelee_UID_tag                      1
-#define NActorMelee_BulletClass_tag              2
+#define NActorMelee_BulletClassId_tag            2
 #define NActorMelee_HitType_tag                  3
 #define NActorMelee_TargetKind_tag               4
 #define NActorMelee_TargetUID_tag                5
@@ -400,7 +411,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorPickupAll_PickupAll_tag            2
 #define NActorReplaceGun_UID_tag                 1
 #define NActorReplaceGun_GunIdx_tag              2
-#define NActorReplaceGun_Gun_tag                 3
+#define NActorReplaceGun_GunId_tag               3
 #define NActorState_UID_tag                      1
 #define NActorState_State_tag                    2
 #define NActorSwitchGun_UID_tag                  1
@@ -409,6 +420,9 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorUseAmmo_PlayerUID_tag              2
 #define NActorUseAmmo_AmmoId_tag                 3
 #define NActorUseAmmo_Amount_tag                 4
+#define NAssetDef_Kind_tag                       1
+#define NAssetDef_Id_tag                         2
+#define NAssetDef_Name_tag                       3
 #define NCampaignDef_Path_tag                    1
 #define NCampaignDef_GameMode_tag                2
 #define NCampaignDef_Mission_tag                 3
@@ -460,7 +474,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorSlide_UID_tag                      1
 #define NActorSlide_Vel_tag                      2
 #define NAddBullet_UID_tag                       1
-#define NAddBullet_BulletClass_tag               2
+#define NAddBullet_BulletClassId_tag             2
 #define NAddBullet_MuzzlePos_tag                 3
 #define NAddBullet_MuzzleHeight_tag              4
 #define NAddBullet_Angle_tag                     5
@@ -485,7 +499,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NExploreTiles_Run_Run_tag                2
 #define NGunFire_UID_tag                         1
 #define NGunFire_PlayerUID_tag                   2
-#define NGunFire_Gun_tag                         3
+#define NGunFire_GunId_tag                       3
 #define NGunFire_MuzzleFullPos_tag               4
 #define NGunFire_Z_tag                           5
 #define NGunFire_Angle_tag                       6
@@ -493,11 +507,11 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NGunFire_Flags_tag                       8
 #define NGunFire_IsGun_tag                       9
 #define NGunReload_PlayerUID_tag                 1
-#define NGunReload_Gun_tag                       2
+#define NGunReload_GunId_tag                     2
 #define NGunReload_FullPos_tag                   3
 #define NGunReload_Direction_tag                 4
 #define NMapObjectAdd_UID_tag                    1
-#define NMapObjectAdd_MapObjectClass_tag         2
+#define NMapObjectAdd_MapObjectId_tag            2
 #define NMapObjectAdd_Pos_tag                    3
 #define NMapObjectAdd_TileItemFlags_tag          4
 #define NMapObjectAdd_Health_tag                 5
@@ -513,13 +527,13 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NPlayerData_MaxHealth_tag                10
 #define NPlayerData_LastMission_tag              11
 #define NPlayerData_UID_tag                      12
-#define NSound_Sound_tag                         1
+#define NSound_SoundId_tag                       1
 #define NSound_Pos_tag                           2
 #define NSound_IsHit_tag                         3
 #define NTileSet_Pos_tag                         1
 #define NTileSet_Flags_tag                       2
-#define NTileSet_PicName_tag                     3
-#define NTileSet_PicAltName_tag                  4
+#define NTileSet_PicId_tag                       3
+#define NTileSet_PicAltId_tag                    4
 #define NTrigger_ID_tag                          1
 #define NTrigger_Tile_tag                        2
 #define NExploreTiles_Runs_tag                   1
@@ -527,6 +541,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 /* Struct field encoding specification for nanopb */
 extern const pb_field_t NClientId_fields[3];
 extern const pb_field_t NCampaignDef_fields[4];
+extern const pb_field_t NAssetDef_fields[4];
 extern const pb_field_t NCharLooks_fields[7];
 extern const pb_field_t NPlayerData_fields[13];
 extern const pb_field_t NTileSet_fields[5];
@@ -569,13 +584,14 @@ extern const pb_field_t NMissionComplete_fields[2];
 /* Maximum encoded size of messages (where known) */
 #define NClientId_size                           12
 #define NCampaignDef_size                        4116
+#define NAssetDef_size                           143
 #define NCharLooks_size                          66
 #define NPlayerData_size                         562
-#define NTileSet_size                            292
-#define NMapObjectAdd_size                       178
+#define NTileSet_size                            42
+#define NMapObjectAdd_size                       53
 #define NMapObjectDamage_size                    45
 #define NScore_size                              17
-#define NSound_size                              157
+#define NSound_size                              32
 #define NVec2i_size                              22
 #define NActorAdd_size                           75
 #define NActorMove_size                          54
@@ -585,21 +601,21 @@ extern const pb_field_t NMissionComplete_fields[2];
 #define NActorImpulse_size                       54
 #define NActorSwitchGun_size                     12
 #define NActorPickupAll_size                     8
-#define NActorReplaceGun_size                    143
+#define NActorReplaceGun_size                    18
 #define NActorHeal_size                          30
 #define NActorHit_size                           74
 #define NActorAddAmmo_size                       31
 #define NActorUseAmmo_size                       29
 #define NActorDie_size                           6
-#define NActorMelee_size                         165
+#define NActorMelee_size                         40
 #define NAddPickup_size                          180
 #define NRemovePickup_size                       17
 #define NBulletBounce_size                       67
 #define NRemoveBullet_size                       6
-#define NGunReload_size                          177
-#define NGunFire_size                            203
+#define NGunReload_size                          52
+#define NGunFire_size                            78
 #define NGunState_size                           17
-#define NAddBullet_size                          216
+#define NAddBullet_size                          91
 #define NTrigger_size                            30
 #define NExploreTiles_size                       592
 #define NExploreTiles_Run_size                   35
@@ -33,8 +33,10 @@
 #include "config.h"
 #include "sys_config.h"
 
-#define MAX_SHAKE (100 * ConfigGetInt(&gConfig, "Game.FPS") / 100)
-#define SHAKE_STANDARD (70 * 1 * ConfigGetInt(&gConfig, "Game.FPS") / 100)
+static ConfigHandle sConfigFPS = CONFIG_HANDLE("Game.FPS");
+
+#define MAX_SHAKE (100 * ConfigHandleGetInt(&sConfigFPS) / 100)
+#define SHAKE_STANDARD (70 * 1 * ConfigHandleGetInt(&sConfigFPS) / 100)
 
 
 ScreenShake ScreenShakeZero(void)
@@ -47,7 +49,7 @@ ScreenShake ScreenShakeZero(void)
 ScreenShake ScreenShakeAdd(ScreenShake s, int force, int multiplier)
 {
 	const int extra =
-		force * multiplier * ConfigGetInt(&gConfig, "Game.FPS") / 100;
+		force * multiplier * ConfigHandleGetInt(&sConfigFPS) / 100;
 	s += extra;
 	/* So we don't shake too much :) */
 	s = MIN(s, MAX_SHAKE);
@@ -48,6 +48,7 @@
 */
 #include "sounds.h"
 
+#include <ctype.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -92,21 +93,60 @@ int OpenAudio(int frequency, Uint16 format, int channels, int chunkSize)
 	return 0;
 }
 
+// Handle for a sound that may not be decoded yet
+// Plays use the chunk, which borrows the samples while they are decoded
+typedef struct SoundChunk
+{
+	Mix_Chunk chunk;
+	char *path;
+	Mix_Chunk *decoded;
+	Uint32 lastUsed;
+	bool isFailed;
+} SoundChunk;
+
 static void LoadSound(SoundDevice *device, const char *name, const char *path)
 {
-	Mix_Chunk *data = Mix_LoadWAV(path);
-	if (data == NULL)
-	{
-		return;
-	}
 	char buf[CDOGS_FILENAME_MAX];
 	PathGetWithoutExtension(buf, name);
-	SoundAdd(&device->sounds, buf, data);
+	SoundAdd(&device->sounds, buf, path);
+}
+static bool IsSoundFile(const char *path)
+{
+	// Only register files the mixer can decode, as sound dirs also hold
+	// licence text files with the same names
+	static const char *exts[] =
+	{
+		"wav", "ogg", "voc", "aiff", "aif", "flac", "mp3", NULL
+	};
+	const char *ext = StrGetFileExt(path);
+	for (int i = 0; exts[i] != NULL; i++)
+	{
+		const char *a = ext;
+		const char *b = exts[i];
+		while (*a != '\0' && tolower((unsigned char)*a) == *b)
+		{
+			a++;
+			b++;
+		}
+		if (*a == '\0' && *b == '\0')
+		{
+			return true;
+		}
+	}
+	return false;
 }
-void SoundAdd(CArray *sounds, const char *name, Mix_Chunk *data)
+void SoundAdd(CArray *sounds, const char *name, const char *path)
 {
+	if (!IsSoundFile(path))
+	{
+		return;
+	}
+	SoundChunk *sc;
+	CMALLOC(sc, sizeof *sc);
+	memset(sc, 0, sizeof *sc);
+	CSTRDUP(sc->path, path);
 	SoundData sound;
-	sound.data = data;
+	sound.data = &sc->chunk;
 	strcpy(sound.Name, name);
 	CArrayPushBack(sounds, &sound);
 }
@@ -122,10 +162,18 @@ void SoundInitialize(SoundDevice *device, const char *path)
 	}
 
 	device->channels = 64;
+	device->cacheMutex = SDL_CreateMutex();
+	device->prefetchCond = SDL_CreateCond();
+	CArrayInit(&device->prefetchQueue, sizeof(SoundChunk *));
 	SoundReconfigure(device);
 
 	CArrayInit(&device->sounds, sizeof(SoundData));
 	CArrayInit(&device->customSounds, sizeof(SoundData));
+	NAME_MAP_INIT(
+		&device->soundsByName, &device->sounds, SoundData, Name, false);
+	NAME_MAP_INIT(
+		&device->customSoundsByName, &device->customSounds, SoundData, Name,
+		false);
 	SoundLoadDirImpl(device, path, NULL);
 
 	// Look for commonly used sounds to set our pointers
@@ -207,6 +255,10 @@ void SoundReconfigure(SoundDevice *s)
 	}
 
 	Mix_Volume(-1, ConfigGetInt(&gConfig, "Sound.SoundVolume"));
+	SDL_LockMutex(s->cacheMutex);
+	s->cacheBudget =
+		(size_t)ConfigGetInt(&gConfig, "Sound.CacheSize") * 1024 * 1024;
+	SDL_UnlockMutex(s->cacheMutex);
 	Mix_VolumeMusic(ConfigGetInt(&gConfig, "Sound.MusicVolume"));
 	if (ConfigGetInt(&gConfig, "Sound.MusicVolume") > 0)
 	{
@@ -220,13 +272,28 @@ void SoundReconfigure(SoundDevice *s)
 	s->isInitialised = true;
 }
 
-void SoundClear(CArray *sounds)
+static void PrefetchCancel(SoundDevice *device);
+static void SoundChunkUnload(SoundDevice *device, SoundChunk *sc);
+void SoundClear(SoundDevice *device, CArray *sounds)
 {
-	for (int i = 0; i < (int)sounds->size; i++)
-	{
-		SoundData *sound = CArrayGet(sounds, i);
-		Mix_FreeChunk(sound->data);
-	}
+	PrefetchCancel(device);
+	CA_FOREACH(SoundData, sound, *sounds)
+		SoundChunk *sc = (SoundChunk *)sound->data;
+		// Stop channels that are borrowing the samples
+		for (int j = 0; j < device->channels; j++)
+		{
+			if (Mix_GetChunk(j) == &sc->chunk)
+			{
+				Mix_HaltChannel(j);
+			}
+		}
+		if (sc->decoded != NULL)
+		{
+			SoundChunkUnload(device, sc);
+		}
+		CFREE(sc->path);
+		CFREE(sc);
+	CA_FOREACH_END()
 	CArrayClear(sounds);
 }
 void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete)
@@ -244,16 +311,217 @@ void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete)
 			SDL_GetTicks() - waitStart < 1000);
 	}
 	MusicStop(device);
+
+	if (device->prefetchThread != NULL)
+	{
+		SDL_LockMutex(device->cacheMutex);
+		device->prefetchQuit = true;
+		SDL_CondBroadcast(device->prefetchCond);
+		SDL_UnlockMutex(device->cacheMutex);
+		SDL_WaitThread(device->prefetchThread, NULL);
+		device->prefetchThread = NULL;
+	}
+	SoundClear(device, &device->sounds);
+	CArrayTerminate(&device->sounds);
+	SoundClear(device, &device->customSounds);
+	CArrayTerminate(&device->customSounds);
+	NameMapTerminate(&device->soundsByName);
+	NameMapTerminate(&device->customSoundsByName);
+	CArrayTerminate(&device->prefetchQueue);
+	SDL_DestroyCond(device->prefetchCond);
+	SDL_DestroyMutex(device->cacheMutex);
+
 	while (Mix_Init(0))
 	{
 		Mix_Quit();
 	}
 	Mix_CloseAudio();
+}
 
-	SoundClear(&device->sounds);
-	CArrayTerminate(&device->sounds);
-	SoundClear(&device->customSounds);
-	CArrayTerminate(&device->customSounds);
+// Cache of decoded sounds
+// Decoding happens on first play, or ahead of time on the prefetch thread.
+// Only the main thread installs samples into chunks or evicts them, so a
+// chunk's samples never change while the mixer may be reading them.
+
+// Call with the cache mutex held
+static void SoundChunkSetDecoded(
+	SoundDevice *device, SoundChunk *sc, Mix_Chunk *decoded)
+{
+	if (sc->decoded != NULL)
+	{
+		Mix_FreeChunk(decoded);
+		return;
+	}
+	if (decoded == NULL)
+	{
+		LOG(LM_SOUND, LL_WARN, "cannot load sound %s: %s",
+			sc->path, Mix_GetError());
+		sc->isFailed = true;
+		return;
+	}
+	sc->decoded = decoded;
+	sc->lastUsed = SDL_GetTicks();
+	device->cacheSize += decoded->alen;
+}
+static void SoundChunkUnload(SoundDevice *device, SoundChunk *sc)
+{
+	device->cacheSize -= sc->decoded->alen;
+	Mix_FreeChunk(sc->decoded);
+	sc->decoded = NULL;
+	sc->chunk.abuf = NULL;
+	sc->chunk.alen = 0;
+}
+
+// Make sure a chunk has samples to play, decoding it if necessary
+static bool SoundChunkLoad(SoundDevice *device, SoundChunk *sc)
+{
+	SDL_LockMutex(device->cacheMutex);
+	// Don't decode twice if the prefetch thread is already on it
+	while (device->prefetching == sc)
+	{
+		SDL_CondWait(device->prefetchCond, device->cacheMutex);
+	}
+	if (sc->decoded == NULL && !sc->isFailed)
+	{
+		SDL_UnlockMutex(device->cacheMutex);
+		Mix_Chunk *decoded = Mix_LoadWAV(sc->path);
+		SDL_LockMutex(device->cacheMutex);
+		SoundChunkSetDecoded(device, sc, decoded);
+	}
+	const bool isLoaded = sc->decoded != NULL;
+	if (isLoaded)
+	{
+		sc->chunk.abuf = sc->decoded->abuf;
+		sc->chunk.alen = sc->decoded->alen;
+		sc->chunk.volume = sc->decoded->volume;
+		sc->lastUsed = SDL_GetTicks();
+	}
+	SDL_UnlockMutex(device->cacheMutex);
+	return isLoaded;
+}
+
+static bool SoundChunkIsPlaying(const SoundDevice *device, const SoundChunk *sc)
+{
+	for (int i = 0; i < device->channels; i++)
+	{
+		if (Mix_Playing(i) && Mix_GetChunk(i) == &sc->chunk)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+static void FindEvictable(
+	const SoundDevice *device, const CArray *sounds, SoundChunk **lru)
+{
+	CA_FOREACH(const SoundData, sound, *sounds)
+		SoundChunk *sc = (SoundChunk *)sound->data;
+		if (sc->decoded == NULL ||
+			(*lru != NULL && (Sint32)(sc->lastUsed - (*lru)->lastUsed) >= 0))
+		{
+			continue;
+		}
+		if (!SoundChunkIsPlaying(device, sc))
+		{
+			*lru = sc;
+		}
+	CA_FOREACH_END()
+}
+// Free the least recently played sounds until under budget
+static void SoundCacheEvict(SoundDevice *device)
+{
+	SDL_LockMutex(device->cacheMutex);
+	while (device->cacheSize > device->cacheBudget)
+	{
+		SoundChunk *lru = NULL;
+		FindEvictable(device, &device->sounds, &lru);
+		FindEvictable(device, &device->customSounds, &lru);
+		if (lru == NULL)
+		{
+			break;
+		}
+		LOG(LM_SOUND, LL_DEBUG, "evict sound %s", lru->path);
+		SoundChunkUnload(device, lru);
+	}
+	SDL_UnlockMutex(device->cacheMutex);
+}
+
+static int PrefetchLoop(void *data)
+{
+	SoundDevice *device = data;
+	SDL_LockMutex(device->cacheMutex);
+	for (;;)
+	{
+		while (!device->prefetchQuit && device->prefetchQueue.size == 0)
+		{
+			SDL_CondWait(device->prefetchCond, device->cacheMutex);
+		}
+		if (device->prefetchQuit)
+		{
+			break;
+		}
+		SoundChunk *sc =
+			*(SoundChunk **)CArrayGet(&device->prefetchQueue, 0);
+		CArrayDelete(&device->prefetchQueue, 0);
+		if (sc->decoded != NULL || sc->isFailed)
+		{
+			continue;
+		}
+		// Prefetch into free space only; evicting is left to plays
+		if (device->cacheSize >= device->cacheBudget)
+		{
+			CArrayClear(&device->prefetchQueue);
+			continue;
+		}
+		device->prefetching = sc;
+		SDL_UnlockMutex(device->cacheMutex);
+		Mix_Chunk *decoded = Mix_LoadWAV(sc->path);
+		SDL_LockMutex(device->cacheMutex);
+		device->prefetching = NULL;
+		SoundChunkSetDecoded(device, sc, decoded);
+		SDL_CondBroadcast(device->prefetchCond);
+	}
+	SDL_UnlockMutex(device->cacheMutex);
+	return 0;
+}
+void SoundPrefetch(SoundDevice *device, Mix_Chunk *data)
+{
+	if (!device->isInitialised || data == NULL)
+	{
+		return;
+	}
+	SoundChunk *sc = (SoundChunk *)data;
+	SDL_LockMutex(device->cacheMutex);
+	if (sc->decoded == NULL && !sc->isFailed)
+	{
+		CArrayPushBack(&device->prefetchQueue, &sc);
+		SDL_CondBroadcast(device->prefetchCond);
+	}
+	SDL_UnlockMutex(device->cacheMutex);
+	if (device->prefetchThread == NULL)
+	{
+		device->prefetchThread = SDL_CreateThread(PrefetchLoop, device);
+		if (device->prefetchThread == NULL)
+		{
+			LOG(LM_SOUND, LL_ERROR, "cannot create prefetch thread: %s",
+				SDL_GetError());
+		}
+	}
+}
+// Drop queued prefetches and wait for the current one to finish
+static void PrefetchCancel(SoundDevice *device)
+{
+	if (device->cacheMutex == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(device->cacheMutex);
+	CArrayClear(&device->prefetchQueue);
+	while (device->prefetching != NULL)
+	{
+		SDL_CondWait(device->prefetchCond, device->cacheMutex);
+	}
+	SDL_UnlockMutex(device->cacheMutex);
 }
 
 #define OUT_OF_SIGHT_DISTANCE_PLUS 200
@@ -297,6 +565,10 @@ static void SoundPlayAtPosition(
 	{
 		return;
 	}
+	if (!SoundChunkLoad(device, (SoundChunk *)data))
+	{
+		return;
+	}
 
 	LOG(LM_SOUND, LL_TRACE, "distance(%d) bearing(%d)", distance, bearing);
 
@@ -326,6 +598,7 @@ static void SoundPlayAtPosition(
 			fprintf(stderr, "Mix_RegisterEffect: %s\n", Mix_GetError());
 		}
 	}
+	SoundCacheEvict(device);
 }
 
 void SoundPlay(SoundDevice *device, Mix_Chunk *data)
@@ -440,21 +713,43 @@ Mix_Chunk *StrSound(const char *s)
 	{
 		return NULL;
 	}
-	for (int i = 0; i < (int)gSoundDevice.customSounds.size; i++)
+	int i = NameMapGet(&gSoundDevice.customSoundsByName, s);
+	if (i >= 0)
 	{
-		SoundData *sound = CArrayGet(&gSoundDevice.customSounds, i);
-		if (strcmp(sound->Name, s) == 0)
-		{
-			return sound->data;
-		}
+		return ((SoundData *)CArrayGet(&gSoundDevice.customSounds, i))->data;
 	}
-	for (int i = 0; i < (int)gSoundDevice.sounds.size; i++)
+	i = NameMapGet(&gSoundDevice.soundsByName, s);
+	if (i >= 0)
 	{
-		SoundData *sound = CArrayGet(&gSoundDevice.sounds, i);
-		if (strcmp(sound->Name, s) == 0)
-		{
-			return sound->data;
-		}
+		return ((SoundData *)CArrayGet(&gSoundDevice.sounds, i))->data;
+	}
+	return NULL;
+}
+
+int StrSoundId(const char *s)
+{
+	if (s == NULL || strlen(s) == 0)
+	{
+		return -1;
+	}
+	const int i = NameMapGet(&gSoundDevice.customSoundsByName, s);
+	if (i >= 0)
+	{
+		return (int)gSoundDevice.sounds.size + i;
+	}
+	return NameMapGet(&gSoundDevice.soundsByName, s);
+}
+const SoundData *IdSoundData(const int id)
+{
+	if (id < 0) return NULL;
+	if (id < (int)gSoundDevice.sounds.size)
+	{
+		return CArrayGet(&gSoundDevice.sounds, id);
+	}
+	const int ci = id - (int)gSoundDevice.sounds.size;
+	if (ci < (int)gSoundDevice.customSounds.size)
+	{
+		return CArrayGet(&gSoundDevice.customSounds, ci);
 	}
 	return NULL;
 }
@@ -51,18 +51,23 @@
 #include <stdbool.h>
 
 #include <SDL_mixer.h>
+#include <SDL_thread.h>
 
 #include "c_array.h"
 #include "defs.h"
+#include "name_map.h"
 #include "sys_config.h"
 #include "utils.h"
 #include "vector.h"
 
+// Sounds are registered by path and decoded on first play or by prefetch;
+// data is a stable handle whose samples may be freed when not in use
 typedef struct
 {
 	char Name[CDOGS_FILENAME_MAX];
 	Mix_Chunk *data;
 } SoundData;
+struct SoundChunk;
 
 typedef enum
 {
@@ -88,6 +93,8 @@ typedef struct
 
 	CArray sounds;	// of SoundData
 	CArray customSounds;	// of SoundData
+	NameMap soundsByName;
+	NameMap customSoundsByName;
 
 	// Some commonly-used sounds, store them here for quick access
 	CArray footstepSounds;	// of Mix_Chunk *
@@ -98,6 +105,17 @@ typedef struct
 	Mix_Chunk *wreckSound;
 	CArray screamSounds;	// of Mix_Chunk *
 	int lastScream;
+
+	// Decoded sounds, least recently played are freed to stay under budget
+	size_t cacheSize;
+	size_t cacheBudget;
+	SDL_mutex *cacheMutex;
+	// Background decoding of sounds about to be used
+	SDL_Thread *prefetchThread;
+	SDL_cond *prefetchCond;
+	CArray prefetchQueue;	// of struct SoundChunk *
+	struct SoundChunk *prefetching;
+	bool prefetchQuit;
 } SoundDevice;
 
 extern SoundDevice gSoundDevice;
@@ -121,11 +139,14 @@ typedef struct
 } HitSounds;
 
 void SoundInitialize(SoundDevice *device, const char *path);
-void SoundAdd(CArray *sounds, const char *name, Mix_Chunk *data);
+// Register a sound file; it is not decoded until used
+void SoundAdd(CArray *sounds, const char *name, const char *path);
 void SoundReconfigure(SoundDevice *s);
-void SoundClear(CArray *sounds);
+void SoundClear(SoundDevice *device, CArray *sounds);
 void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete);
 void SoundPlay(SoundDevice *device, Mix_Chunk *data);
+// Decode a sound in the background if there is room in the cache
+void SoundPrefetch(SoundDevice *device, Mix_Chunk *data);
 void SoundSetEarsSide(const bool isLeft, const Vec2i pos);
 void SoundSetEar(const bool isLeft, const int idx, Vec2i pos);
 void SoundSetEars(Vec2i pos);
@@ -138,5 +159,8 @@ void SoundPlayAtPlusDistance(
 	const Vec2i pos, const int plusDistance);
 
 Mix_Chunk *StrSound(const char *s);
+// IDs of sounds, -1 for none; custom sounds follow the built-in ones
+int StrSoundId(const char *s);
+const SoundData *IdSoundData(const int id);
 Mix_Chunk *SoundGetRandomFootstep(SoundDevice *device);
 Mix_Chunk *SoundGetRandomScream(SoundDevice *device);
@@ -0,0 +1,191 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "thread_pool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <SDL_thread.h>
+
+#include "log.h"
+#include "utils.h"
+
+
+typedef struct
+{
+	ThreadPool *pool;
+	int index;
+	SDL_Thread *thread;
+} ThreadPoolWorker;
+
+int ThreadPoolNumCPUs(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	return MAX((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+#else
+	return 1;
+#endif
+}
+
+static void RunPart(const ThreadPool *p, const int index)
+{
+	const int numParts = (int)p->Workers.size + 1;
+	const int begin = (int)((long long)p->n * index / numParts);
+	const int end = (int)((long long)p->n * (index + 1) / numParts);
+	if (begin < end)
+	{
+		p->f(p->data, begin, end);
+	}
+}
+
+static int WorkerLoop(void *data)
+{
+	ThreadPoolWorker *w = data;
+	ThreadPool *p = w->pool;
+	int generation = 0;
+	for (;;)
+	{
+		SDL_LockMutex(p->mutex);
+		while (p->generation == generation && !p->quit)
+		{
+			SDL_CondWait(p->start, p->mutex);
+		}
+		if (p->quit)
+		{
+			SDL_UnlockMutex(p->mutex);
+			break;
+		}
+		generation = p->generation;
+		SDL_UnlockMutex(p->mutex);
+
+		RunPart(p, w->index);
+
+		SDL_LockMutex(p->mutex);
+		p->pending--;
+		if (p->pending == 0)
+		{
+			SDL_CondSignal(p->done);
+		}
+		SDL_UnlockMutex(p->mutex);
+	}
+	return 0;
+}
+
+void ThreadPoolInit(ThreadPool *p, const int numThreads)
+{
+	memset(p, 0, sizeof *p);
+	CArrayInit(&p->Workers, sizeof(ThreadPoolWorker));
+	const int numWorkers = numThreads - 1;
+	if (numWorkers <= 0)
+	{
+		return;
+	}
+	p->mutex = SDL_CreateMutex();
+	p->start = SDL_CreateCond();
+	p->done = SDL_CreateCond();
+	// Workers hold pointers into the array, so it must not reallocate
+	CArrayReserve(&p->Workers, numWorkers);
+	for (int i = 0; i < numWorkers; i++)
+	{
+		ThreadPoolWorker w;
+		w.pool = p;
+		w.index = i + 1;
+		w.thread = NULL;
+		CArrayPushBack(&p->Workers, &w);
+		ThreadPoolWorker *wp = CArrayGet(&p->Workers, i);
+		wp->thread = SDL_CreateThread(WorkerLoop, wp);
+		if (wp->thread == NULL)
+		{
+			LOG(LM_MAIN, LL_ERROR, "cannot create thread: %s",
+				SDL_GetError());
+			CArrayResize(&p->Workers, i, NULL);
+			break;
+		}
+	}
+}
+void ThreadPoolTerminate(ThreadPool *p)
+{
+	if (p->Workers.size > 0)
+	{
+		SDL_LockMutex(p->mutex);
+		p->quit = true;
+		SDL_CondBroadcast(p->start);
+		SDL_UnlockMutex(p->mutex);
+		CA_FOREACH(ThreadPoolWorker, w, p->Workers)
+			SDL_WaitThread(w->thread, NULL);
+		CA_FOREACH_END()
+	}
+	if (p->mutex != NULL)
+	{
+		SDL_DestroyCond(p->done);
+		SDL_DestroyCond(p->start);
+		SDL_DestroyMutex(p->mutex);
+	}
+	CArrayTerminate(&p->Workers);
+}
+
+int ThreadPoolNumThreads(const ThreadPool *p)
+{
+	return (int)p->Workers.size + 1;
+}
+
+void ThreadPoolRun(ThreadPool *p, ThreadPoolFunc f, void *data, const int n)
+{
+	if (p->Workers.size == 0)
+	{
+		if (n > 0)
+		{
+			f(data, 0, n);
+		}
+		return;
+	}
+	SDL_LockMutex(p->mutex);
+	p->f = f;
+	p->data = data;
+	p->n = n;
+	p->pending = (int)p->Workers.size;
+	p->generation++;
+	SDL_CondBroadcast(p->start);
+	SDL_UnlockMutex(p->mutex);
+
+	RunPart(p, 0);
+
+	SDL_LockMutex(p->mutex);
+	while (p->pending > 0)
+	{
+		SDL_CondWait(p->done, p->mutex);
+	}
+	SDL_UnlockMutex(p->mutex);
+}
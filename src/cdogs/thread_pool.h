@@ -0,0 +1,64 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_mutex.h>
+
+#include "c_array.h"
+
+// Runs a job over a range of items, split into one part per thread
+// The calling thread runs a part too; a pool of one thread runs jobs
+// inline without creating any threads.
+typedef void (*ThreadPoolFunc)(void *data, const int begin, const int end);
+
+typedef struct
+{
+	CArray Workers;	// of ThreadPoolWorker
+	SDL_mutex *mutex;
+	SDL_cond *start;
+	SDL_cond *done;
+	// Current job
+	ThreadPoolFunc f;
+	void *data;
+	int n;
+	int generation;
+	int pending;
+	bool quit;
+} ThreadPool;
+
+int ThreadPoolNumCPUs(void);
+
+// Create a pool that runs jobs on numThreads threads, including the caller's
+void ThreadPoolInit(ThreadPool *p, const int numThreads);
+void ThreadPoolTerminate(ThreadPool *p);
+int ThreadPoolNumThreads(const ThreadPool *p);
+
+// Run f over [0, n), returning once all parts are done
+void ThreadPoolRun(ThreadPool *p, ThreadPoolFunc f, void *data, const int n);
@@ -137,7 +137,7 @@ void TileSetAlternateFloor(Tile *t, NamedPic *p)
 }
 
 
-TTileItem *ThingIdGetTileItem(ThingId *tid)
+TTileItem *ThingIdGetTileItem(const ThingId *tid)
 {
 	TTileItem *ti = NULL;
 	switch (tid->Kind)
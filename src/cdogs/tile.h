@@ -77,9 +77,12 @@ typedef enum
 	MAPTILE_IS_NORMAL_FLOOR	= 0x0020,
 	MAPTILE_IS_DRAINAGE		= 0x0040,
 	MAPTILE_OFFSET_PIC		= 0x0080,
-// These constants are used internally in draw, it is never set in the map
+// These constants are only used for drawing; they depend on the tile below
+// and are set by MapSetupTileDrawFlags
+	// Wall drawn as part of the column of the wall below it
 	MAPTILE_DELAY_DRAW		= 0x0100,
-	MAPTILE_OUT_OF_SIGHT	= 0x0200
+	// Floor hidden behind the wall below it
+	MAPTILE_COVERED_BY_WALL	= 0x0200
 } MapTileFlags;
 
 typedef enum
@@ -172,5 +175,5 @@ bool TileIsClear(Tile *t);
 bool TileHasCharacter(Tile *t);
 void TileSetAlternateFloor(Tile *t, NamedPic *p);
 
-TTileItem *ThingIdGetTileItem(ThingId *tid);
+TTileItem *ThingIdGetTileItem(const ThingId *tid);
 bool TileItemIsDebris(const TTileItem *t);
@@ -193,7 +193,7 @@ static void ActionRun(Action *a, CArray *mapTriggers)
 		break;
 
 	case ACTION_EVENT:
-		GameEventsEnqueue(&gGameEvents, a->a.Event);
+		GameEventsEnqueue(&gGameEvents, &a->a.Event);
 		break;
 
 	case ACTION_ACTIVATEWATCH:
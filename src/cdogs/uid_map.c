@@ -0,0 +1,146 @@
+/*
+    C-Dogs SDL
+    A port of the legendary (and fun) action/arcade cdogs.
+    Copyright (c) 2016, Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "uid_map.h"
+
+#include <string.h>
+
+#include "utils.h"
+
+#define UID_MAP_MIN_SIZE 64
+
+typedef struct
+{
+	int UID;
+	int Index;	// -1 if empty
+} UIDMapEntry;
+
+
+static void Rehash(UIDMap *m, const int size);
+void UIDMapInit(UIDMap *m)
+{
+	memset(m, 0, sizeof *m);
+	CArrayInit(&m->Entries, sizeof(UIDMapEntry));
+	Rehash(m, UID_MAP_MIN_SIZE);
+}
+void UIDMapTerminate(UIDMap *m)
+{
+	CArrayTerminate(&m->Entries);
+	m->Count = 0;
+}
+// UIDs are allocated sequentially, so the identity hash spreads them
+// evenly over the table
+static int Slot(const UIDMap *m, const int uid)
+{
+	return (int)((unsigned)uid & (unsigned)(m->Entries.size - 1));
+}
+static UIDMapEntry *Find(const UIDMap *m, const int uid)
+{
+	UIDMapEntry *entries = m->Entries.data;
+	const int mask = (int)m->Entries.size - 1;
+	for (int i = Slot(m, uid);; i = (i + 1) & mask)
+	{
+		UIDMapEntry *e = &entries[i];
+		if (e->Index == -1 || e->UID == uid)
+		{
+			return e;
+		}
+	}
+}
+static void Rehash(UIDMap *m, const int size)
+{
+	CArray old = m->Entries;
+	CArrayInit(&m->Entries, sizeof(UIDMapEntry));
+	UIDMapEntry empty;
+	empty.UID = 0;
+	empty.Index = -1;
+	CArrayResize(&m->Entries, size, &empty);
+	CA_FOREACH(const UIDMapEntry, e, old)
+		if (e->Index != -1)
+		{
+			*Find(m, e->UID) = *e;
+		}
+	CA_FOREACH_END()
+	CArrayTerminate(&old);
+}
+
+void UIDMapSet(UIDMap *m, const int uid, const int index)
+{
+	CASSERT(index >= 0, "invalid UID map index");
+	// Keep the load factor at most 1/2
+	if ((m->Count + 1) * 2 > (int)m->Entries.size)
+	{
+		Rehash(m, (int)m->Entries.size * 2);
+	}
+	UIDMapEntry *e = Find(m, uid);
+	if (e->Index == -1)
+	{
+		m->Count++;
+	}
+	e->UID = uid;
+	e->Index = index;
+}
+
+void UIDMapRemove(UIDMap *m, const int uid, const int index)
+{
+	if (m->Entries.size == 0)
+	{
+		return;
+	}
+	UIDMapEntry *entries = m->Entries.data;
+	const int mask = (int)m->Entries.size - 1;
+	UIDMapEntry *e = Find(m, uid);
+	if (e->Index != index || index == -1)
+	{
+		return;
+	}
+	e->Index = -1;
+	m->Count--;
+	// Shift back any following entries in the probe run, so there are no
+	// gaps between them and their home slots
+	int hole = (int)(e - entries);
+	for (int i = (hole + 1) & mask; entries[i].Index != -1; i = (i + 1) & mask)
+	{
+		const int home = Slot(m, entries[i].UID);
+		// Move the entry if its home slot is not between the hole and it
+		if (((i - home) & mask) >= ((i - hole) & mask))
+		{
+			entries[hole] = entries[i];
+			entries[i].Index = -1;
+			hole = i;
+		}
+	}
+}
+
+int UIDMapGet(const UIDMap *m, const int uid)
+{
+	if (m->Entries.size == 0)
+	{
+		return -1;
+	}
+	return Find(m, uid)->Index;
+}
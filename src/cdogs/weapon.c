@@ -57,10 +57,13 @@
 #include "config.h"
 #include "game_events.h"
 #include "json_utils.h"
+#include "net_assets.h"
 #include "net_util.h"
 #include "objs.h"
 #include "sounds.h"
 
+static ConfigHandle sConfigReloads = CONFIG_HANDLE("Sound.Reloads");
+
 GunClasses gGunDescriptions;
 
 const TOffsetPic cGunPics[GUNPIC_COUNT][DIRECTION_COUNT][GUNSTATE_COUNT] = {
@@ -106,6 +109,9 @@ void WeaponInitialize(GunClasses *g)
 	memset(g, 0, sizeof *g);
 	CArrayInit(&g->Guns, sizeof(const GunDescription));
 	CArrayInit(&g->CustomGuns, sizeof(const GunDescription));
+	NAME_MAP_INIT(&g->GunsByName, &g->Guns, GunDescription, name, true);
+	NAME_MAP_INIT(
+		&g->CustomGunsByName, &g->CustomGuns, GunDescription, name, true);
 }
 static void LoadGunDescription(
 	GunDescription *g, json_t *node, const GunDescription *defaultGun);
@@ -280,6 +286,8 @@ void WeaponTerminate(GunClasses *g)
 	CArrayTerminate(&g->Guns);
 	WeaponClassesClear(&g->CustomGuns);
 	CArrayTerminate(&g->CustomGuns);
+	NameMapTerminate(&g->GunsByName);
+	NameMapTerminate(&g->CustomGunsByName);
 }
 void WeaponClassesClear(CArray *classes)
 {
@@ -304,25 +312,17 @@ Weapon WeaponCreate(const GunDescription *gun)
 	return w;
 }
 
-// TODO: use map structure?
 const GunDescription *StrGunDescription(const char *s)
 {
-	for (int i = 0; i < (int)gGunDescriptions.Guns.size; i++)
+	int i = NameMapGet(&gGunDescriptions.GunsByName, s);
+	if (i >= 0)
 	{
-		const GunDescription *gd = CArrayGet(&gGunDescriptions.Guns, i);
-		if (strcmp(s, gd->name) == 0)
-		{
-			return gd;
-		}
+		return CArrayGet(&gGunDescriptions.Guns, i);
 	}
-	for (int i = 0; i < (int)gGunDescriptions.CustomGuns.size; i++)
+	i = NameMapGet(&gGunDescriptions.CustomGunsByName, s);
+	if (i >= 0)
 	{
-		const GunDescription *gd =
-			CArrayGet(&gGunDescriptions.CustomGuns, i);
-		if (strcmp(s, gd->name) == 0)
-		{
-			return gd;
-		}
+		return CArrayGet(&gGunDescriptions.CustomGuns, i);
 	}
 	fprintf(stderr, "Cannot parse gun name: %s\n", s);
 	return NULL;
@@ -343,25 +343,12 @@ GunDescription *IdGunDescription(const int i)
 }
 int GunDescriptionId(const GunDescription *g)
 {
-	int idx = 0;
-	for (int i = 0; i < (int)gGunDescriptions.Guns.size; i++, idx++)
-	{
-		const GunDescription *c = CArrayGet(&gGunDescriptions.Guns, i);
-		if (c == g)
-		{
-			return idx;
-		}
-	}
-	for (int i = 0; i < (int)gGunDescriptions.CustomGuns.size; i++, idx++)
-	{
-		const GunDescription *c = CArrayGet(&gGunDescriptions.CustomGuns, i);
-		if (c == g)
-		{
-			return idx;
-		}
-	}
-	CASSERT(false, "cannot find gun");
-	return -1;
+	const int i = CArrayIndexOf(&gGunDescriptions.Guns, g);
+	if (i >= 0) return i;
+	const int ci = CArrayIndexOf(&gGunDescriptions.CustomGuns, g);
+	CASSERT(ci >= 0, "cannot find gun");
+	if (ci < 0) return -1;
+	return (int)gGunDescriptions.Guns.size + ci;
 }
 
 void WeaponUpdate(
@@ -369,7 +356,7 @@ void WeaponUpdate(
 	const int playerUID)
 {
 	// Reload sound
-	if (ConfigGetBool(&gConfig, "Sound.Reloads") &&
+	if (ConfigHandleGetBool(&sConfigReloads) &&
 		w->lock > w->Gun->ReloadLead &&
 		w->lock - ticks <= w->Gun->ReloadLead &&
 		w->lock > 0 &&
@@ -377,10 +364,10 @@ void WeaponUpdate(
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_GUN_RELOAD);
 		e.u.GunReload.PlayerUID = playerUID;
-		strcpy(e.u.GunReload.Gun, w->Gun->name);
+		e.u.GunReload.GunId = NetAssetsGunId(w->Gun);
 		e.u.GunReload.FullPos = Vec2i2Net(fullPos);
 		e.u.GunReload.Direction = (int)d;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	w->lock -= ticks;
 	if (w->lock < 0)
@@ -421,7 +408,7 @@ void WeaponFire(
 		GameEvent e = GameEventNew(GAME_EVENT_GUN_STATE);
 		e.u.GunState.ActorUID = uid;
 		e.u.GunState.State = GUNSTATE_FIRING;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	if (!w->Gun->CanShoot)
 	{
@@ -452,14 +439,14 @@ void GunFire(
 	GameEvent e = GameEventNew(GAME_EVENT_GUN_FIRE);
 	e.u.GunFire.UID = uid;
 	e.u.GunFire.PlayerUID = playerUID;
-	strcpy(e.u.GunFire.Gun, g->name);
+	e.u.GunFire.GunId = NetAssetsGunId(g);
 	e.u.GunFire.MuzzleFullPos = Vec2i2Net(fullPos);
 	e.u.GunFire.Z = z;
 	e.u.GunFire.Angle = (float)radians;
 	e.u.GunFire.Sound = playSound;
 	e.u.GunFire.Flags = flags;
 	e.u.GunFire.IsGun = isGun;
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 void GunAddBrass(
@@ -484,7 +471,7 @@ void GunAddBrass(
 	e.u.AddParticle.Angle = RAND_DOUBLE(0, PI * 2);
 	e.u.AddParticle.DZ = (rand() % 6) + 6;
 	e.u.AddParticle.Spin = RAND_DOUBLE(-0.1, 0.1);
-	GameEventsEnqueue(&gGameEvents, e);
+	GameEventsEnqueue(&gGameEvents, &e);
 }
 
 Vec2i GunGetMuzzleOffset(const GunDescription *desc, const direction_e dir)
@@ -50,6 +50,7 @@
 
 #include "bullet_class.h"
 #include "defs.h"
+#include "name_map.h"
 #include "pic.h"
 #include "pics.h"
 #include "sounds.h"
@@ -132,6 +133,8 @@ typedef struct
 	CArray Guns;	// of GunDescription
 	GunDescription Default;
 	CArray CustomGuns;	// of GunDescription
+	NameMap GunsByName;
+	NameMap CustomGunsByName;
 } GunClasses;
 
 typedef struct
@@ -1303,7 +1303,7 @@ int main(int argc, char *argv[])
 	GetDataFilePath(buf2, "graphics/font.json");
 	FontLoad(&gFont, buf, buf2);
 	GetDataFilePath(buf, "graphics");
-	PicManagerLoadDir(&gPicManager, buf);
+	PicManagerLoadDir(&gPicManager, buf, GetConfigFilePath(PIC_CACHE_FILE));
 
 	GetDataFilePath(buf, "data/particles.json");
 	ParticleClassesInit(&gParticleClasses, buf);
@@ -102,7 +102,7 @@ static void PlayerSpecialCommands(TActor *actor, const int cmd)
 		GameEvent e = GameEventNew(GAME_EVENT_ACTOR_SWITCH_GUN);
 		e.u.ActorSwitchGun.UID = actor->uid;
 		e.u.ActorSwitchGun.GunIdx = (actor->gunIndex + 1) % actor->guns.size;
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 
@@ -195,7 +195,7 @@ bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 			if (!p->IsLocal) continue;
 			GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
 			e.u.PlayerData = PlayerDataMissionReset(p);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 		// Process the events to force add the players
 		HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
@@ -251,7 +251,7 @@ bool RunGame(const CampaignOptions *co, struct MissionOptions *m, Map *map)
 
 	NetServerSendGameStartMessages(&gNetServer, NET_SERVER_BCAST);
 	GameEvent start = GameEventNew(GAME_EVENT_GAME_START);
-	GameEventsEnqueue(&gGameEvents, start);
+	GameEventsEnqueue(&gGameEvents, &start);
 
 	// Set mission complete and display exit if it is complete
 	MissionSetMessageIfComplete(m);
@@ -286,7 +286,7 @@ static void RunGameInput(void *data)
 	if (gEventHandlers.HasQuit)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 		return;
 	}
 
@@ -345,7 +345,7 @@ static void RunGameInput(void *data)
 		{
 			// Exit
 			GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 			// Need to unpause to process the quit
 			rData->pausingDevice = INPUT_DEVICE_UNSET;
 		}
@@ -456,7 +456,7 @@ static GameLoopResult RunGameUpdate(void *data)
 				ei.u.ActorImpulse.UID = p->uid;
 				ei.u.ActorImpulse.Vel = Vec2i2Net(Vec2iScale(vel, 64));
 				ei.u.ActorImpulse.Pos = Vec2i2Net(Vec2iZero());
-				GameEventsEnqueue(&gGameEvents, ei);
+				GameEventsEnqueue(&gGameEvents, &ei);
 			}
 		}
 	}
@@ -509,7 +509,7 @@ static void CheckMissionCompletion(const struct MissionOptions *mo)
 			GameEvent e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
 			e.u.ObjectiveUpdate.ObjectiveId = i;
 			e.u.ObjectiveUpdate.Count = update;
-			GameEventsEnqueue(&gGameEvents, e);
+			GameEventsEnqueue(&gGameEvents, &e);
 		}
 	}
 
@@ -518,18 +518,18 @@ static void CheckMissionCompletion(const struct MissionOptions *mo)
 	if (mo->state == MISSION_STATE_PLAY && isMissionComplete)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_PICKUP);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	if (mo->state == MISSION_STATE_PICKUP && !isMissionComplete)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_INCOMPLETE);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 	if (mo->state == MISSION_STATE_PICKUP &&
 		mo->pickupTime + PICKUP_LIMIT <= mo->time)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 
 	// Check that all players have been destroyed
@@ -548,7 +548,7 @@ static void CheckMissionCompletion(const struct MissionOptions *mo)
 	if (allPlayersDestroyed && AreAllPlayersDeadAndNoLives())
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
-		GameEventsEnqueue(&gGameEvents, e);
+		GameEventsEnqueue(&gGameEvents, &e);
 	}
 }
 static void RunGameDraw(void *data)
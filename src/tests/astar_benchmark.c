@@ -0,0 +1,320 @@
+// Microbenchmark comparing the generic A* engine against the grid A*,
+// with and without jump point search, over the shipped missions
+// Not run as part of the test suite; run manually:
+//   astar_benchmark [queries] [campaign...]
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <AStar.h>
+#include <astar_grid.h>
+#include <campaigns.h>
+#include <config.h>
+#include <floor_cache.h>
+#include <game_events.h>
+#include <gamedata.h>
+#include <map.h>
+#include <map_classic.h>
+#include <map_new.h>
+#include <map_static.h>
+#include <pic_manager.h>
+#include <utils.h>
+
+
+// Campaigns with custom graphics need the graphics device to load,
+// so only those without are benchmarked by default
+static const char *cCampaigns[] =
+{
+	"missions/bem.cdogscpn",
+	"missions/ogre.cdogscpn",
+	"missions/distress.cpn",
+	"missions/Sand.cpn",
+	"missions/terror.cpn",
+	"dogfights/cubicle.cdogscpn",
+	"dogfights/de_dust.cdogscpn",
+	"dogfights/dungeon.cdogscpn",
+	NULL
+};
+
+static bool IsTileOk(Map *map, Vec2i pos)
+{
+	return !(MapGetTile(map, pos)->flags & MAPTILE_NO_WALK);
+}
+
+// Set up the mission layout and tile walkability only, like MapLoad
+// but without the pics
+static void LoadMap(Map *map, Mission *m, const CampaignOptions *co)
+{
+	memset(map, 0, sizeof *map);
+	CArrayInit(&map->Tiles, sizeof(Tile));
+	CArrayInit(&map->iMap, sizeof(unsigned short));
+	CArrayInit(&map->CollisionCells, sizeof(CArray));
+	CArrayInit(&map->triggers, sizeof(Trigger *));
+	map->Size = m->Size;
+	FloorCacheInit(&map->FloorCache, map->Size);
+	for (int i = 0; i < map->Size.x * map->Size.y; i++)
+	{
+		Tile t;
+		TileInit(&t);
+		CArrayPushBack(&map->Tiles, &t);
+		const unsigned short tI = MAP_FLOOR;
+		CArrayPushBack(&map->iMap, &tI);
+		CArray cell;
+		CArrayInit(&cell, sizeof(CollisionProxy));
+		CArrayPushBack(&map->CollisionCells, &cell);
+	}
+	if (m->Type == MAPTYPE_CLASSIC)
+	{
+		MapClassicLoad(map, m, co);
+	}
+	else
+	{
+		struct MissionOptions mo;
+		MissionOptionsInit(&mo);
+		mo.missionData = m;
+		MapStaticLoad(map, &mo);
+	}
+	// Doors count as open
+	Vec2i v;
+	for (v.y = 0; v.y < map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < map->Size.x; v.x++)
+		{
+			const unsigned short tI = IMapGet(map, v) & MAP_MASKACCESS;
+			if (tI == MAP_WALL || tI == MAP_NOTHING)
+			{
+				MapGetTile(map, v)->flags |= MAPTILE_NO_WALK;
+			}
+		}
+	}
+}
+
+// Count node expansions of the generic engine through its neighbour callback
+static int sGenericExpanded;
+static void AddTileNeighbors(
+	ASNeighborList neighbors, void *node, void *context)
+{
+	const Vec2i *v = node;
+	Map *map = context;
+	sGenericExpanded++;
+	for (int y = v->y - 1; y <= v->y + 1; y++)
+	{
+		for (int x = v->x - 1; x <= v->x + 1; x++)
+		{
+			Vec2i neighbor = Vec2iNew(x, y);
+			if ((x == v->x && y == v->y) || !MapIsTileIn(map, neighbor) ||
+				!IsTileOk(map, neighbor) ||
+				!IsTileOk(map, Vec2iNew(v->x, y)) ||
+				!IsTileOk(map, Vec2iNew(x, v->y)))
+			{
+				continue;
+			}
+			float cost;
+			if (x != v->x && y != v->y)
+			{
+				cost = TILE_WIDTH * 1.1f;
+			}
+			else if (x != v->x)
+			{
+				cost = TILE_WIDTH;
+			}
+			else
+			{
+				cost = TILE_HEIGHT;
+			}
+			ASNeighborListAdd(neighbors, &neighbor, cost);
+		}
+	}
+}
+static float AStarHeuristic(void *fromNode, void *toNode, void *context)
+{
+	const Vec2i *v1 = fromNode;
+	const Vec2i *v2 = toNode;
+	UNUSED(context);
+	return (float)sqrt(DistanceSquared(
+		Vec2iCenterOfTile(*v1), Vec2iCenterOfTile(*v2)));
+}
+static ASPathNodeSource cNodeSource =
+{
+	sizeof(Vec2i), AddTileNeighbors, AStarHeuristic, NULL, NULL
+};
+
+typedef struct
+{
+	double us;
+	long long expanded;
+	int found;
+} Result;
+typedef enum
+{
+	SEARCH_GENERIC,
+	SEARCH_GRID,
+	SEARCH_JPS,
+	SEARCH_COUNT
+} SearchType;
+static const char *cSearchNames[] = { "generic", "grid", "grid+jps" };
+
+static void RunQueries(
+	Map *map, AStarGrid *grid, const Vec2i *queries, const int count,
+	Result results[SEARCH_COUNT], int *cheaper, int *mismatches)
+{
+	for (int i = 0; i < count; i++)
+	{
+		Vec2i from = queries[i * 2];
+		Vec2i to = queries[i * 2 + 1];
+		float costs[SEARCH_COUNT];
+		for (SearchType s = SEARCH_GENERIC; s < SEARCH_COUNT; s++)
+		{
+			Result *r = &results[s];
+			sGenericExpanded = 0;
+			const clock_t start = clock();
+			ASPath path;
+			if (s == SEARCH_GENERIC)
+			{
+				path = ASPathCreate(&cNodeSource, map, &from, &to);
+			}
+			else
+			{
+				path = AStarGridFindPath(
+					grid, from, to, IsTileOk, s == SEARCH_JPS);
+			}
+			r->us += (double)(clock() - start) * 1000000.0 / CLOCKS_PER_SEC;
+			r->expanded +=
+				s == SEARCH_GENERIC ? sGenericExpanded : grid->Expanded;
+			costs[s] = path != NULL ? ASPathGetCost(path) : -1;
+			r->found += path != NULL ? 1 : 0;
+			ASPathDestroy(path);
+		}
+		// The generic engine's Euclidean heuristic can overestimate, so it
+		// sometimes finds more expensive paths than the grid searches
+		for (SearchType s = SEARCH_GRID; s < SEARCH_COUNT; s++)
+		{
+			if (costs[s] < costs[SEARCH_GENERIC] - 0.01f &&
+				costs[s] >= 0)
+			{
+				(*cheaper)++;
+			}
+			else if (fabsf(costs[s] - costs[SEARCH_GENERIC]) > 0.01f)
+			{
+				(*mismatches)++;
+			}
+		}
+	}
+}
+
+static void RunCampaign(
+	const char *filename, const int numQueries, Result results[SEARCH_COUNT],
+	int *numQueriesRun, int *cheaper, int *mismatches)
+{
+	CampaignSetting setting;
+	CampaignSettingInit(&setting);
+	if (MapNewLoad(filename, &setting))
+	{
+		printf("%s: failed to load\n", filename);
+		return;
+	}
+	CampaignOptions co;
+	memset(&co, 0, sizeof co);
+	co.Setting = setting;
+	CA_FOREACH(Mission, m, setting.Missions)
+		Map map;
+		LoadMap(&map, m, &co);
+		CArray walkable;
+		CArrayInit(&walkable, sizeof(Vec2i));
+		Vec2i v;
+		for (v.y = 0; v.y < map.Size.y; v.y++)
+		{
+			for (v.x = 0; v.x < map.Size.x; v.x++)
+			{
+				if (IsTileOk(&map, v))
+				{
+					CArrayPushBack(&walkable, &v);
+				}
+			}
+		}
+		if (walkable.size > 0)
+		{
+			Vec2i *queries;
+			CMALLOC(queries, numQueries * 2 * sizeof *queries);
+			for (int j = 0; j < numQueries * 2; j++)
+			{
+				queries[j] = *(Vec2i *)CArrayGet(
+					&walkable, rand() % (int)walkable.size);
+			}
+			AStarGrid grid;
+			AStarGridInit(&grid, &map);
+			RunQueries(
+				&map, &grid, queries, numQueries, results, cheaper, mismatches);
+			*numQueriesRun += numQueries;
+			AStarGridTerminate(&grid);
+			CFREE(queries);
+		}
+		CArrayTerminate(&walkable);
+		MapTerminate(&map);
+	CA_FOREACH_END()
+	CampaignSettingTerminate(&setting);
+}
+
+int main(int argc, char *argv[])
+{
+	const int numQueries = argc > 1 ? atoi(argv[1]) : 200;
+	gConfig = ConfigDefault();
+	GameEventsInit(&gGameEvents);
+	srand(1);
+	// Campaigns clear any custom pics they loaded
+	if (!PicManagerTryInit(
+		&gPicManager, "graphics/cdogs.px", "graphics/cdogs2.px"))
+	{
+		return 1;
+	}
+
+	printf("%-34s %-9s %10s %12s %8s\n",
+		"campaign", "search", "us/query", "nodes/query", "found");
+	for (int i = 0; argc > 2 ? i < argc - 2 : cCampaigns[i] != NULL; i++)
+	{
+		char filename[CDOGS_PATH_MAX];
+		if (argc > 2)
+		{
+			strcpy(filename, argv[i + 2]);
+		}
+		else
+		{
+			GetDataFilePath(filename, cCampaigns[i]);
+		}
+		Result results[SEARCH_COUNT];
+		memset(results, 0, sizeof results);
+		int numQueriesRun = 0;
+		int cheaper = 0;
+		int mismatches = 0;
+		RunCampaign(
+			filename, numQueries, results, &numQueriesRun, &cheaper,
+			&mismatches);
+		if (numQueriesRun == 0)
+		{
+			continue;
+		}
+		for (SearchType s = SEARCH_GENERIC; s < SEARCH_COUNT; s++)
+		{
+			printf("%-34s %-9s %10.2f %12.1f %8d\n",
+				s == SEARCH_GENERIC ? PathGetBasename(filename) : "",
+				cSearchNames[s],
+				results[s].us / numQueriesRun,
+				(double)results[s].expanded / numQueriesRun,
+				results[s].found);
+		}
+		if (cheaper > 0)
+		{
+			printf("  %d paths cheaper than the generic engine\n", cheaper);
+		}
+		if (mismatches > 0)
+		{
+			printf("  %d paths WORSE than the generic engine\n", mismatches);
+		}
+	}
+
+	PicManagerTerminate(&gPicManager);
+	GameEventsTerminate(&gGameEvents);
+	ConfigDestroy(&gConfig);
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Microbenchmark comparing scalar and SIMD blit row kernels
+// Not run as part of the test suite; run manually:
+//   blit_benchmark [iterations]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <blit_kernels.h>
+
+
+// Typical sprite widths, plus a full screen row
+static const int sWidths[] = { 8, 16, 32, 320 };
+#define MAX_WIDTH 320
+
+typedef void (*MultFunc)(
+	Uint32 *, const Uint32 *, const int, const Uint32, const bool);
+typedef void (*BlendFunc)(
+	Uint32 *, const Uint32 *, const int, const Uint32, const Uint8,
+	const Uint32);
+
+static Uint32 sSrc[MAX_WIDTH];
+static Uint32 sDst[MAX_WIDTH];
+
+// Returns megapixels per second
+static double RunMult(const MultFunc f, const int n, const int iterations)
+{
+	const clock_t start = clock();
+	for (int i = 0; i < iterations; i++)
+	{
+		f(sDst, sSrc, n, 0xFF80C0FF - (Uint32)i, true);
+	}
+	return (double)n * iterations / 1000000.0 /
+		((double)(clock() - start) / CLOCKS_PER_SEC);
+}
+static double RunBlend(const BlendFunc f, const int n, const int iterations)
+{
+	const clock_t start = clock();
+	for (int i = 0; i < iterations; i++)
+	{
+		f(sDst, sSrc, n, 0xFF80C0FF - (Uint32)i, (Uint8)i, 0xFF000000);
+	}
+	return (double)n * iterations / 1000000.0 /
+		((double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+int main(int argc, char *argv[])
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+	srand(1);
+	for (int i = 0; i < MAX_WIDTH; i++)
+	{
+		sSrc[i] = rand() % 4 == 0 ? 0 : (Uint32)rand();
+		sDst[i] = (Uint32)rand();
+	}
+
+	printf("%-6s %12s %12s %12s %12s\n",
+		"width", "mult (Mp/s)", "simd", "blend (Mp/s)", "simd");
+	for (int i = 0; i < (int)(sizeof sWidths / sizeof sWidths[0]); i++)
+	{
+		const int n = sWidths[i];
+		const int its = iterations * 8 / n;
+		const double mult = RunMult(BlitRowMultScalar, n, its);
+		const double multSIMD = RunMult(BlitRowMult, n, its);
+		const double blend = RunBlend(BlitRowBlendScalar, n, its);
+		const double blendSIMD = RunBlend(BlitRowBlend, n, its);
+		printf("%-6d %12.1f %12.1f %12.1f %12.1f\n",
+			n, mult, multSIMD, blend, blendSIMD);
+	}
+	// Use the output so the kernels aren't optimised away
+	Uint32 sum = 0;
+	for (int i = 0; i < MAX_WIDTH; i++) sum += sDst[i];
+	printf("(checksum %08x)\n", sum);
+	return 0;
+}
@@ -0,0 +1,178 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <blit_kernels.h>
+
+#include <SDL_joystick.h>
+
+#include <color.h>
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+#define ROW_LEN 67
+#define A_MASK 0xFF000000
+
+static Uint32 ToPixel(const color_t c)
+{
+	return c.r | (c.g << 8) | (c.b << 16) | ((Uint32)c.a << 24);
+}
+static color_t ToColor(const Uint32 p)
+{
+	color_t c;
+	c.r = (uint8_t)p;
+	c.g = (uint8_t)(p >> 8);
+	c.b = (uint8_t)(p >> 16);
+	c.a = (uint8_t)(p >> 24);
+	return c;
+}
+static void RandomRow(Uint32 *row)
+{
+	for (int i = 0; i < ROW_LEN; i++)
+	{
+		// Include plenty of zero (transparent) pixels
+		row[i] = rand() % 4 == 0 ? 0 : (Uint32)rand() ^ ((Uint32)rand() << 16);
+	}
+}
+static bool RowsEqual(const Uint32 *a, const Uint32 *b, const int n)
+{
+	return memcmp(a, b, n * sizeof *a) == 0;
+}
+
+
+FEATURE(1, "Masked blit")
+	SCENARIO("Masked rows match the scalar kernel")
+	{
+		Uint32 src[ROW_LEN], dst[ROW_LEN], expected[ROW_LEN];
+		bool equal = true;
+		GIVEN("random rows and masks")
+		GIVEN_END
+
+		WHEN("I blit them, for every row length")
+			for (int n = 0; n <= ROW_LEN && equal; n++)
+			{
+				RandomRow(src);
+				RandomRow(dst);
+				memcpy(expected, dst, sizeof dst);
+				const Uint32 mask = (Uint32)rand() ^ ((Uint32)rand() << 16);
+				const bool isTransparent = n % 2 == 0;
+				BlitRowMult(dst, src, n, mask, isTransparent);
+				BlitRowMultScalar(expected, src, n, mask, isTransparent);
+				equal = RowsEqual(dst, expected, ROW_LEN);
+			}
+		WHEN_END
+
+		THEN("the results should be identical");
+			SHOULD_BE_TRUE(equal);
+		THEN_END
+	}
+	SCENARIO_END
+
+	SCENARIO("Masked pixels are tinted")
+	{
+		Uint32 src[ROW_LEN], dst[ROW_LEN];
+		color_t mask;
+		GIVEN("a random row and mask")
+			RandomRow(src);
+			memset(dst, 0, sizeof dst);
+			mask = ToColor((Uint32)rand() ^ ((Uint32)rand() << 16));
+		GIVEN_END
+
+		WHEN("I blit them")
+			BlitRowMult(dst, src, ROW_LEN, ToPixel(mask), false);
+		WHEN_END
+
+		THEN("the pixels should be the colours multiplied by the mask");
+			bool equal = true;
+			for (int i = 0; i < ROW_LEN; i++)
+			{
+				color_t c = ColorMult(ToColor(src[i]), mask);
+				c.a = (uint8_t)(ToColor(src[i]).a * mask.a / 255);
+				equal = equal && dst[i] == ToPixel(c);
+			}
+			SHOULD_BE_TRUE(equal);
+		THEN_END
+	}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(2, "Blended blit")
+	SCENARIO("Blended rows match the scalar kernel")
+	{
+		Uint32 src[ROW_LEN], dst[ROW_LEN], expected[ROW_LEN];
+		bool equal = true;
+		GIVEN("random rows and blend colours")
+		GIVEN_END
+
+		WHEN("I blit them, for every row length")
+			for (int n = 0; n <= ROW_LEN && equal; n++)
+			{
+				RandomRow(src);
+				RandomRow(dst);
+				memcpy(expected, dst, sizeof dst);
+				const Uint32 blend = (Uint32)rand() ^ ((Uint32)rand() << 16);
+				const Uint8 alpha = (Uint8)(n == 0 ? 255 : rand());
+				BlitRowBlend(dst, src, n, blend, alpha, A_MASK);
+				BlitRowBlendScalar(expected, src, n, blend, alpha, A_MASK);
+				equal = RowsEqual(dst, expected, ROW_LEN);
+			}
+		WHEN_END
+
+		THEN("the results should be identical");
+			SHOULD_BE_TRUE(equal);
+		THEN_END
+	}
+	SCENARIO_END
+
+	SCENARIO("Blended pixels are tinted and alpha blended")
+	{
+		Uint32 src[ROW_LEN], dst[ROW_LEN], orig[ROW_LEN];
+		color_t blend;
+		GIVEN("random rows and a blend colour")
+			RandomRow(src);
+			RandomRow(dst);
+			memcpy(orig, dst, sizeof dst);
+			blend = ToColor((Uint32)rand() ^ ((Uint32)rand() << 16));
+		GIVEN_END
+
+		WHEN("I blit them")
+			BlitRowBlend(
+				dst, src, ROW_LEN, ToPixel(blend), blend.a, A_MASK);
+		WHEN_END
+
+		THEN("the non-transparent pixels should be blended");
+			bool equal = true;
+			for (int i = 0; i < ROW_LEN; i++)
+			{
+				Uint32 expected = orig[i];
+				if (src[i] != 0)
+				{
+					color_t c = ColorMult(ToColor(src[i]), blend);
+					c.a = blend.a;
+					expected = ToPixel(ColorAlphaBlend(ToColor(orig[i]), c));
+				}
+				equal = equal && dst[i] == expected;
+			}
+			SHOULD_BE_TRUE(equal);
+		THEN_END
+	}
+	SCENARIO_END
+FEATURE_END
+
+int main(void)
+{
+	cbehave_feature features[] =
+	{
+		{feature_idx(1)},
+		{feature_idx(2)}
+	};
+
+	return cbehave_runner("Blit kernels features are:", features);
+}
@@ -0,0 +1,178 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <blit_scale.h>
+#include <hqx/hqx.h>
+#include <thread_pool.h>
+
+#include <SDL_joystick.h>
+
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+#define W 37
+#define H 29
+#define BAND_ROWS 5
+
+typedef struct
+{
+	Uint32 *dst;
+	Uint32 *src;
+	int scale;
+	ScaleMode mode;
+} ScaleJob;
+static void ScaleBand(void *data, const int begin, const int end)
+{
+	const ScaleJob *job = data;
+	BlitScaleRows(
+		job->dst, job->src, Vec2iNew(W, H), job->scale, job->mode,
+		begin, end);
+}
+
+static void RandomImage(Uint32 *src)
+{
+	for (int i = 0; i < W * H; i++)
+	{
+		// Few colours so that hqx finds plenty of edges
+		src[i] = (rand() % 4) * 0x00402010 | 0xFF000000;
+	}
+}
+
+// Scale in bands, both threaded and in fixed-size pieces, and compare with
+// scaling the whole image at once
+static bool BandsMatchWhole(
+	Uint32 *src, const int scale, const ScaleMode mode, ThreadPool *pool)
+{
+	const size_t size = W * H * scale * scale * sizeof(Uint32);
+	Uint32 *whole = malloc(size);
+	Uint32 *threaded = malloc(size);
+	Uint32 *pieces = malloc(size);
+	memset(whole, 0, size);
+	memset(threaded, 0, size);
+	memset(pieces, 0, size);
+	BlitScaleRows(whole, src, Vec2iNew(W, H), scale, mode, 0, H);
+	ScaleJob job = { threaded, src, scale, mode };
+	ThreadPoolRun(pool, ScaleBand, &job, H);
+	for (int y = 0; y < H; y += BAND_ROWS)
+	{
+		BlitScaleRows(
+			pieces, src, Vec2iNew(W, H), scale, mode, y, MIN(y + BAND_ROWS, H));
+	}
+	const bool equal =
+		memcmp(whole, threaded, size) == 0 && memcmp(whole, pieces, size) == 0;
+	free(whole);
+	free(threaded);
+	free(pieces);
+	return equal;
+}
+
+
+FEATURE(1, "Banded scaling")
+	SCENARIO("Scale in bands")
+	{
+		Uint32 src[W * H];
+		ThreadPool pool;
+		bool equal = true;
+		GIVEN("a random image")
+			RandomImage(src);
+			ThreadPoolInit(&pool, 4);
+			hqxInit();
+		GIVEN_END
+
+		WHEN("I scale it in bands, with every mode and scale")
+			for (ScaleMode mode = SCALE_MODE_NN; mode <= SCALE_MODE_HQX; mode++)
+			{
+				for (int scale = 1; scale <= 4; scale++)
+				{
+					equal = equal && BandsMatchWhole(src, scale, mode, &pool);
+				}
+			}
+		WHEN_END
+
+		THEN("the result should be the same as scaling the whole image");
+			SHOULD_BE_TRUE(equal);
+		THEN_END
+		ThreadPoolTerminate(&pool);
+	}
+	SCENARIO_END
+
+	SCENARIO("Scale with hqx")
+	{
+		Uint32 src[W * H];
+		Uint32 expected[W * H * 16], actual[W * H * 16];
+		bool equal = true;
+		GIVEN("a random image")
+			RandomImage(src);
+		GIVEN_END
+
+		WHEN("I scale it in bands with hqx")
+			for (int scale = 2; scale <= 4; scale++)
+			{
+				const size_t size = W * H * scale * scale * sizeof(Uint32);
+				switch (scale)
+				{
+				case 2: hq2x_32(src, expected, W, H); break;
+				case 3: hq3x_32(src, expected, W, H); break;
+				default: hq4x_32(src, expected, W, H); break;
+				}
+				for (int y = 0; y < H; y += BAND_ROWS)
+				{
+					BlitScaleRows(
+						actual, src, Vec2iNew(W, H), scale, SCALE_MODE_HQX,
+						y, MIN(y + BAND_ROWS, H));
+				}
+				equal = equal && memcmp(expected, actual, size) == 0;
+			}
+		WHEN_END
+
+		THEN("the result should be byte-identical to the original hqx");
+			SHOULD_BE_TRUE(equal);
+		THEN_END
+	}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(2, "Bilinear scaling")
+	SCENARIO("Scale by 2")
+	{
+		Uint32 src[4] = { 0x00000000, 0x02040608, 0xFFFFFFFF, 0x01030507 };
+		Uint32 dst[16];
+		GIVEN("a 2x2 image")
+		GIVEN_END
+
+		WHEN("I scale it by 2 with bilinear")
+			memset(dst, 0, sizeof dst);
+			BlitScaleRows(
+				dst, src, Vec2iNew(2, 2), 2, SCALE_MODE_BILINEAR, 0, 2);
+		WHEN_END
+
+		THEN("the in-between pixels should be per-channel averages");
+			SHOULD_INT_EQUAL(dst[0], 0x00000000);
+			SHOULD_INT_EQUAL(dst[1], 0x01020304);
+			SHOULD_INT_EQUAL(dst[4], 0x7F7F7F7F);
+			SHOULD_INT_EQUAL(dst[2], 0x02040608);
+			SHOULD_INT_EQUAL(dst[8], 0xFFFFFFFF);
+		THEN_END
+	}
+	SCENARIO_END
+FEATURE_END
+
+int main(void)
+{
+	cbehave_feature features[] =
+	{
+		{feature_idx(1)},
+		{feature_idx(2)}
+	};
+
+	return cbehave_runner("Blit scale features are:", features);
+}
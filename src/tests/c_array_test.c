@@ -126,13 +126,53 @@ FEATURE(3, "Array remove if")
 	SCENARIO_END
 FEATURE_END
 
+FEATURE(4, "Array index of")
+	SCENARIO("Index of elements")
+	{
+		CArray a;
+		CArray b;
+		int indices[5];
+		int otherIndices[5];
+		GIVEN("two arrays with numbers 0-4")
+			CArrayInit(&a, sizeof(int));
+			CArrayInit(&b, sizeof(int));
+			for (int i = 0; i < 5; i++)
+			{
+				CArrayPushBack(&a, &i);
+				CArrayPushBack(&b, &i);
+			}
+		GIVEN_END
+
+		WHEN("I get the indices of both arrays' elements in the first")
+			for (int i = 0; i < 5; i++)
+			{
+				indices[i] = CArrayIndexOf(&a, CArrayGet(&a, i));
+				otherIndices[i] = CArrayIndexOf(&a, CArrayGet(&b, i));
+			}
+		WHEN_END
+
+		THEN("only the first array's elements should have indices");
+			for (int i = 0; i < 5; i++)
+			{
+				SHOULD_INT_EQUAL(indices[i], i);
+				SHOULD_INT_EQUAL(otherIndices[i], -1);
+			}
+			SHOULD_INT_EQUAL(CArrayIndexOf(&a, NULL), -1);
+		THEN_END
+		CArrayTerminate(&a);
+		CArrayTerminate(&b);
+	}
+	SCENARIO_END
+FEATURE_END
+
 int main(void)
 {
 	cbehave_feature features[] =
 	{
 		{feature_idx(1)},
 		{feature_idx(2)},
-		{feature_idx(3)}
+		{feature_idx(3)},
+		{feature_idx(4)}
 	};
 	
 	return cbehave_runner("CArray features are:", features);
@@ -149,6 +149,37 @@ FEATURE(4, "Save config as latest format by default")
 	SCENARIO_END
 FEATURE_END
 
+FEATURE(5, "Config handles")
+	SCENARIO("Read values through a config handle")
+	{
+		ConfigHandle h = CONFIG_HANDLE("Graphics.Brightness");
+		int value1, value2;
+		GIVEN("a loaded config, with a handle to one of its values")
+			gConfig = ConfigLoad(NULL);
+			ConfigGet(&gConfig, "Graphics.Brightness")->u.Int.Value = 5;
+			value1 = ConfigHandleGetInt(&h);
+		GIVEN_END
+
+		WHEN("I change the value, then replace the config")
+			ConfigGet(&gConfig, "Graphics.Brightness")->u.Int.Value = 3;
+			value2 = ConfigHandleGetInt(&h);
+			ConfigDestroy(&gConfig);
+			gConfig = ConfigLoad(NULL);
+		WHEN_END
+
+		THEN("the handle should read the current value of the current config")
+			SHOULD_INT_EQUAL(value1, 5);
+			SHOULD_INT_EQUAL(value2, 3);
+			SHOULD_INT_EQUAL(
+				ConfigHandleGetInt(&h),
+				ConfigGetInt(&gConfig, "Graphics.Brightness"));
+			SHOULD_BE_TRUE(ConfigHandleGet(&h) ==
+				ConfigGet(&gConfig, "Graphics.Brightness"));
+		THEN_END
+	}
+	SCENARIO_END
+FEATURE_END
+
 int main(void)
 {
 	cbehave_feature features[] =
@@ -156,7 +187,8 @@ int main(void)
 		{feature_idx(1)},
 		{feature_idx(2)},
 		{feature_idx(3)},
-		{feature_idx(4)}
+		{feature_idx(4)},
+		{feature_idx(5)}
 	};
 
 	return cbehave_runner("Config features are:", features);
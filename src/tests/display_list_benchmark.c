@@ -0,0 +1,120 @@
+// Microbenchmark comparing sorting things to draw with a qsort per tile row
+// against one radix sort of the whole display list
+// Not run as part of the test suite; run manually:
+//   display_list_benchmark [iterations]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <display_list.h>
+
+
+// Rows in a 320x240 view
+#define ROWS 22
+#define MAX_ITEMS 2000
+static const int sCounts[] = { 100, 250, 500, 1000, 2000 };
+
+static TTileItem sItems[MAX_ITEMS];
+// Items per row, as they are found on the tiles
+static const TTileItem *sRows[ROWS][MAX_ITEMS];
+static int sRowCounts[ROWS];
+
+static void MakeCrowd(const int n)
+{
+	memset(sRowCounts, 0, sizeof sRowCounts);
+	for (int i = 0; i < n; i++)
+	{
+		sItems[i].x = rand() % 320;
+		sItems[i].y = rand() % (ROWS * TILE_HEIGHT);
+		const int row = sItems[i].y / TILE_HEIGHT;
+		sRows[row][sRowCounts[row]++] = &sItems[i];
+	}
+}
+
+static int CompareY(const void *v1, const void *v2)
+{
+	const TTileItem * const *t1 = v1;
+	const TTileItem * const *t2 = v2;
+	if ((*t1)->y < (*t2)->y)
+	{
+		return -1;
+	}
+	else if ((*t1)->y > (*t2)->y)
+	{
+		return 1;
+	}
+	return 0;
+}
+// Returns microseconds per frame
+static double RunQsort(const int iterations)
+{
+	CArray displaylist;
+	CArrayInit(&displaylist, sizeof(const TTileItem *));
+	int sum = 0;
+	const clock_t start = clock();
+	for (int i = 0; i < iterations; i++)
+	{
+		for (int y = 0; y < ROWS; y++)
+		{
+			CArrayClear(&displaylist);
+			for (int j = 0; j < sRowCounts[y]; j++)
+			{
+				CArrayPushBack(&displaylist, &sRows[y][j]);
+			}
+			qsort(
+				displaylist.data, displaylist.size, displaylist.elemSize,
+				CompareY);
+			if (displaylist.size > 0)
+			{
+				sum += (*(const TTileItem **)CArrayGet(&displaylist, 0))->x;
+			}
+		}
+	}
+	const double us = (double)(clock() - start) * 1000000.0 /
+		CLOCKS_PER_SEC / iterations;
+	CArrayTerminate(&displaylist);
+	return sum == -1 ? 0 : us;
+}
+static double RunRadix(const int iterations)
+{
+	DisplayList l;
+	DisplayListInit(&l);
+	int sum = 0;
+	const clock_t start = clock();
+	for (int i = 0; i < iterations; i++)
+	{
+		DisplayListClear(&l);
+		for (int y = 0; y < ROWS; y++)
+		{
+			for (int j = 0; j < sRowCounts[y]; j++)
+			{
+				const TTileItem *ti = sRows[y][j];
+				DisplayListAdd(
+					&l, ti,
+					0x80000000 | (Uint32)y << 16 |
+					(Uint32)(ti->y - y * TILE_HEIGHT + 0x8000));
+			}
+		}
+		DisplayListSort(&l);
+		sum += ((const DisplayListItem *)CArrayGet(&l.Items, 0))->Item->x;
+	}
+	const double us = (double)(clock() - start) * 1000000.0 /
+		CLOCKS_PER_SEC / iterations;
+	DisplayListTerminate(&l);
+	return sum == -1 ? 0 : us;
+}
+
+int main(int argc, char *argv[])
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+	srand(1);
+	printf("%-6s %14s %14s\n", "items", "qsort (us)", "radix (us)");
+	for (int i = 0; i < (int)(sizeof sCounts / sizeof sCounts[0]); i++)
+	{
+		MakeCrowd(sCounts[i]);
+		const double q = RunQsort(iterations);
+		const double r = RunRadix(iterations);
+		printf("%-6d %14.2f %14.2f\n", sCounts[i], q, r);
+	}
+	return 0;
+}
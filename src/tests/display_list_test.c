@@ -0,0 +1,106 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+
+#include <display_list.h>
+
+#include <SDL_joystick.h>
+
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+#define NUM_ITEMS 2000
+
+FEATURE(1, "Display list sorting")
+	SCENARIO("Sort by key")
+	{
+		DisplayList l;
+		static TTileItem items[NUM_ITEMS];
+		GIVEN("a display list with items with random keys")
+			DisplayListInit(&l);
+			srand(1);
+			for (int i = 0; i < NUM_ITEMS; i++)
+			{
+				DisplayListAdd(
+					&l, &items[i], (Uint32)rand() << 16 ^ (Uint32)rand());
+			}
+		GIVEN_END
+
+		WHEN("I sort it")
+			DisplayListSort(&l);
+		WHEN_END
+
+		THEN("the items should be in key order, and none should be lost");
+			bool isSorted = true;
+			static bool found[NUM_ITEMS];
+			for (int i = 0; i < (int)l.Items.size; i++)
+			{
+				const DisplayListItem *dli = CArrayGet(&l.Items, i);
+				found[dli->Item - items] = true;
+				if (i > 0)
+				{
+					const DisplayListItem *prev = CArrayGet(&l.Items, i - 1);
+					isSorted = isSorted && prev->Key <= dli->Key;
+				}
+			}
+			int numFound = 0;
+			for (int i = 0; i < NUM_ITEMS; i++)
+			{
+				numFound += found[i] ? 1 : 0;
+			}
+			SHOULD_BE_TRUE(isSorted);
+			SHOULD_INT_EQUAL(numFound, NUM_ITEMS);
+		THEN_END
+		DisplayListTerminate(&l);
+	}
+	SCENARIO_END
+
+	SCENARIO("Equal keys")
+	{
+		DisplayList l;
+		static TTileItem items[NUM_ITEMS];
+		GIVEN("a display list with few distinct keys")
+			DisplayListInit(&l);
+			for (int i = 0; i < NUM_ITEMS; i++)
+			{
+				DisplayListAdd(&l, &items[i], (Uint32)(i * 7919 % 5) << 24);
+			}
+		GIVEN_END
+
+		WHEN("I sort it")
+			DisplayListSort(&l);
+		WHEN_END
+
+		THEN("items with equal keys should keep the order they were added");
+			bool isStable = true;
+			for (int i = 1; i < (int)l.Items.size; i++)
+			{
+				const DisplayListItem *prev = CArrayGet(&l.Items, i - 1);
+				const DisplayListItem *dli = CArrayGet(&l.Items, i);
+				isStable = isStable &&
+					(prev->Key < dli->Key ||
+					(prev->Key == dli->Key && prev->Item < dli->Item));
+			}
+			SHOULD_BE_TRUE(isStable);
+		THEN_END
+		DisplayListTerminate(&l);
+	}
+	SCENARIO_END
+FEATURE_END
+
+int main(void)
+{
+	cbehave_feature features[] =
+	{
+		{feature_idx(1)}
+	};
+
+	return cbehave_runner("Display list features are:", features);
+}
@@ -0,0 +1,137 @@
+// Benchmark for entity store slot allocation and update loops
+// Spawns and retires bullets and particles at a steady rate, comparing
+// scanning for free slots and skipping them in update loops, against the
+// free list and dense iteration of EntityPool
+// Not run as part of the test suite; run manually:
+//   entity_benchmark [spawns per second] [seconds]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <entity_pool.h>
+#include <objs.h>
+#include <particle.h>
+
+
+#define FPS 70
+
+// Remaining ticks of life, so that the entity retires itself
+static int *GetLife(void *e, const size_t elemSize)
+{
+	return (int *)((char *)e + elemSize - sizeof(int));
+}
+
+// Same lifetime for each run so that the work is identical
+static int Lifetime(const int n)
+{
+	// Bullets and particles live for up to 2 seconds, most for much less
+	return 1 + (n * 7919) % (FPS / 4) + ((n % 8) == 0 ? (n % FPS) * 2 : 0);
+}
+
+static double RunScan(
+	const size_t elemSize, const int spawnsPerFrame, const int frames,
+	int *peak)
+{
+	CArray store;
+	CArrayInit(&store, elemSize);
+	void *e = calloc(1, elemSize);
+	int n = 0;
+	const clock_t start = clock();
+	for (int f = 0; f < frames; f++)
+	{
+		// Update, skipping free slots
+		for (int i = 0; i < (int)store.size; i++)
+		{
+			void *elem = CArrayGet(&store, i);
+			int *life = GetLife(elem, elemSize);
+			if (*life == 0) continue;
+			(*life)--;
+		}
+		// Spawn, scanning for a free slot
+		for (int s = 0; s < spawnsPerFrame; s++, n++)
+		{
+			int i;
+			for (i = 0; i < (int)store.size; i++)
+			{
+				if (*GetLife(CArrayGet(&store, i), elemSize) == 0) break;
+			}
+			if (i == (int)store.size)
+			{
+				CArrayPushBack(&store, e);
+			}
+			*GetLife(CArrayGet(&store, i), elemSize) = Lifetime(n);
+		}
+	}
+	const double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+	*peak = (int)store.size;
+	CArrayTerminate(&store);
+	free(e);
+	return elapsed;
+}
+
+static double RunPool(
+	const size_t elemSize, const int spawnsPerFrame, const int frames,
+	int *peak)
+{
+	CArray store;
+	CArrayInit(&store, elemSize);
+	EntityPool pool;
+	EntityPoolInit(&pool);
+	int n = 0;
+	const clock_t start = clock();
+	for (int f = 0; f < frames; f++)
+	{
+		// Update in-use slots only
+		for (int i = 0; i < (int)pool.Live.size; i++)
+		{
+			const int id = ((const int *)pool.Live.data)[i];
+			int *life = GetLife(CArrayGet(&store, id), elemSize);
+			(*life)--;
+			if (*life == 0)
+			{
+				EntityPoolRemove(&pool, id);
+				// Removal swaps the last live slot into this position
+				i--;
+			}
+		}
+		for (int s = 0; s < spawnsPerFrame; s++, n++)
+		{
+			const int id = EntityPoolAdd(&pool, &store);
+			*GetLife(CArrayGet(&store, id), elemSize) = Lifetime(n);
+		}
+	}
+	const double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+	*peak = (int)store.size;
+	EntityPoolTerminate(&pool);
+	CArrayTerminate(&store);
+	return elapsed;
+}
+
+static void Run(
+	const char *name, const size_t elemSize, const int spawnsPerSecond,
+	const int seconds)
+{
+	const int spawnsPerFrame = spawnsPerSecond / FPS;
+	const int frames = seconds * FPS;
+	int scanPeak, poolPeak;
+	const double scan = RunScan(elemSize, spawnsPerFrame, frames, &scanPeak);
+	const double pool = RunPool(elemSize, spawnsPerFrame, frames, &poolPeak);
+	printf(
+		"%-10s %10.3f %10.3f %10d %10d\n",
+		name, scan, pool, scanPeak, poolPeak);
+}
+
+int main(int argc, char *argv[])
+{
+	const int spawnsPerSecond = argc > 1 ? atoi(argv[1]) : 10000;
+	const int seconds = argc > 2 ? atoi(argv[2]) : 60;
+	printf(
+		"%d spawns per second for %d seconds at %d FPS\n",
+		spawnsPerSecond, seconds, FPS);
+	printf(
+		"%-10s %10s %10s %10s %10s\n",
+		"store", "scan (s)", "pool (s)", "scan size", "pool size");
+	Run("bullets", sizeof(TMobileObject), spawnsPerSecond, seconds);
+	Run("particles", sizeof(Particle), spawnsPerSecond, seconds);
+	return 0;
+}
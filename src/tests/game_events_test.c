@@ -0,0 +1,183 @@
+#include <cbehave/cbehave.h>
+
+#include <game_events.h>
+
+#include <SDL_joystick.h>
+
+#include <actors.h>
+#include <net_client.h>
+#include <net_server.h>
+#include <player.h>
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+NetServer gNetServer;
+NetClient gNetClient;
+void NetServerSendMsg(
+	NetServer *n, const int peerId, const GameEventType e, const void *data)
+{
+	UNUSED(n);
+	UNUSED(peerId);
+	UNUSED(e);
+	UNUSED(data);
+}
+void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data)
+{
+	UNUSED(n);
+	UNUSED(e);
+	UNUSED(data);
+}
+bool ActorIsLocalPlayer(const int uid)
+{
+	UNUSED(uid);
+	return false;
+}
+bool PlayerIsLocal(const int uid)
+{
+	UNUSED(uid);
+	return false;
+}
+
+
+#define MAX_HANDLED 2048
+
+typedef struct
+{
+	int Handled[MAX_HANDLED];
+	int NumHandled;
+	// Enqueue a follow-up event when handling this one
+	int Chain;
+} Handled;
+static void RecordEvent(const GameEvent *e, void *data)
+{
+	Handled *h = data;
+	h->Handled[h->NumHandled++] = e->u.ShakeAmount;
+	if (e->u.ShakeAmount == h->Chain)
+	{
+		GameEvent follow = GameEventNew(GAME_EVENT_SCREEN_SHAKE);
+		follow.u.ShakeAmount = -e->u.ShakeAmount;
+		GameEventsEnqueue(&gGameEvents, &follow);
+	}
+}
+static void EnqueueShake(const int amount, const int delay)
+{
+	GameEvent e = GameEventNew(GAME_EVENT_SCREEN_SHAKE);
+	e.Delay = delay;
+	e.u.ShakeAmount = amount;
+	GameEventsEnqueue(&gGameEvents, &e);
+}
+
+
+FEATURE(1, "Event order")
+	SCENARIO("Handle events in order")
+	{
+		Handled h;
+		memset(&h, 0, sizeof h);
+		h.Chain = -1;
+		GIVEN("many events of different sizes")
+			GameEventsInit(&gGameEvents);
+			for (int i = 0; i < 500; i++)
+			{
+				EnqueueShake(i, 0);
+				// Interleave large events
+				GameEvent e = GameEventNew(GAME_EVENT_TILE_SET);
+				GameEventsEnqueue(&gGameEvents, &e);
+			}
+		GIVEN_END
+
+		WHEN("I handle them")
+			GameEventsDispatch(&gGameEvents, RecordEvent, &h);
+		WHEN_END
+
+		THEN("they should be handled once each, in order");
+			bool inOrder = true;
+			for (int i = 0; i < 500; i++)
+			{
+				inOrder = inOrder && h.Handled[i * 2] == i;
+			}
+			SHOULD_INT_EQUAL(h.NumHandled, 1000);
+			SHOULD_BE_TRUE(inOrder);
+			GameEventsDispatch(&gGameEvents, RecordEvent, &h);
+			SHOULD_INT_EQUAL(h.NumHandled, 1000);
+		THEN_END
+		GameEventsTerminate(&gGameEvents);
+	}
+	SCENARIO_END
+
+	SCENARIO("Handle events enqueued by handlers")
+	{
+		Handled h;
+		memset(&h, 0, sizeof h);
+		h.Chain = 1;
+		GIVEN("an event whose handler enqueues another")
+			GameEventsInit(&gGameEvents);
+			EnqueueShake(1, 0);
+			EnqueueShake(2, 0);
+		GIVEN_END
+
+		WHEN("I handle them")
+			GameEventsDispatch(&gGameEvents, RecordEvent, &h);
+		WHEN_END
+
+		THEN("the new event should be handled last, in the same dispatch");
+			SHOULD_INT_EQUAL(h.NumHandled, 3);
+			SHOULD_INT_EQUAL(h.Handled[0], 1);
+			SHOULD_INT_EQUAL(h.Handled[1], 2);
+			SHOULD_INT_EQUAL(h.Handled[2], -1);
+		THEN_END
+		GameEventsTerminate(&gGameEvents);
+	}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(2, "Delayed events")
+	SCENARIO("Handle delayed events")
+	{
+		Handled h;
+		memset(&h, 0, sizeof h);
+		h.Chain = -1;
+		GIVEN("events with delays")
+			GameEventsInit(&gGameEvents);
+			EnqueueShake(3, 2);
+			EnqueueShake(2, 1);
+			EnqueueShake(1, 0);
+			EnqueueShake(4, 2);
+		GIVEN_END
+
+		WHEN("I handle events three times")
+		WHEN_END
+
+		THEN("each dispatch should handle the events that are due");
+			GameEventsDispatch(&gGameEvents, RecordEvent, &h);
+			SHOULD_INT_EQUAL(h.NumHandled, 1);
+			SHOULD_INT_EQUAL(h.Handled[0], 1);
+			EnqueueShake(5, 0);
+			GameEventsDispatch(&gGameEvents, RecordEvent, &h);
+			SHOULD_INT_EQUAL(h.NumHandled, 3);
+			SHOULD_INT_EQUAL(h.Handled[1], 2);
+			SHOULD_INT_EQUAL(h.Handled[2], 5);
+			GameEventsDispatch(&gGameEvents, RecordEvent, &h);
+			SHOULD_INT_EQUAL(h.NumHandled, 5);
+			SHOULD_INT_EQUAL(h.Handled[3], 3);
+			SHOULD_INT_EQUAL(h.Handled[4], 4);
+		THEN_END
+		GameEventsTerminate(&gGameEvents);
+	}
+	SCENARIO_END
+FEATURE_END
+
+int main(void)
+{
+	cbehave_feature features[] =
+	{
+		{feature_idx(1)},
+		{feature_idx(2)}
+	};
+
+	return cbehave_runner("Game events features are:", features);
+}
@@ -0,0 +1,75 @@
+// Microbenchmark comparing line of sight kernels across sight ranges
+// Not run as part of the test suite; run manually:
+//   los_benchmark [iterations]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <config.h>
+#include <game_events.h>
+#include <los.h>
+#include <map.h>
+
+
+#define MAP_SIZE 128
+
+static void MapInitRandom(Map *map)
+{
+	memset(map, 0, sizeof *map);
+	map->Size = Vec2iNew(MAP_SIZE, MAP_SIZE);
+	CArrayInit(&map->Tiles, sizeof(Tile));
+	for (int i = 0; i < map->Size.x * map->Size.y; i++)
+	{
+		Tile t;
+		TileInit(&t);
+		t.flags = (rand() % 8 == 0) ? MAPTILE_NO_SEE : 0;
+		CArrayPushBack(&map->Tiles, &t);
+	}
+	LOSInit(map, map->Size);
+}
+
+static double Run(
+	Map *map, const LOSKernel kernel, const int sightRange,
+	const int iterations)
+{
+	map->LOS.Kernel = kernel;
+	ConfigGet(&gConfig, "Game.SightRange")->u.Int.Value = sightRange;
+	const clock_t start = clock();
+	for (int i = 0; i < iterations; i++)
+	{
+		// Move every iteration so the per-viewer cache never hits
+		const Vec2i pos = Vec2iNew(
+			sightRange + i % (MAP_SIZE - 2 * sightRange),
+			sightRange + (i / 7) % (MAP_SIZE - 2 * sightRange));
+		LOSReset(&map->LOS);
+		LOSCalcFrom(map, pos, true);
+		GameEventsClear(&gGameEvents);
+	}
+	return (double)(clock() - start) * 1000000.0 / CLOCKS_PER_SEC /
+		iterations;
+}
+
+int main(int argc, char *argv[])
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+	gConfig = ConfigDefault();
+	GameEventsInit(&gGameEvents);
+	srand(1);
+	Map map;
+	MapInitRandom(&map);
+
+	printf("%-6s %14s %14s\n", "range", "rays (us)", "shadowcast (us)");
+	for (int sightRange = 4; sightRange <= 32; sightRange *= 2)
+	{
+		const double rays = Run(&map, LOS_KERNEL_RAYS, sightRange, iterations);
+		const double shadowcast =
+			Run(&map, LOS_KERNEL_SHADOWCAST, sightRange, iterations);
+		printf("%-6d %14.2f %14.2f\n", sightRange, rays, shadowcast);
+	}
+
+	LOSTerminate(&map.LOS);
+	CArrayTerminate(&map.Tiles);
+	GameEventsTerminate(&gGameEvents);
+	ConfigDestroy(&gConfig);
+	return 0;
+}
@@ -0,0 +1,153 @@
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+
+#include <name_map.h>
+
+#include <SDL_joystick.h>
+
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+typedef struct
+{
+	int Value;
+	char Name[32];
+} NamedThing;
+static void AddThing(CArray *things, const char *name, const int value)
+{
+	NamedThing t;
+	t.Value = value;
+	strcpy(t.Name, name);
+	CArrayPushBack(things, &t);
+}
+
+
+FEATURE(1, "Name lookup")
+	SCENARIO("Get names")
+	{
+		CArray things;
+		NameMap m;
+		GIVEN("a list with many names")
+			CArrayInit(&things, sizeof(NamedThing));
+			NAME_MAP_INIT(&m, &things, NamedThing, Name, false);
+			for (int i = 0; i < 1000; i++)
+			{
+				char buf[32];
+				sprintf(buf, "thing%d", i);
+				AddThing(&things, buf, i);
+			}
+		GIVEN_END
+
+		WHEN("I get the names")
+		WHEN_END
+
+		THEN("the map should have their indices, and none for other names");
+			for (int i = 0; i < 1000; i++)
+			{
+				char buf[32];
+				sprintf(buf, "thing%d", i);
+				SHOULD_INT_EQUAL(NameMapGet(&m, buf), i);
+				sprintf(buf, "other%d", i);
+				SHOULD_INT_EQUAL(NameMapGet(&m, buf), -1);
+			}
+			SHOULD_INT_EQUAL(NameMapGet(&m, NULL), -1);
+		THEN_END
+		NameMapTerminate(&m);
+		CArrayTerminate(&things);
+	}
+	SCENARIO_END
+	SCENARIO("Duplicate names")
+	{
+		CArray things;
+		NameMap m;
+		GIVEN("a list with a duplicate name")
+			CArrayInit(&things, sizeof(NamedThing));
+			NAME_MAP_INIT(&m, &things, NamedThing, Name, false);
+			AddThing(&things, "a", 0);
+			AddThing(&things, "b", 1);
+			AddThing(&things, "a", 2);
+		GIVEN_END
+
+		WHEN("I get the duplicate name")
+		WHEN_END
+
+		THEN("the map should have the first index");
+			SHOULD_INT_EQUAL(NameMapGet(&m, "a"), 0);
+		THEN_END
+		NameMapTerminate(&m);
+		CArrayTerminate(&things);
+	}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(2, "List changes")
+	SCENARIO("Append to the list")
+	{
+		CArray things;
+		NameMap m;
+		GIVEN("a list that has been looked up")
+			CArrayInit(&things, sizeof(NamedThing));
+			NAME_MAP_INIT(&m, &things, NamedThing, Name, false);
+			AddThing(&things, "a", 0);
+			NameMapGet(&m, "a");
+		GIVEN_END
+
+		WHEN("I append to the list")
+			AddThing(&things, "b", 1);
+		WHEN_END
+
+		THEN("the map should have the new name");
+			SHOULD_INT_EQUAL(NameMapGet(&m, "b"), 1);
+			SHOULD_INT_EQUAL(NameMapGet(&m, "a"), 0);
+		THEN_END
+		NameMapTerminate(&m);
+		CArrayTerminate(&things);
+	}
+	SCENARIO_END
+	SCENARIO("Clear and refill the list")
+	{
+		CArray things;
+		NameMap m;
+		GIVEN("a list that has been looked up")
+			CArrayInit(&things, sizeof(NamedThing));
+			NAME_MAP_INIT(&m, &things, NamedThing, Name, false);
+			AddThing(&things, "a", 0);
+			AddThing(&things, "b", 1);
+			NameMapGet(&m, "a");
+		GIVEN_END
+
+		WHEN("I clear and refill the list")
+			CArrayClear(&things);
+			NameMapClear(&m);
+			AddThing(&things, "c", 0);
+			AddThing(&things, "a", 1);
+		WHEN_END
+
+		THEN("the map should have the new names only");
+			SHOULD_INT_EQUAL(NameMapGet(&m, "a"), 1);
+			SHOULD_INT_EQUAL(NameMapGet(&m, "b"), -1);
+			SHOULD_INT_EQUAL(NameMapGet(&m, "c"), 0);
+		THEN_END
+		NameMapTerminate(&m);
+		CArrayTerminate(&things);
+	}
+	SCENARIO_END
+FEATURE_END
+
+int main(void)
+{
+	cbehave_feature features[] =
+	{
+		{feature_idx(1)},
+		{feature_idx(2)}
+	};
+
+	return cbehave_runner("NameMap features are:", features);
+}
@@ -0,0 +1,128 @@
+// Benchmark of pic manager loading: the stock graphics with and without
+// the pic cache, then a synthetic mod of many images added one at a time
+// versus in a batch
+// Not run as part of the test suite; run manually:
+//   pic_manager_benchmark [images]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <SDL.h>
+
+#include <config.h>
+#include <grafx.h>
+#include <pic_manager.h>
+#include <sys_config.h>
+#include <utils.h>
+
+
+#define MOD_PIC_SIZE 32
+#define CACHE_FILE "pic_manager_benchmark.cache"
+
+static double Seconds(const clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Add the synthetic mod to the custom pics, like a campaign archive,
+// with a sprinkling of door and drain pics for the derived indices
+static double LoadMod(PicManager *pm, const int count, const bool batch)
+{
+	PicManagerClearCustom(pm);
+	const clock_t start = clock();
+	if (batch)
+	{
+		PicManagerBeginBatch(pm);
+	}
+	for (int i = 0; i < count; i++)
+	{
+		SDL_Surface *image = SDL_CreateRGBSurface(
+			SDL_SWSURFACE, MOD_PIC_SIZE, MOD_PIC_SIZE, 32,
+			0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+		Uint32 *pixels = image->pixels;
+		for (int j = 0; j < MOD_PIC_SIZE * MOD_PIC_SIZE; j++)
+		{
+			pixels[j] = (Uint32)(i * 2654435761u + j);
+		}
+		char name[CDOGS_FILENAME_MAX];
+		if (i % 50 == 0)
+		{
+			sprintf(name, "door/mod%d_wall", i);
+		}
+		else if (i % 50 == 1)
+		{
+			sprintf(name, "drains/%d", i / 50);
+		}
+		else
+		{
+			sprintf(name, "mod/pic%d", i);
+		}
+		PicManagerAdd(&pm->customPics, &pm->customSprites, name, image);
+	}
+	if (batch)
+	{
+		PicManagerEndBatch(pm);
+	}
+	return Seconds(start);
+}
+
+int main(int argc, char *argv[])
+{
+	const int count = argc > 1 ? atoi(argv[1]) : 2000;
+	// The pics are converted to the screen format
+	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		printf("Failed to init SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+	gConfig = ConfigDefault();
+	ConfigResetDefault(ConfigGet(&gConfig, "Graphics"));
+	GraphicsInit(&gGraphicsDevice, &gConfig);
+	GraphicsInitialize(&gGraphicsDevice, false);
+	if (!gGraphicsDevice.IsInitialized)
+	{
+		printf("Failed to init graphics\n");
+		return 1;
+	}
+
+	// Load the stock graphics without the cache, then while building it,
+	// then from it
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, "graphics");
+	const char *cachePaths[] = { NULL, CACHE_FILE, CACHE_FILE };
+	const char *cacheNames[] = { "no cache", "building cache", "from cache" };
+	remove(CACHE_FILE);
+	for (int i = 0; i < 3; i++)
+	{
+		if (i > 0)
+		{
+			PicManagerTerminate(&gPicManager);
+		}
+		if (!PicManagerTryInit(
+			&gPicManager, "graphics/cdogs.px", "graphics/cdogs2.px"))
+		{
+			return 1;
+		}
+		const clock_t start = clock();
+		PicManagerLoadDir(&gPicManager, buf, cachePaths[i]);
+		printf("stock graphics, %s: %d pics, %d sprites in %.3fs\n",
+			cacheNames[i],
+			(int)gPicManager.pics.size, (int)gPicManager.sprites.size,
+			Seconds(start));
+	}
+	remove(CACHE_FILE);
+
+	const double single = LoadMod(&gPicManager, count, false);
+	printf("mod of %d pics, one at a time: %.3fs\n", count, single);
+	const double batch = LoadMod(&gPicManager, count, true);
+	printf("mod of %d pics, in a batch:    %.3fs\n", count, batch);
+	printf("(%d door styles, %d drains)\n",
+		(int)gPicManager.doorStyleNames.size,
+		(int)gPicManager.drainPics.size);
+
+	PicManagerTerminate(&gPicManager);
+	GraphicsTerminate(&gGraphicsDevice);
+	ConfigDestroy(&gConfig);
+	SDL_Quit();
+	return 0;
+}
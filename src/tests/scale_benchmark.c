@@ -0,0 +1,80 @@
+// Microbenchmark for the scaling stage, single-threaded and in bands
+// across threads
+// Not run as part of the test suite; run manually:
+//   scale_benchmark [frames] [threads]
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL_timer.h>
+
+#include <blit_scale.h>
+#include <hqx/hqx.h>
+#include <thread_pool.h>
+
+
+#define W 320
+#define H 240
+
+typedef struct
+{
+	Uint32 *dst;
+	Uint32 *src;
+	int scale;
+	ScaleMode mode;
+} ScaleJob;
+static void ScaleBand(void *data, const int begin, const int end)
+{
+	const ScaleJob *job = data;
+	BlitScaleRows(
+		job->dst, job->src, Vec2iNew(W, H), job->scale, job->mode,
+		begin, end);
+}
+
+// Returns milliseconds per frame; uses wall time since it is threaded
+static double Run(ThreadPool *pool, ScaleJob *job, const int frames)
+{
+	const Uint32 start = SDL_GetTicks();
+	for (int i = 0; i < frames; i++)
+	{
+		ThreadPoolRun(pool, ScaleBand, job, H);
+	}
+	return (double)(SDL_GetTicks() - start) / frames;
+}
+
+int main(int argc, char *argv[])
+{
+	const int frames = argc > 1 ? atoi(argv[1]) : 100;
+	const int threads = argc > 2 ? atoi(argv[2]) : ThreadPoolNumCPUs();
+	hqxInit();
+	ThreadPool single, multi;
+	ThreadPoolInit(&single, 1);
+	ThreadPoolInit(&multi, threads);
+	Uint32 *src = malloc(W * H * sizeof *src);
+	Uint32 *dst = malloc(W * H * 16 * sizeof *dst);
+	srand(1);
+	for (int i = 0; i < W * H; i++)
+	{
+		// Blocky image with edges, like game graphics
+		src[i] = ((i / 7 + i / W / 5) % 5) * 0x00302010 | 0xFF000000;
+	}
+
+	printf("%d threads\n", ThreadPoolNumThreads(&multi));
+	printf("%-18s %6s %12s %12s\n", "mode", "scale", "1 thread (ms)", "threaded (ms)");
+	for (ScaleMode mode = SCALE_MODE_NN; mode <= SCALE_MODE_HQX; mode++)
+	{
+		for (int scale = 2; scale <= 4; scale++)
+		{
+			ScaleJob job = { dst, src, scale, mode };
+			const double t1 = Run(&single, &job, frames);
+			const double tn = Run(&multi, &job, frames);
+			printf("%-18s %6d %12.2f %12.2f\n",
+				ScaleModeStr(mode), scale, t1, tn);
+		}
+	}
+
+	free(src);
+	free(dst);
+	ThreadPoolTerminate(&single);
+	ThreadPoolTerminate(&multi);
+	return 0;
+}
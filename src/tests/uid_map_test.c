@@ -0,0 +1,103 @@
+#include <cbehave/cbehave.h>
+
+#include <uid_map.h>
+
+#include <SDL_joystick.h>
+
+#include <utils.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+FEATURE(1, "UID lookup")
+	SCENARIO("Get set UIDs")
+	{
+		UIDMap m;
+		GIVEN("a map with many UIDs")
+			UIDMapInit(&m);
+			for (int i = 0; i < 1000; i++)
+			{
+				UIDMapSet(&m, i * 7, i);
+			}
+		GIVEN_END
+
+		WHEN("I get the UIDs")
+		WHEN_END
+
+		THEN("the map should have their indices, and none for other UIDs");
+			for (int i = 0; i < 1000; i++)
+			{
+				SHOULD_INT_EQUAL(UIDMapGet(&m, i * 7), i);
+				SHOULD_INT_EQUAL(UIDMapGet(&m, i * 7 + 1), -1);
+			}
+			SHOULD_INT_EQUAL(UIDMapGet(&m, -1), -1);
+		THEN_END
+		UIDMapTerminate(&m);
+	}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(2, "UID remove")
+	SCENARIO("Remove UIDs")
+	{
+		UIDMap m;
+		GIVEN("a map with colliding UIDs")
+			UIDMapInit(&m);
+			for (int i = 0; i < 100; i++)
+			{
+				UIDMapSet(&m, i * 1024, i);
+			}
+		GIVEN_END
+
+		WHEN("I remove every other UID")
+			for (int i = 0; i < 100; i += 2)
+			{
+				UIDMapRemove(&m, i * 1024, i);
+			}
+		WHEN_END
+
+		THEN("only the remaining UIDs should be found");
+			for (int i = 0; i < 100; i++)
+			{
+				SHOULD_INT_EQUAL(UIDMapGet(&m, i * 1024), i % 2 ? i : -1);
+			}
+		THEN_END
+		UIDMapTerminate(&m);
+	}
+	SCENARIO_END
+	SCENARIO("Remove UID of a reused index")
+	{
+		UIDMap m;
+		GIVEN("a UID that has been moved to another index")
+			UIDMapInit(&m);
+			UIDMapSet(&m, 5, 1);
+			UIDMapSet(&m, 5, 2);
+		GIVEN_END
+
+		WHEN("I remove the UID from the old index")
+			UIDMapRemove(&m, 5, 1);
+		WHEN_END
+
+		THEN("the UID should still map to the new index");
+			SHOULD_INT_EQUAL(UIDMapGet(&m, 5), 2);
+		THEN_END
+		UIDMapTerminate(&m);
+	}
+	SCENARIO_END
+FEATURE_END
+
+int main(void)
+{
+	cbehave_feature features[] =
+	{
+		{feature_idx(1)},
+		{feature_idx(2)}
+	};
+
+	return cbehave_runner("UIDMap features are:", features);
+}